@@ -0,0 +1,207 @@
+#include <EventMonitor/AttributeWatcher.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+namespace {
+    // Reading from the start re-arms the sysfs notification of the descriptor.
+    std::optional<std::string> ReadAttribute(int fd) {
+        char buffer[SysattrReader::maxValueSize];
+        ssize_t size = 0;
+        do {
+            size = pread(fd, buffer, sizeof(buffer), 0);
+        } while (size < 0 && errno == EINTR);
+        if (size < 0) {
+            return std::nullopt;
+        }
+        // Same value as SysattrReader, without the trailing newline.
+        while (size > 0 && (buffer[size - 1] == '\n' || buffer[size - 1] == '\r')) {
+            --size;
+        }
+        return std::string(buffer, static_cast<std::size_t>(size));
+    }
+}
+
+// *** Public ***
+
+AttributeWatcher::AttributeWatcher(std::shared_ptr<Event> event, std::chrono::microseconds minInterval, std::chrono::microseconds maxInterval)
+    : eventLoop(std::move(event)),
+      minPollInterval(minInterval),
+      maxPollInterval(maxInterval),
+      pollInterval(minInterval),
+      nextId(1) {
+    if (!eventLoop) {
+        throw std::invalid_argument("Failed to create AttributeWatcher : Event cannot be null!");
+    }
+    if (minPollInterval.count() <= 0 || maxPollInterval < minPollInterval) {
+        throw std::invalid_argument("Failed to create AttributeWatcher : Poll intervals must be positive and ordered!");
+    }
+    pollTimer = std::make_unique<EventTimer>(eventLoop, [this]() { OnPollTimer(); });
+}
+
+AttributeWatcher::~AttributeWatcher() = default;
+
+void AttributeWatcher::SetCallback(Callback callback) {
+    userCallback = std::move(callback);
+}
+
+AttributeWatcher::WatchId AttributeWatcher::Watch(const Device& device, const std::string& sysattr, Mode mode) {
+    const auto syspath = device.GetSyspathView();
+    if (!syspath) {
+        throw std::invalid_argument("Failed to watch attribute : Device has no syspath!");
+    }
+    return Watch(std::string(*syspath), sysattr, mode);
+}
+
+AttributeWatcher::WatchId AttributeWatcher::Watch(const std::string& syspath, const std::string& sysattr, Mode mode) {
+    if (sysattr.empty()) {
+        throw std::invalid_argument("Failed to watch attribute : Attribute cannot be empty!");
+    }
+
+    auto watched = std::make_unique<Watched>();
+    watched->watcher = this;
+    watched->id = nextId;
+    watched->syspath = syspath;
+    watched->sysattr = sysattr;
+    watched->mode = mode;
+
+    const std::string path = syspath + "/" + sysattr;
+    watched->fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (watched->fd < 0) {
+        throw std::runtime_error("Failed to watch attribute : Cannot open " + path + " : " + std::strerror(errno) + "!");
+    }
+    // Read before watching, sysfs only notifies descriptors that have been read.
+    watched->value = ReadAttribute(watched->fd);
+    if (!watched->value) {
+        throw std::runtime_error("Failed to watch attribute : Cannot read " + path + " : " + std::strerror(errno) + "!");
+    }
+
+    if (mode != Mode::Poll) {
+        sd_event_source* sourceTemp = nullptr;
+        const int result = sd_event_add_io(eventLoop->GetEvent(), &sourceTemp, watched->fd, EPOLLPRI, &AttributeWatcher::OnNotified, watched.get());
+        if (result >= 0 && sourceTemp) {
+            watched->source.reset(sourceTemp);
+        }
+        else if (result != -EPERM) {
+            throw std::runtime_error("Failed to watch attribute : sd_event_add_io failed!");
+        }
+        // EPERM : not a pollable file, e.g. outside of sysfs.
+    }
+    if (!watched->source) {
+        close(watched->fd);
+        watched->fd = -1;
+    }
+    if (mode == Mode::Auto || !watched->source) {
+        StartPolling(*watched);
+    }
+
+    watches.emplace(nextId, std::move(watched));
+    return nextId++;
+}
+
+bool AttributeWatcher::Unwatch(WatchId id) {
+    return watches.erase(id) > 0;
+}
+
+std::optional<std::string> AttributeWatcher::GetValue(WatchId id) const {
+    const auto it = watches.find(id);
+    return (it != watches.end()) ? it->second->value : std::nullopt;
+}
+
+std::size_t AttributeWatcher::GetPolledCount() const {
+    return static_cast<std::size_t>(std::count_if(watches.begin(), watches.end(), [](const auto& entry) {
+        return entry.second->polled;
+    }));
+}
+
+// *** Private ***
+
+AttributeWatcher::Watched::~Watched() {
+    source.reset();
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+int AttributeWatcher::OnNotified(sd_event_source* source, int fd, uint32_t revents, void* userdata) {
+    (void) source; // Unused.
+    (void) revents; // Unused.
+
+    auto* watched = static_cast<Watched*>(userdata);
+    if (!watched) {
+        return -1;
+    }
+    AttributeWatcher* self = watched->watcher;
+
+    auto value = ReadAttribute(fd);
+    if (!value) {
+        // The attribute is gone, e.g. with its device. Polling reports it if it comes back.
+        watched->source.reset();
+        close(watched->fd);
+        watched->fd = -1;
+        if (!watched->polled) {
+            self->StartPolling(*watched);
+        }
+    }
+    else if (watched->mode == Mode::Auto && watched->polled && value != watched->value) {
+        // The notification delivered the change before polling did, the driver notifies.
+        watched->polled = false;
+    }
+    // Last, the callback may unwatch the attribute.
+    self->Update(*watched, std::move(value));
+    return 0;
+}
+
+void AttributeWatcher::OnPollTimer() {
+    // Ids rather than pointers, callbacks may unwatch while the results are applied.
+    std::vector<WatchId> ids;
+    for (const auto& [id, watched] : watches) {
+        if (watched->polled) {
+            ids.push_back(id);
+            reader->Add(watched->syspath, watched->sysattr);
+        }
+    }
+    if (ids.empty()) {
+        return;
+    }
+
+    auto values = reader->Read();
+    bool changed = false;
+    for (std::size_t i = 0; i < ids.size(); ++i) {
+        const auto it = watches.find(ids[i]);
+        if (it != watches.end() && it->second->polled) {
+            changed |= Update(*it->second, std::move(values[i]));
+        }
+    }
+
+    pollInterval = changed ? minPollInterval : std::min(pollInterval * 2, maxPollInterval);
+    if (GetPolledCount() > 0) {
+        pollTimer->Arm(pollInterval);
+    }
+}
+
+void AttributeWatcher::StartPolling(Watched& watched) {
+    if (!reader) {
+        // A single worker if io_uring is unavailable, polled attributes are cheap to read.
+        reader = std::make_unique<SysattrReader>(SysattrReader::Backend::IoUring, 256, 1);
+    }
+    watched.polled = true;
+    pollInterval = minPollInterval;
+    pollTimer->Arm(pollInterval);
+}
+
+bool AttributeWatcher::Update(Watched& watched, std::optional<std::string> value) {
+    if (value == watched.value) {
+        return false;
+    }
+    AttributeChange change{ watched.id, watched.syspath, watched.sysattr, value, std::move(watched.value) };
+    watched.value = std::move(value);
+    if (userCallback) {
+        userCallback(*this, change);
+    }
+    return true;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/Event.h>
+#include <EventMonitor/EventTimer.h>
+#include <EventMonitor/SysattrReader.h>
+
+extern "C" {
+    #include <systemd/sd-event.h>
+}
+
+// New value of a watched attribute, none once it cannot be read anymore (e.g. the device is gone).
+struct AttributeChange {
+    uint64_t id;
+    std::string syspath;
+    std::string sysattr;
+    std::optional<std::string> value;
+    std::optional<std::string> previousValue;
+};
+
+// Watches sysfs attributes changing without uevent (battery capacity, link speed, thermal zones...).
+//
+// Attributes whose driver calls sysfs_notify() are watched with an EPOLLPRI I/O source on the Event, the others
+// are polled : a single timer reads every polled attribute in one SysattrReader batch, at an interval doubling
+// after every round without change, from the minimum up to the maximum, and back to the minimum on a change.
+// Whether a driver notifies cannot be told from userspace, Mode::Auto does both until a notification delivers a
+// change first, then only relies on notifications.
+// Not thread-safe, use it from the thread running the Event loop.
+class AttributeWatcher {
+public:
+    using WatchId = uint64_t;
+    using Callback = std::function<void(const AttributeWatcher&, const AttributeChange&)>;
+
+    enum class Mode {
+        // Notified and polled, polling stops once a notification proves to work.
+        Auto,
+        // Only notified, polled if the file cannot be polled (e.g. not a sysfs file).
+        Notify,
+        // Only polled.
+        Poll
+    };
+
+    explicit AttributeWatcher(std::shared_ptr<Event> eventLoop,
+                              std::chrono::microseconds minPollInterval = std::chrono::milliseconds(100),
+                              std::chrono::microseconds maxPollInterval = std::chrono::seconds(5));
+    ~AttributeWatcher();
+    // Sources keep a pointer to this instance, so it can be neither copied nor moved.
+    AttributeWatcher(const AttributeWatcher&) = delete;
+    AttributeWatcher(AttributeWatcher&&) = delete;
+    AttributeWatcher& operator=(const AttributeWatcher&) = delete;
+    AttributeWatcher& operator=(AttributeWatcher&&) = delete;
+
+    // Called once per change, the first value read by Watch() is not a change.
+    void SetCallback(Callback callback);
+
+    // Start watching the attribute, e.g. Watch(battery, "capacity"). Throws if it cannot be read.
+    WatchId Watch(const Device& device, const std::string& sysattr, Mode mode = Mode::Auto);
+    WatchId Watch(const std::string& syspath, const std::string& sysattr, Mode mode = Mode::Auto);
+    // Returns false for an unknown id. Callbacks may unwatch any attribute, including their own.
+    bool Unwatch(WatchId id);
+
+    // Last value read, none for an unknown id or an attribute that cannot be read anymore.
+    std::optional<std::string> GetValue(WatchId id) const;
+    std::size_t GetWatchCount() const { return watches.size(); }
+    // Attributes currently read by the poll timer.
+    std::size_t GetPolledCount() const;
+    std::chrono::microseconds GetPollInterval() const { return pollInterval; }
+
+private:
+    struct Watched {
+        AttributeWatcher* watcher;
+        WatchId id;
+        std::string syspath;
+        std::string sysattr;
+        Mode mode;
+        std::optional<std::string> value;
+        int fd = -1;
+        std::unique_ptr<sd_event_source, decltype(&sd_event_source_unref)> source{ nullptr, &sd_event_source_unref };
+        bool polled = false;
+
+        // The source goes before the descriptor it watches.
+        ~Watched();
+    };
+
+    static int OnNotified(sd_event_source* source, int fd, uint32_t revents, void* userdata);
+    void OnPollTimer();
+    // Add the watch to the polled ones, arming the timer at the minimum interval.
+    void StartPolling(Watched& watched);
+    // Store the new value and call the callback if it changed, returns whether it did.
+    bool Update(Watched& watched, std::optional<std::string> value);
+
+    std::shared_ptr<Event> eventLoop;
+    Callback userCallback;
+    std::chrono::microseconds minPollInterval;
+    std::chrono::microseconds maxPollInterval;
+    std::chrono::microseconds pollInterval;
+
+    // Pointers are handed to the sources, so watches must not move.
+    std::unordered_map<WatchId, std::unique_ptr<Watched>> watches;
+    WatchId nextId;
+    std::unique_ptr<EventTimer> pollTimer;
+    std::unique_ptr<SysattrReader> reader;
+};
@@ -2,6 +2,16 @@
 #include <stdexcept>
 #include <functional>
 #include <cassert>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <sys/sysmacros.h>
+#include <vector>
+
+namespace {
+    // Indexed by sd_device_action_t.
+    constexpr const char* actionNames[] = { "add", "remove", "change", "move", "online", "offline", "bind", "unbind" };
+}
 
 // *** Public ***
 
@@ -77,6 +87,57 @@ Device Device::CreateFromIfindex(int ifindex) {
     return Device(dev);
 }
 
+Device Device::CreateFromProperties(DeviceProperties deviceProperties) {
+    Device dev(std::make_unique<const DeviceProperties>(std::move(deviceProperties)));
+    const DeviceProperties& props = *dev.properties;
+
+    const auto toString = [](std::optional<std::string_view> value) {
+        return value ? std::make_optional<std::string>(*value) : std::nullopt;
+    };
+
+    if (const auto devname = props.Find("DEVNAME")) {
+        // The kernel sends it relative to /dev.
+        dev.devname = (devname->empty() || devname->front() == '/') ? std::string(*devname) : "/dev/" + std::string(*devname);
+    }
+    dev.devpath = toString(props.Find("DEVPATH"));
+    dev.path = dev.devpath;
+    dev.devtype = toString(props.Find("DEVTYPE"));
+    dev.type = dev.devtype;
+    dev.driver = toString(props.Find("DRIVER"));
+    dev.subsystem = toString(props.Find("SUBSYSTEM"));
+    dev.productID = toString(props.Find("ID_MODEL_ID"));
+    dev.serial = toString(props.Find("ID_SERIAL"));
+    dev.vendorID = toString(props.Find("ID_VENDOR_ID"));
+
+    if (dev.devpath) {
+        dev.syspath = "/sys" + *dev.devpath;
+
+        // The sysname is the last component of the devpath, with '!' standing for '/'.
+        std::string sysname = dev.devpath->substr(dev.devpath->rfind('/') + 1);
+        for (char& c : sysname) {
+            c = (c == '!') ? '/' : c;
+        }
+        // The sysnum is its trailing digits, if it does not only consist of them.
+        std::size_t digits = sysname.size();
+        while (digits > 0 && std::isdigit(static_cast<unsigned char>(sysname[digits - 1]))) {
+            --digits;
+        }
+        if (digits > 0 && digits < sysname.size()) {
+            dev.sysnum = sysname.substr(digits);
+        }
+        dev.name = sysname;
+        dev.sysname = std::move(sysname);
+    }
+
+    const auto major = props.Find("MAJOR");
+    const auto minor = props.Find("MINOR");
+    if (major && minor) {
+        dev.devnum = makedev(std::strtoul(std::string(*major).c_str(), nullptr, 10), std::strtoul(std::string(*minor).c_str(), nullptr, 10));
+    }
+
+    return dev;
+}
+
 const std::optional<std::string>& Device::GetDevname(const bool refreshCache) const {
     return GetCachedValueOrFetch(devname, 
     [this]() { 
@@ -86,6 +147,15 @@ const std::optional<std::string>& Device::GetDevname(const bool refreshCache) co
     refreshCache);
 }
 
+std::optional<dev_t> Device::GetDevnum(const bool refreshCache) const {
+    return GetCachedValueOrFetch(devnum, 
+    [this]() { 
+        dev_t val = 0;
+        return (sd_device_get_devnum(device.get(), &val) >= 0) ? std::make_optional(val) : std::nullopt;
+    },
+    refreshCache);
+}
+
 const std::optional<std::string>& Device::GetDevpath(const bool refreshCache) const {
     return GetCachedValueOrFetch(devpath, 
     [this]() { 
@@ -204,18 +274,305 @@ const std::optional<std::string>& Device::GetVendorID(const bool refreshCache) c
     refreshCache);
 }
 
+const std::optional<std::string>& Device::GetField(DeviceField field, const bool refreshCache) const {
+    switch (field) {
+        case DeviceField::Devname: return GetDevname(refreshCache);
+        case DeviceField::Devpath: return GetDevpath(refreshCache);
+        case DeviceField::Devtype: return GetDevtype(refreshCache);
+        case DeviceField::Driver: return GetDriver(refreshCache);
+        case DeviceField::Name: return GetName(refreshCache);
+        case DeviceField::Path: return GetPath(refreshCache);
+        case DeviceField::ProductID: return GetProductID(refreshCache);
+        case DeviceField::Serial: return GetSerial(refreshCache);
+        case DeviceField::Subsystem: return GetSubsystem(refreshCache);
+        case DeviceField::Sysname: return GetSysname(refreshCache);
+        case DeviceField::Sysnum: return GetSysnum(refreshCache);
+        case DeviceField::Syspath: return GetSyspath(refreshCache);
+        case DeviceField::Type: return GetType(refreshCache);
+        case DeviceField::VendorID: return GetVendorID(refreshCache);
+        default: throw std::invalid_argument("Failed to get device field : Invalid field!");
+    }
+}
+
+std::optional<std::string_view> Device::GetDevnameView() const {
+    return GetView(sd_device_get_devname, devname);
+}
+
+std::optional<std::string_view> Device::GetDevpathView() const {
+    return GetView(sd_device_get_devpath, devpath);
+}
+
+std::optional<std::string_view> Device::GetDevtypeView() const {
+    return GetView(sd_device_get_devtype, devtype);
+}
+
+std::optional<std::string_view> Device::GetDriverView() const {
+    return GetView(sd_device_get_driver, driver);
+}
+
+std::optional<std::string_view> Device::GetNameView() const {
+    return GetView(sd_device_get_sysname, name);
+}
+
+std::optional<std::string_view> Device::GetPathView() const {
+    return GetView(sd_device_get_devpath, path);
+}
+
+std::optional<std::string_view> Device::GetProductIDView() const {
+    return GetPropertyValueView("ID_MODEL_ID", productID);
+}
+
+std::optional<std::string_view> Device::GetSerialView() const {
+    return GetPropertyValueView("ID_SERIAL", serial);
+}
+
+std::optional<std::string_view> Device::GetSubsystemView() const {
+    return GetView(sd_device_get_subsystem, subsystem);
+}
+
+std::optional<std::string_view> Device::GetSysnameView() const {
+    return GetView(sd_device_get_sysname, sysname);
+}
+
+std::optional<std::string_view> Device::GetSysnumView() const {
+    return GetView(sd_device_get_sysnum, sysnum);
+}
+
+std::optional<std::string_view> Device::GetSyspathView() const {
+    return GetView(sd_device_get_syspath, syspath);
+}
+
+std::optional<std::string_view> Device::GetTypeView() const {
+    return GetView(sd_device_get_devtype, type);
+}
+
+std::optional<std::string_view> Device::GetVendorIDView() const {
+    return GetPropertyValueView("ID_VENDOR_ID", vendorID);
+}
+
+std::optional<std::string_view> Device::GetFieldView(DeviceField field) const {
+    switch (field) {
+        case DeviceField::Devname: return GetDevnameView();
+        case DeviceField::Devpath: return GetDevpathView();
+        case DeviceField::Devtype: return GetDevtypeView();
+        case DeviceField::Driver: return GetDriverView();
+        case DeviceField::Name: return GetNameView();
+        case DeviceField::Path: return GetPathView();
+        case DeviceField::ProductID: return GetProductIDView();
+        case DeviceField::Serial: return GetSerialView();
+        case DeviceField::Subsystem: return GetSubsystemView();
+        case DeviceField::Sysname: return GetSysnameView();
+        case DeviceField::Sysnum: return GetSysnumView();
+        case DeviceField::Syspath: return GetSyspathView();
+        case DeviceField::Type: return GetTypeView();
+        case DeviceField::VendorID: return GetVendorIDView();
+        default: throw std::invalid_argument("Failed to get device field : Invalid field!");
+    }
+}
+
+void Device::Prefetch(DeviceFieldMask fields, const bool refreshCache) const {
+    if (!device) {
+        return;
+    }
+
+    const auto wanted = [fields, refreshCache](DeviceField field, const std::optional<std::string>& cache) {
+        return (fields & DeviceFieldBit(field)) && (refreshCache || !cache);
+    };
+    // Fetch the value once and store it in every cache that asked for it.
+    const auto fetch = [this](int (*getter)(sd_device*, const char**), std::optional<std::string>* first, std::optional<std::string>* second) {
+        const char* val = nullptr;
+        const bool found = getter(device.get(), &val) >= 0;
+        for (auto* cache : { first, second }) {
+            if (cache) {
+                *cache = found ? std::make_optional<std::string>(val) : std::nullopt;
+            }
+        }
+    };
+    const auto fetchPair = [&](int (*getter)(sd_device*, const char**), DeviceField firstField, std::optional<std::string>& firstCache, DeviceField secondField, std::optional<std::string>& secondCache) {
+        const bool first = wanted(firstField, firstCache);
+        const bool second = wanted(secondField, secondCache);
+        if (first || second) {
+            fetch(getter, first ? &firstCache : nullptr, second ? &secondCache : nullptr);
+        }
+    };
+    const auto fetchOne = [&](int (*getter)(sd_device*, const char**), DeviceField field, std::optional<std::string>& cache) {
+        if (wanted(field, cache)) {
+            fetch(getter, &cache, nullptr);
+        }
+    };
+
+    fetchOne(sd_device_get_devname, DeviceField::Devname, devname);
+    fetchPair(sd_device_get_devpath, DeviceField::Devpath, devpath, DeviceField::Path, path);
+    fetchPair(sd_device_get_devtype, DeviceField::Devtype, devtype, DeviceField::Type, type);
+    fetchOne(sd_device_get_driver, DeviceField::Driver, driver);
+    fetchPair(sd_device_get_sysname, DeviceField::Sysname, sysname, DeviceField::Name, name);
+    fetchOne(sd_device_get_subsystem, DeviceField::Subsystem, subsystem);
+    fetchOne(sd_device_get_sysnum, DeviceField::Sysnum, sysnum);
+    fetchOne(sd_device_get_syspath, DeviceField::Syspath, syspath);
+
+    struct PropertyField {
+        const char* key;
+        std::optional<std::string>* cache;
+    };
+    PropertyField propertyFields[3];
+    std::size_t propertyCount = 0;
+    if (wanted(DeviceField::ProductID, productID)) {
+        propertyFields[propertyCount++] = { "ID_MODEL_ID", &productID };
+    }
+    if (wanted(DeviceField::Serial, serial)) {
+        propertyFields[propertyCount++] = { "ID_SERIAL", &serial };
+    }
+    if (wanted(DeviceField::VendorID, vendorID)) {
+        propertyFields[propertyCount++] = { "ID_VENDOR_ID", &vendorID };
+    }
+    if (propertyCount == 0) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < propertyCount; ++i) {
+        propertyFields[i].cache->reset();
+    }
+    std::size_t remaining = propertyCount;
+    const char* val = nullptr;
+    for (const char* key = sd_device_get_property_first(device.get(), &val); key && remaining > 0; key = sd_device_get_property_next(device.get(), &val)) {
+        for (std::size_t i = 0; i < propertyCount; ++i) {
+            if (!propertyFields[i].cache->has_value() && std::strcmp(key, propertyFields[i].key) == 0) {
+                propertyFields[i].cache->emplace(val);
+                --remaining;
+                break;
+            }
+        }
+    }
+}
+
+DeviceProperties Device::GetAllProperties() const {
+    if (properties && !netAction) {
+        return *properties;
+    }
+
+    // Through ForEachProperty() for the net action of a coalesced device.
+    std::vector<DeviceProperties::Property> all;
+    ForEachProperty([&all](std::string_view key, std::string_view value) { all.emplace_back(key, value); });
+    return DeviceProperties(std::move(all));
+}
+
 const std::optional<sd_device_action_t> Device::GetAction() const {
+    if (netAction) {
+        return netAction;
+    }
+    if (properties) {
+        const auto value = properties->Find("ACTION");
+        for (std::size_t i = 0; value && i < sizeof(actionNames) / sizeof(actionNames[0]); ++i) {
+            if (*value == actionNames[i]) {
+                return static_cast<sd_device_action_t>(i);
+            }
+        }
+        return std::nullopt;
+    }
+
     sd_device_action_t action;
     return (sd_device_get_action(device.get(), &action) >= 0) ? std::make_optional(action) : std::nullopt;
 }
 
-const std::optional<std::string> Device::GetPropertyFromKey(std::string key) const {
+std::optional<uint64_t> Device::GetSeqnum() const {
+    if (properties) {
+        const auto value = properties->Find("SEQNUM");
+        return value ? std::make_optional<uint64_t>(std::strtoull(std::string(*value).c_str(), nullptr, 10)) : std::nullopt;
+    }
+
+    uint64_t seqnum = 0;
+    return (sd_device_get_seqnum(device.get(), &seqnum) >= 0) ? std::make_optional(seqnum) : std::nullopt;
+}
+
+std::optional<uint64_t> Device::GetUsecInitialized() const {
+    if (properties) {
+        const auto value = properties->Find("USEC_INITIALIZED");
+        return value ? std::make_optional<uint64_t>(std::strtoull(std::string(*value).c_str(), nullptr, 10)) : std::nullopt;
+    }
+
+    uint64_t usec = 0;
+    return (sd_device_get_usec_initialized(device.get(), &usec) >= 0) ? std::make_optional(usec) : std::nullopt;
+}
+
+const std::optional<std::string> Device::GetPropertyFromKey(const std::string& key) const {
+    if (netAction && key == "ACTION") {
+        return std::string(*GetNetActionView());
+    }
+    if (properties) {
+        const auto value = properties->Find(key);
+        return value ? std::make_optional<std::string>(*value) : std::nullopt;
+    }
+
     const char* val = nullptr;
     return (sd_device_get_property_value(device.get(), key.c_str(), &val) >= 0) ? std::make_optional(val) : std::nullopt;
 }
 
+std::vector<std::string> Device::GetTags() const {
+    std::vector<std::string> tags;
+    if (properties) {
+        // Colon-separated list, e.g. ":seat:uaccess:".
+        const std::string_view list = properties->Find("TAGS").value_or(std::string_view());
+        for (std::size_t start = 0; start < list.size();) {
+            std::size_t end = list.find(':', start);
+            end = (end == std::string_view::npos) ? list.size() : end;
+            if (end > start) {
+                tags.emplace_back(list.substr(start, end - start));
+            }
+            start = end + 1;
+        }
+        return tags;
+    }
+
+    for (const char* tag = sd_device_get_tag_first(device.get()); tag; tag = sd_device_get_tag_next(device.get())) {
+        tags.emplace_back(tag);
+    }
+    return tags;
+}
+
+std::optional<std::string> Device::GetSysattrValue(const std::string& sysattr) const {
+    if (!device) {
+        return std::nullopt;
+    }
+    const char* value = nullptr;
+    if (sd_device_get_sysattr_value(device.get(), sysattr.c_str(), &value) < 0 || !value) {
+        return std::nullopt;
+    }
+    return std::string(value);
+}
+
+std::optional<Device> Device::GetParent() const {
+    if (!device) {
+        return std::nullopt;
+    }
+    sd_device* parent = nullptr;
+    if (sd_device_get_parent(device.get(), &parent) < 0 || !parent) {
+        return std::nullopt;
+    }
+    sd_device_ref(parent); // The parent belongs to the child otherwise.
+    return Device(parent);
+}
+
+std::optional<std::string_view> Device::GetPropertyView(std::string_view key) const {
+    if (netAction && key == "ACTION") {
+        return GetNetActionView();
+    }
+    if (properties) {
+        return properties->Find(key);
+    }
+
+    // libsystemd wants a NUL-terminated key, copy it on the stack when it fits.
+    char buffer[128];
+    if (key.size() < sizeof(buffer)) {
+        std::memcpy(buffer, key.data(), key.size());
+        buffer[key.size()] = '\0';
+        return GetPropertyValueView(buffer, std::nullopt);
+    }
+    return GetPropertyValueView(std::string(key).c_str(), std::nullopt);
+}
+
 void Device::InvalidateCache() {
     devname.reset();
+    devnum.reset();
     devpath.reset();
     devtype.reset();
     driver.reset();
@@ -240,10 +597,47 @@ Device::Device(sd_device* dev)
     }
 }
 
+Device Device::Borrow(sd_device* dev) {
+    Device borrowed(dev);
+    borrowed.device = std::unique_ptr<sd_device, decltype(&Device::DeviceUnref)>(borrowed.device.release(), &Device::DeviceNoUnref);
+    return borrowed;
+}
+
+Device::Device(std::unique_ptr<const DeviceProperties> deviceProperties)
+    : device(nullptr, &Device::DeviceUnref),
+      properties(std::move(deviceProperties)) {
+}
+
 void Device::DeviceUnref(sd_device* dev) {
     dev ? sd_device_unref(dev) : throw std::runtime_error("Tried to unreference a Device already unreferenced!");
 }
 
+void Device::DeviceNoUnref(sd_device*) {
+}
+
+std::optional<std::string_view> Device::GetView(int (*getter)(sd_device*, const char**), const std::optional<std::string>& cache) const {
+    if (!device) {
+        return cache ? std::make_optional<std::string_view>(*cache) : std::nullopt;
+    }
+    const char* val = nullptr;
+    return (getter(device.get(), &val) >= 0 && val) ? std::make_optional<std::string_view>(val) : std::nullopt;
+}
+
+std::optional<std::string_view> Device::GetNetActionView() const {
+    if (!netAction || static_cast<std::size_t>(*netAction) >= sizeof(actionNames) / sizeof(actionNames[0])) {
+        return std::nullopt;
+    }
+    return std::string_view(actionNames[*netAction]);
+}
+
+std::optional<std::string_view> Device::GetPropertyValueView(const char* key, const std::optional<std::string>& cache) const {
+    if (!device) {
+        return cache ? std::make_optional<std::string_view>(*cache) : std::nullopt;
+    }
+    const char* val = nullptr;
+    return (sd_device_get_property_value(device.get(), key, &val) >= 0 && val) ? std::make_optional<std::string_view>(val) : std::nullopt;
+}
+
 template <typename T, typename GetterFunc>
 auto Device::GetCachedValueOrFetch(std::optional<T>& cache, GetterFunc&& getter, bool refreshCache) const
 -> std::conditional_t<(sizeof(T) > sizeof(void*)), const std::optional<T>&, std::optional<T>> {
@@ -1,13 +1,46 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <memory>
 #include <optional>
+#include <cstdint>
+#include <vector>
+#include <sys/types.h>
+#include <EventMonitor/DeviceProperties.h>
 
 extern "C" {
     #include <systemd/sd-device.h>
 }
 
+// The fields cached by a Device, in the order of their getters.
+enum class DeviceField : uint8_t {
+    Devname,
+    Devpath,
+    Devtype,
+    Driver,
+    Name,
+    Path,
+    ProductID,
+    Serial,
+    Subsystem,
+    Sysname,
+    Sysnum,
+    Syspath,
+    Type,
+    VendorID,
+    Count
+};
+
+// Bitmask of DeviceField values.
+using DeviceFieldMask = uint32_t;
+
+constexpr DeviceFieldMask DeviceFieldBit(DeviceField field) {
+    return DeviceFieldMask(1) << static_cast<uint8_t>(field);
+}
+
+constexpr DeviceFieldMask allDeviceFields = DeviceFieldBit(DeviceField::Count) - 1;
+
 class Device {
 public:
     ~Device() = default;
@@ -25,9 +58,12 @@ public:
     static Device CreateFromPath(const std::string& path);
     static Device CreateFromIfname(const std::string& ifname);
     static Device CreateFromIfindex(int ifindex);
+    // Detached device (see IsDetached()) built from a uevent property set, e.g. a recorded one.
+    // Fields are derived from the properties the way libsystemd does (SYSPATH from DEVPATH, devnum from MAJOR/MINOR...).
+    static Device CreateFromProperties(DeviceProperties properties);
     
     const std::optional<std::string>& GetDevname(const bool refreshCache = false) const;
-    // TODO : GetDevnum()
+    std::optional<dev_t> GetDevnum(const bool refreshCache = false) const;
     const std::optional<std::string>& GetDevpath(const bool refreshCache = false) const;
     const std::optional<std::string>& GetDevtype(const bool refreshCache = false) const;
     // TODO : GetDiskseq()
@@ -36,7 +72,11 @@ public:
     const std::optional<std::string>& GetName(const bool refreshCache = false) const;
     const std::optional<std::string>& GetPath(const bool refreshCache = false) const;
     const std::optional<std::string>& GetProductID(const bool refreshCache = false) const;
-    // TODO : GetSeqnum()
+    std::optional<uint64_t> GetSeqnum() const;
+    // CLOCK_MONOTONIC microseconds at which udev first initialized the device (USEC_INITIALIZED).
+    std::optional<uint64_t> GetUsecInitialized() const;
+    // CLOCK_MONOTONIC nanoseconds at which a DeviceMonitor received the device, 0 if none did.
+    uint64_t GetReceiveTime() const { return receiveTime; }
     const std::optional<std::string>& GetSerial(const bool refreshCache = false) const;
     const std::optional<std::string>& GetSubsystem(const bool refreshCache = false) const;
     const std::optional<std::string>& GetSysname(const bool refreshCache = false) const;
@@ -44,18 +84,69 @@ public:
     const std::optional<std::string>& GetSyspath(const bool refreshCache = false) const;
     const std::optional<std::string>& GetType(const bool refreshCache = false) const;
     const std::optional<std::string>& GetVendorID(const bool refreshCache = false) const;
+    // Same as calling the getter of the field.
+    const std::optional<std::string>& GetField(DeviceField field, const bool refreshCache = false) const;
+
+    // Uncached views into the memory owned by libsystemd, valid as long as this Device is alive and not refreshed.
+    // Nothing is allocated, which suits filtering and comparisons against literals.
+    // An unplugged device (device == nullptr) falls back to the cached values.
+    std::optional<std::string_view> GetDevnameView() const;
+    std::optional<std::string_view> GetDevpathView() const;
+    std::optional<std::string_view> GetDevtypeView() const;
+    std::optional<std::string_view> GetDriverView() const;
+    std::optional<std::string_view> GetNameView() const;
+    std::optional<std::string_view> GetPathView() const;
+    std::optional<std::string_view> GetProductIDView() const;
+    std::optional<std::string_view> GetSerialView() const;
+    std::optional<std::string_view> GetSubsystemView() const;
+    std::optional<std::string_view> GetSysnameView() const;
+    std::optional<std::string_view> GetSysnumView() const;
+    std::optional<std::string_view> GetSyspathView() const;
+    std::optional<std::string_view> GetTypeView() const;
+    std::optional<std::string_view> GetVendorIDView() const;
+    // Same as calling the view getter of the field.
+    std::optional<std::string_view> GetFieldView(DeviceField field) const;
+
+    // Fill the caches of the requested fields in one pass : one core getter call per field, with aliased fields
+    // (Name/Sysname, Path/Devpath, Type/Devtype) sharing the call, and a single walk over the property list for
+    // the property-backed fields. Already cached fields are skipped unless refreshCache is set.
+    void Prefetch(DeviceFieldMask fields, const bool refreshCache = false) const;
+    void PrefetchAll(const bool refreshCache = false) const { Prefetch(allDeviceFields, refreshCache); }
+
+    // Every property of the device, not cached.
+    DeviceProperties GetAllProperties() const;
+    // Call visitor(key, value) with views of every property, valid during the call only. Nothing is copied.
+    template <typename Visitor>
+    void ForEachProperty(Visitor&& visitor) const;
 
     // TODO : Document these are not in cache
     const std::optional<sd_device_action_t> GetAction() const; // TODO : Change this to use our own custom enum or something else ?
-    const std::optional<std::string> GetPropertyFromKey(std::string key) const;
+    const std::optional<std::string> GetPropertyFromKey(const std::string& key) const;
+    std::optional<std::string_view> GetPropertyView(std::string_view key) const;
+    // Value of a sysfs attribute (e.g. "idVendor"), trailing newline stripped, or the target name of a symlink
+    // attribute (e.g. "driver"). Read on first use then cached by libsystemd. None for detached devices.
+    // See SysattrReader to read many attributes at once.
+    std::optional<std::string> GetSysattrValue(const std::string& sysattr) const;
+    std::vector<std::string> GetTags() const;
+    // Closest ancestor in sysfs being a device itself, not cached. None for detached devices.
+    std::optional<Device> GetParent() const;
 
     // TODO: Use boolean to indicate if cache is stale ?
     void InvalidateCache();
 
+    // Not backed by libsystemd, every getter answers from the cache and the properties it was created with.
+    bool IsDetached() const { return !device; }
+
 private:
     explicit Device(sd_device* dev);
+    // Detached device.
+    explicit Device(std::unique_ptr<const DeviceProperties> properties);
+
+    // Wrap the device without taking a reference, the caller guarantees it outlives this Device.
+    static Device Borrow(sd_device* dev);
 
     static void DeviceUnref(sd_device* dev);
+    static void DeviceNoUnref(sd_device* dev);
 
     // Generic caching helper function.
     //
@@ -79,9 +170,21 @@ private:
     -> std::conditional_t<(sizeof(T) > sizeof(void*)), const std::optional<T>&, std::optional<T>>;
 
 
+    std::optional<std::string_view> GetView(int (*getter)(sd_device*, const char**), const std::optional<std::string>& cache) const;
+    std::optional<std::string_view> GetPropertyValueView(const char* key, const std::optional<std::string>& cache) const;
+    // Name of netAction, none when not set.
+    std::optional<std::string_view> GetNetActionView() const;
+
     std::unique_ptr<sd_device, decltype(&Device::DeviceUnref)> device;
+    // Only set for detached devices.
+    std::unique_ptr<const DeviceProperties> properties;
+    // Net action of a device standing for several coalesced events, see DeviceMonitor::EnableCoalescing().
+    // Overrides the ACTION property everywhere it is read : GetAction(), the property getters and ForEachProperty().
+    std::optional<sd_device_action_t> netAction;
+    uint64_t receiveTime = 0;
 
     mutable std::optional<std::string> devname;
+    mutable std::optional<dev_t> devnum;
     mutable std::optional<std::string> devpath;
     mutable std::optional<std::string> devtype;
     mutable std::optional<std::string> driver;
@@ -98,4 +201,28 @@ private:
 
     friend class DeviceEnumerator;
     friend class DeviceMonitor;
-};
\ No newline at end of file
+};
+
+template <typename Visitor>
+void Device::ForEachProperty(Visitor&& visitor) const {
+    // A coalesced device reports its net action rather than the action of its last event.
+    const auto action = GetNetActionView();
+    const auto visit = [&visitor, &action](std::string_view key, std::string_view value) {
+        visitor(key, (action && key == "ACTION") ? *action : value);
+    };
+
+    if (properties) {
+        for (const auto& [key, value] : *properties) {
+            visit(key, value);
+        }
+        return;
+    }
+    if (!device) {
+        return;
+    }
+
+    const char* value = nullptr;
+    for (const char* key = sd_device_get_property_first(device.get(), &value); key; key = sd_device_get_property_next(device.get(), &value)) {
+        visit(std::string_view(key), std::string_view(value ? value : ""));
+    }
+}
@@ -1,6 +1,45 @@
 #include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/WorkStealingPool.h>
+#include <algorithm>
+#include <exception>
+#include <filesystem>
+#include <fnmatch.h>
 #include <stdexcept>
 
+// *** Iterator ***
+
+DeviceEnumerator::Iterator::Iterator(const DeviceEnumerator* deviceEnumerator, bool borrowedDevices)
+    : enumerator(deviceEnumerator),
+      borrowed(borrowedDevices) {
+    Assign(sd_device_enumerator_get_device_first(enumerator->enumerator.get()));
+}
+
+DeviceEnumerator::Iterator& DeviceEnumerator::Iterator::operator++() {
+    if (enumerator) {
+        // Release the current device first, a borrowed one is invalidated by the enumerator moving on.
+        current.reset();
+        Assign(sd_device_enumerator_get_device_next(enumerator->enumerator.get()));
+    }
+    return *this;
+}
+
+void DeviceEnumerator::Iterator::Assign(sd_device* dev) {
+    if (!dev) {
+        current.reset();
+        enumerator = nullptr;
+        return;
+    }
+    if (borrowed) {
+        current.emplace(Device::Borrow(dev));
+    }
+    else {
+        sd_device_ref(dev); // Increment reference count to prevent deallocation when enumerator is destroyed.
+        current.emplace(Device(dev));
+    }
+}
+
+// *** DeviceEnumerator ***
+
 DeviceEnumerator::DeviceEnumerator() 
     : enumerator(nullptr, &sd_device_enumerator_unref) {
     sd_device_enumerator* enumeratorTemp = nullptr;
@@ -30,6 +69,7 @@ std::optional<Device> DeviceEnumerator::GetDeviceNext() const {
 }
 
 std::vector<Device> DeviceEnumerator::GetAllDevices() const {
+    const auto started = std::chrono::steady_clock::now();
     std::vector<Device> devices;
     for (sd_device* dev = sd_device_enumerator_get_device_first(enumerator.get()); 
     dev != nullptr;
@@ -37,6 +77,90 @@ std::vector<Device> DeviceEnumerator::GetAllDevices() const {
         sd_device_ref(dev); // Increment reference count to prevent deallocation when enumerator is destroyed.
         devices.push_back(Device(dev));
     }
+    RecordEnumeration(started, devices.size());
+    return devices;
+}
+
+std::optional<Device> DeviceEnumerator::GetSubsystemFirst() const {
+    sd_device* dev = sd_device_enumerator_get_subsystem_first(enumerator.get());
+    if (!dev) {
+        return std::nullopt;
+    }
+    sd_device_ref(dev); // Increment reference count to prevent deallocation when enumerator is destroyed.
+    return Device(dev);
+}
+
+std::optional<Device> DeviceEnumerator::GetSubsystemNext() const {
+    sd_device* dev = sd_device_enumerator_get_subsystem_next(enumerator.get());
+    if (!dev) {
+        return std::nullopt;
+    }
+    sd_device_ref(dev); // Increment reference count to prevent deallocation when enumerator is destroyed.
+    return Device(dev);
+}
+
+std::vector<Device> DeviceEnumerator::GetAllSubsystems() const {
+    std::vector<Device> subsystems;
+    for (sd_device* dev = sd_device_enumerator_get_subsystem_first(enumerator.get());
+    dev != nullptr;
+    dev = sd_device_enumerator_get_subsystem_next(enumerator.get())) {
+        sd_device_ref(dev); // Increment reference count to prevent deallocation when enumerator is destroyed.
+        subsystems.push_back(Device(dev));
+    }
+    return subsystems;
+}
+
+std::vector<Device> DeviceEnumerator::GetAllDevicesParallel(std::size_t threadCount, DeviceFieldMask prefetchFields) const {
+    const auto started = std::chrono::steady_clock::now();
+    const std::vector<std::string> partitions = GetPartitions();
+    // Sorting reads the syspath, let the workers fetch it.
+    prefetchFields |= DeviceFieldBit(DeviceField::Syspath);
+
+    // Each task only touches its own slot, the devices are handed over to this thread by Wait().
+    std::vector<std::vector<Device>> results(partitions.size());
+    std::vector<std::exception_ptr> errors(partitions.size());
+    {
+        WorkStealingPool pool(threadCount);
+        for (std::size_t i = 0; i < partitions.size(); ++i) {
+            pool.Submit([this, &partitions, &results, &errors, prefetchFields, i]() {
+                try {
+                    DeviceEnumerator partition;
+                    partition.AddMatchSubsystem(partitions[i], true);
+                    for (const auto& filter : filters) {
+                        if (filter(partition.enumerator.get()) < 0) {
+                            throw std::runtime_error("Failed to replay filter on partition!");
+                        }
+                    }
+                    results[i] = partition.GetAllDevices();
+                    for (const Device& device : results[i]) {
+                        device.Prefetch(prefetchFields);
+                    }
+                }
+                catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            });
+        }
+        pool.Wait();
+    }
+
+    std::size_t deviceCount = 0;
+    for (std::size_t i = 0; i < partitions.size(); ++i) {
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+        deviceCount += results[i].size();
+    }
+
+    std::vector<Device> devices;
+    devices.reserve(deviceCount);
+    for (auto& result : results) {
+        std::move(result.begin(), result.end(), std::back_inserter(devices));
+    }
+    std::sort(devices.begin(), devices.end(), [](const Device& lhs, const Device& rhs) {
+        return lhs.GetSyspath() < rhs.GetSyspath();
+    });
+    RecordEnumeration(started, devices.size());
     return devices;
 }
 
@@ -44,42 +168,59 @@ void DeviceEnumerator::AddMatchSubsystem(const std::string& subsystem, bool matc
     if (sd_device_enumerator_add_match_subsystem(enumerator.get(), subsystem.c_str(), matchSubsystem) < 0) {
         throw std::runtime_error("Failed to add subsystem match!");
     }
+    if (matchSubsystem) {
+        subsystemMatches.push_back(subsystem);
+    }
+    else {
+        filters.push_back([subsystem](sd_device_enumerator* e) { return sd_device_enumerator_add_match_subsystem(e, subsystem.c_str(), false); });
+    }
 }
 
 void DeviceEnumerator::AddMatchSysattr(const std::string& sysattr, const std::string& value, bool matchSysattr) {
-    if (sd_device_enumerator_add_match_sysattr(enumerator.get(), sysattr.c_str(), value.c_str(), matchSysattr) < 0) {
-        throw std::runtime_error("Failed to add sysattr match!");
-    }
+    AddFilter([sysattr, value, matchSysattr](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_match_sysattr(e, sysattr.c_str(), value.c_str(), matchSysattr);
+    }, "Failed to add sysattr match!");
 }
 
 void DeviceEnumerator::AddMatchProperty(const std::string& property, const std::string& value) {
-    if (sd_device_enumerator_add_match_property(enumerator.get(), property.c_str(), value.c_str()) < 0) {
-        throw std::runtime_error("Failed to add property match!");
-    }
+    AddFilter([property, value](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_match_property(e, property.c_str(), value.c_str());
+    }, "Failed to add property match!");
 }
 
 void DeviceEnumerator::AddMatchProperty_required(const std::string& property, const std::string& value) {
-    if (sd_device_enumerator_add_match_property(enumerator.get(), property.c_str(), value.c_str()) < 0) {
-        throw std::runtime_error("Failed to add required property match!");
-    }
+    AddFilter([property, value](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_match_property(e, property.c_str(), value.c_str());
+    }, "Failed to add required property match!");
 }
 
 void DeviceEnumerator::AddMatchSysname(const std::string& sysname) {
-    if (sd_device_enumerator_add_match_sysname(enumerator.get(), sysname.c_str()) < 0) {
-        throw std::runtime_error("Failed to add sysname match!");
-    }
+    AddFilter([sysname](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_match_sysname(e, sysname.c_str());
+    }, "Failed to add sysname match!");
 }
 
 void DeviceEnumerator::AddNomatchSysname(const std::string& sysname) {
-    if (sd_device_enumerator_add_nomatch_sysname(enumerator.get(), sysname.c_str()) < 0) {
-        throw std::runtime_error("Failed to add no-match sysname!");
-    }
+    AddFilter([sysname](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_nomatch_sysname(e, sysname.c_str());
+    }, "Failed to add no-match sysname!");
 }
 
 void DeviceEnumerator::AddMatchTag(const std::string& tag) {
-    if (sd_device_enumerator_add_match_tag(enumerator.get(), tag.c_str()) < 0) {
-        throw std::runtime_error("Failed to add tag match!");
+    AddFilter([tag](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_match_tag(e, tag.c_str());
+    }, "Failed to add tag match!");
+}
+
+void DeviceEnumerator::AddMatchParent(const Device& parent) {
+    if (!parent.device) {
+        throw std::invalid_argument("Failed to add parent match : Parent device is invalid!");
     }
+    // The filter is replayed on partitions, it keeps its own reference on the parent.
+    std::shared_ptr<sd_device> device(sd_device_ref(parent.device.get()), &sd_device_unref);
+    AddFilter([device](sd_device_enumerator* e) {
+        return sd_device_enumerator_add_match_parent(e, device.get());
+    }, "Failed to add parent match!");
 }
 
 void DeviceEnumerator::Reset() {
@@ -88,4 +229,67 @@ void DeviceEnumerator::Reset() {
         throw std::runtime_error("Failed to reset DeviceEnumerator!");
     }
     enumerator.reset(enumeratorTemp);
-}
\ No newline at end of file
+    filters.clear();
+    subsystemMatches.clear();
+}
+
+void DeviceEnumerator::SetMetrics(std::shared_ptr<MetricsRegistry> registry, const MetricsRegistry::Labels& labels) {
+    if (!registry) {
+        metrics.reset();
+        enumerationCount = MetricsRegistry::Counter();
+        enumeratedDevices = MetricsRegistry::Counter();
+        enumerationDuration = nullptr;
+        return;
+    }
+
+    enumerationCount = registry->AddCounter("eventmonitor_enumerations_total", "Completed enumerations.", labels);
+    enumeratedDevices = registry->AddCounter("eventmonitor_enumerated_devices_total", "Devices returned by enumerations.", labels);
+    enumerationDuration = &registry->AddSummary("eventmonitor_enumeration_duration_seconds", "Time taken by an enumeration.", labels);
+    metrics = std::move(registry);
+}
+
+// *** Private ***
+
+void DeviceEnumerator::AddFilter(Filter filter, const char* error) {
+    if (filter(enumerator.get()) < 0) {
+        throw std::runtime_error(error);
+    }
+    filters.push_back(std::move(filter));
+}
+
+std::vector<std::string> DeviceEnumerator::GetPartitions() const {
+    // Bus subsystems are listed by libsystemd, class subsystems only exist as directories.
+    std::vector<std::string> names;
+    DeviceEnumerator subsystems;
+    for (const Device& subsystem : subsystems.GetAllSubsystems()) {
+        if (subsystem.GetSubsystemView() == std::string_view("subsystem")) {
+            if (const auto name = subsystem.GetSysnameView()) {
+                names.emplace_back(*name);
+            }
+        }
+    }
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/class", error)) {
+        names.push_back(entry.path().filename().string());
+    }
+
+    std::sort(names.begin(), names.end());
+    names.erase(std::unique(names.begin(), names.end()), names.end());
+    if (!subsystemMatches.empty()) {
+        names.erase(std::remove_if(names.begin(), names.end(), [this](const std::string& name) {
+            return std::none_of(subsystemMatches.begin(), subsystemMatches.end(), [&name](const std::string& pattern) {
+                return fnmatch(pattern.c_str(), name.c_str(), 0) == 0;
+            });
+        }), names.end());
+    }
+    return names;
+}
+
+void DeviceEnumerator::RecordEnumeration(std::chrono::steady_clock::time_point started, std::size_t deviceCount) const {
+    if (!metrics) {
+        return;
+    }
+    enumerationCount.Add();
+    enumeratedDevices.Add(deviceCount);
+    enumerationDuration->Record(std::chrono::steady_clock::now() - started);
+}
@@ -1,6 +1,11 @@
 #pragma once
 
 #include "Device.h"
+#include "MetricsRegistry.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <iterator>
 #include <optional>
 #include <string>
 #include <memory>
@@ -12,6 +17,54 @@ extern "C" {
 
 class DeviceEnumerator {
 public:
+    // Input iterator yielding the devices one at a time, as libsystemd hands them out.
+    // The enumerator holds the iteration state, so only one iteration may be in progress at a time.
+    class Iterator {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = Device;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Device*;
+        using reference = const Device&;
+
+        // End iterator.
+        explicit Iterator() = default;
+
+        reference operator*() const { return *current; }
+        pointer operator->() const { return &*current; }
+        Iterator& operator++();
+
+        bool operator==(const Iterator& other) const { return enumerator == other.enumerator; }
+        bool operator!=(const Iterator& other) const { return !(*this == other); }
+
+    private:
+        friend class DeviceEnumerator;
+
+        explicit Iterator(const DeviceEnumerator* enumerator, bool borrowed);
+
+        void Assign(sd_device* dev);
+
+        // Null once exhausted, which makes it equal to the end iterator.
+        const DeviceEnumerator* enumerator = nullptr;
+        bool borrowed = false;
+        std::optional<Device> current;
+    };
+
+    // Range of non-owning devices, only valid until the iterator is incremented.
+    // Copy what you need (e.g. GetSyspath()) or create a new Device from the syspath to keep it.
+    class BorrowedRange {
+    public:
+        Iterator begin() const { return Iterator(&enumerator, true); }
+        Iterator end() const { return Iterator(); }
+
+    private:
+        friend class DeviceEnumerator;
+
+        explicit BorrowedRange(const DeviceEnumerator& enumerator) : enumerator(enumerator) {}
+
+        const DeviceEnumerator& enumerator;
+    };
+
     explicit DeviceEnumerator();
     ~DeviceEnumerator() = default;
     DeviceEnumerator(const DeviceEnumerator&) = delete;
@@ -22,9 +75,23 @@ public:
     std::optional<Device> GetDeviceFirst() const;
     std::optional<Device> GetDeviceNext()const;
     std::vector<Device> GetAllDevices() const;
-    std::optional<Device> GetSubsystemFirst(); // TODO : Implement
-    std::optional<Device> GetSubsystemNext(); // TODO : Implement
-    std::vector<Device> GetAllSubsystems(); // TODO : Implement
+
+    // Lazily iterate over the devices, e.g. `for (const Device& device : enumerator)`, each one owning a reference.
+    Iterator begin() const { return Iterator(this, false); }
+    Iterator end() const { return Iterator(); }
+    // Same as iterating over the enumerator, without taking a reference on each device.
+    BorrowedRange Borrowed() const& { return BorrowedRange(*this); }
+    // The range would outlive a temporary enumerator.
+    BorrowedRange Borrowed() const&& = delete;
+    // Subsystem, driver and module devices (e.g. /sys/bus/usb), not the devices belonging to them.
+    std::optional<Device> GetSubsystemFirst() const;
+    std::optional<Device> GetSubsystemNext() const;
+    std::vector<Device> GetAllSubsystems() const;
+
+    // Same devices as GetAllDevices(), enumerated one subsystem per task on a WorkStealingPool of threadCount threads
+    // (0 for one per hardware thread), with the fields in prefetchFields read by the workers as well.
+    // The filters of this enumerator apply to every partition. The result is sorted by syspath.
+    std::vector<Device> GetAllDevicesParallel(std::size_t threadCount = 0, DeviceFieldMask prefetchFields = 0) const;
 
     // TODO : Should probably remove assert and replace by log error.
     void AddMatchSubsystem(const std::string& subsystem, bool matchSubsystem);
@@ -34,11 +101,34 @@ public:
     void AddMatchSysname(const std::string& sysname);
     void AddNomatchSysname(const std::string& sysname);
     void AddMatchTag(const std::string& tag);
-    void AddMatchParent(sd_device_enumerator *enumerator, sd_device *parent); // TODO : Implement
+    // Only the parent and the devices below it. The parent must not be detached.
+    void AddMatchParent(const Device& parent);
 
     // Remove all filters from the enumerator.
     void Reset();
+    // Whether any match was added since construction or the last Reset().
+    bool HasFilters() const { return !filters.empty() || !subsystemMatches.empty(); }
+
+    // Count and time GetAllDevices() and GetAllDevicesParallel() into the registry, every series labelled with
+    // the given labels. Null stops it.
+    void SetMetrics(std::shared_ptr<MetricsRegistry> registry, const MetricsRegistry::Labels& labels = {});
 
 private:
+    using Filter = std::function<int(sd_device_enumerator*)>;
+
+    void AddFilter(Filter filter, const char* error);
+    // Names of the subsystems known to sysfs matching the positive subsystem filters, sorted.
+    std::vector<std::string> GetPartitions() const;
+    void RecordEnumeration(std::chrono::steady_clock::time_point started, std::size_t deviceCount) const;
+
     std::unique_ptr<sd_device_enumerator, decltype(&sd_device_enumerator_unref)> enumerator;
+    // Applied filters, replayed on the enumerator of every partition of GetAllDevicesParallel().
+    // Positive subsystem filters are kept apart since each partition already is a subsystem match.
+    std::vector<Filter> filters;
+    std::vector<std::string> subsystemMatches;
+
+    std::shared_ptr<MetricsRegistry> metrics;
+    MetricsRegistry::Counter enumerationCount;
+    MetricsRegistry::Counter enumeratedDevices;
+    LatencyHistogram* enumerationDuration = nullptr;
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include <EventMonitor/DeviceExecutor.h>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+
+namespace {
+    // Devices a shard handles before yielding its worker to other shards.
+    constexpr int shardBudget = 32;
+}
+
+// *** Public ***
+
+DeviceExecutor::DeviceExecutor(DeviceHandler deviceHandler, std::size_t threadCount, KeyFunction key,
+                               std::size_t numberOfShards, const std::vector<int>& cpuAffinity)
+    : handler(std::move(deviceHandler)),
+      keyFunction(key ? std::move(key) : KeyFunction(&DeviceExecutor::HashSyspath)),
+      shardCount(numberOfShards),
+      shards(nullptr),
+      queuedDevices(0),
+      activeShards(0),
+      pool(threadCount, cpuAffinity) {
+    if (!handler) {
+        throw std::invalid_argument("Failed to create DeviceExecutor : Handler cannot be null!");
+    }
+    if (shardCount == 0) {
+        throw std::invalid_argument("Failed to create DeviceExecutor : Shard count cannot be 0!");
+    }
+    shards.reset(new Shard[shardCount]);
+}
+
+void DeviceExecutor::Submit(Device device) {
+    const std::size_t index = keyFunction(device) % shardCount;
+    Shard& shard = shards[index];
+
+    bool schedule = false;
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.devices.push_back(std::move(device));
+        if (!shard.scheduled) {
+            shard.scheduled = true;
+            schedule = true;
+        }
+    }
+    queuedDevices.fetch_add(1, std::memory_order_relaxed);
+
+    if (schedule) {
+        activeShards.fetch_add(1, std::memory_order_relaxed);
+        pool.Submit([this, index]() { RunShard(index); });
+    }
+}
+
+void DeviceExecutor::Wait() {
+    pool.Wait();
+}
+
+DeviceExecutor::Stats DeviceExecutor::GetStats() const {
+    Stats stats{ queuedDevices.load(std::memory_order_relaxed), activeShards.load(std::memory_order_relaxed), 0, pool.GetStats() };
+    for (const auto& worker : stats.workers) {
+        stats.stolenCount += worker.stolenCount;
+    }
+    return stats;
+}
+
+std::size_t DeviceExecutor::HashSyspath(const Device& device) {
+    const auto syspath = device.GetSyspathView();
+    return syspath ? std::hash<std::string_view>()(*syspath) : 0;
+}
+
+// *** Private ***
+
+void DeviceExecutor::RunShard(std::size_t index) {
+    Shard& shard = shards[index];
+
+    for (int handled = 0;; ++handled) {
+        // Budget spent, requeue the shard behind the others instead of monopolizing this worker.
+        // A stopping pool refuses the task, the shard is then drained right here.
+        if (handled == shardBudget && pool.Submit([this, index]() { RunShard(index); })) {
+            return;
+        }
+
+        std::optional<Device> device;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            if (shard.devices.empty()) {
+                shard.scheduled = false;
+                activeShards.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+            device.emplace(std::move(shard.devices.front()));
+            shard.devices.pop_front();
+        }
+        queuedDevices.fetch_sub(1, std::memory_order_relaxed);
+
+        handler(std::move(*device));
+    }
+}
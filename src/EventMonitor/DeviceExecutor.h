@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/WorkStealingPool.h>
+
+// Runs a device handler on a work-stealing thread pool while keeping devices with the same key in order.
+//
+// Devices are sharded by key onto serial queues. A shard is scheduled on the pool only while it has pending devices,
+// and handles them one at a time, so devices of one shard never run concurrently nor out of order,
+// while devices of different shards run in parallel. Distinct keys may share a shard, which only serializes them.
+class DeviceExecutor {
+public:
+    using DeviceHandler = std::function<void(Device)>;
+    using KeyFunction = std::function<std::size_t(const Device&)>;
+
+    struct Stats {
+        // Devices submitted and not handled yet.
+        std::size_t queuedDevices;
+        // Shards currently scheduled on the pool.
+        std::size_t activeShards;
+        uint64_t stolenCount;
+        std::vector<WorkStealingPool::WorkerStats> workers;
+    };
+
+    // The default key is the hash of the device syspath, so every device keeps its add, change, remove order.
+    // A threadCount of 0 uses one worker per hardware thread.
+    explicit DeviceExecutor(DeviceHandler handler, std::size_t threadCount = 0, KeyFunction keyFunction = nullptr,
+                            std::size_t shardCount = 1024, const std::vector<int>& cpuAffinity = {});
+    // Handle the queued devices, then join the workers.
+    ~DeviceExecutor() = default;
+    DeviceExecutor(const DeviceExecutor&) = delete;
+    DeviceExecutor(DeviceExecutor&&) = delete;
+    DeviceExecutor& operator=(const DeviceExecutor&) = delete;
+    DeviceExecutor& operator=(DeviceExecutor&&) = delete;
+
+    void Submit(Device device);
+    // Block until every submitted device has been handled.
+    void Wait();
+
+    Stats GetStats() const;
+
+    static std::size_t HashSyspath(const Device& device);
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::deque<Device> devices;
+        bool scheduled = false;
+    };
+
+    void RunShard(std::size_t index);
+
+    DeviceHandler handler;
+    KeyFunction keyFunction;
+
+    const std::size_t shardCount;
+    std::unique_ptr<Shard[]> shards;
+    std::atomic<std::size_t> queuedDevices;
+    std::atomic<std::size_t> activeShards;
+
+    // Declared last so the workers are joined before the shards are destroyed.
+    WorkStealingPool pool;
+};
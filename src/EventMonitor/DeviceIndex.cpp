@@ -0,0 +1,171 @@
+#include <EventMonitor/DeviceIndex.h>
+#include <algorithm>
+#include <stdexcept>
+
+// *** Public ***
+
+DeviceIndex::DeviceIndex(std::shared_ptr<StringTable> stringTable)
+    : strings(std::move(stringTable)) {
+    if (!strings) {
+        throw std::invalid_argument("Failed to create DeviceIndex : StringTable is null!");
+    }
+}
+
+void DeviceIndex::Build(const DeviceEnumerator& enumerator) {
+    Clear();
+    for (const Device& device : enumerator.Borrowed()) {
+        Insert(device);
+    }
+}
+
+void DeviceIndex::Insert(const Device& device) {
+    auto snapshot = std::make_shared<const DeviceSnapshot>(DeviceSnapshot::FromDevice(device, strings));
+    const auto syspath = snapshot->GetSyspath();
+    if (!syspath) {
+        return;
+    }
+    std::string key(*syspath);
+    Erase(key);
+
+    Slot slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        slot = static_cast<Slot>(records.size());
+        records.emplace_back();
+    }
+    records[slot].snapshot = std::move(snapshot);
+    const DeviceSnapshot& indexed = *records[slot].snapshot;
+
+    if (const auto subsystem = indexed.GetSubsystem()) {
+        Index(slot, Subsystem, std::string(*subsystem));
+    }
+    if (const auto driver = indexed.GetDriver()) {
+        Index(slot, Driver, std::string(*driver));
+    }
+    if (const auto devtype = indexed.GetDevtype()) {
+        Index(slot, Devtype, std::string(*devtype));
+    }
+    if (const auto vendorID = indexed.GetVendorID()) {
+        Index(slot, Vendor, std::string(*vendorID));
+        if (const auto modelID = indexed.GetProductID()) {
+            Index(slot, VendorModel, MakeVendorModelKey(*vendorID, *modelID));
+        }
+    }
+    for (auto& tag : device.GetTags()) {
+        Index(slot, Tag, std::move(tag));
+    }
+    if (const auto devnum = device.GetDevnum()) {
+        Index(slot, Devnum, MakeDevnumKey(*devnum));
+    }
+
+    slots.emplace(std::move(key), slot);
+}
+
+bool DeviceIndex::Erase(std::string_view syspath) {
+    const auto it = slots.find(std::string(syspath));
+    if (it == slots.end()) {
+        return false;
+    }
+
+    const Slot slot = it->second;
+    Record& record = records[slot];
+    for (const auto& [key, value] : record.keys) {
+        auto& postingLists = postings[key];
+        const auto posting = postingLists.find(value);
+        posting->second.erase(slot);
+        if (posting->second.empty()) {
+            postingLists.erase(posting);
+        }
+    }
+    record.keys.clear();
+    record.snapshot.reset();
+    freeSlots.push_back(slot);
+    slots.erase(it);
+    return true;
+}
+
+void DeviceIndex::Clear() {
+    records.clear();
+    freeSlots.clear();
+    slots.clear();
+    for (auto& postingLists : postings) {
+        postingLists.clear();
+    }
+}
+
+DeviceIndex::Result DeviceIndex::Find(const DeviceQuery& query) const {
+    std::vector<const PostingList*> constraints;
+    const auto addConstraint = [this, &constraints](Key key, const std::string& value) {
+        constraints.push_back(GetPostingList(key, value));
+    };
+    if (query.subsystem) {
+        addConstraint(Subsystem, *query.subsystem);
+    }
+    if (query.driver) {
+        addConstraint(Driver, *query.driver);
+    }
+    if (query.devtype) {
+        addConstraint(Devtype, *query.devtype);
+    }
+    if (query.vendorID) {
+        query.modelID ? addConstraint(VendorModel, MakeVendorModelKey(*query.vendorID, *query.modelID)) : addConstraint(Vendor, *query.vendorID);
+    }
+    for (const auto& tag : query.tags) {
+        addConstraint(Tag, tag);
+    }
+    if (query.devnum) {
+        addConstraint(Devnum, MakeDevnumKey(*query.devnum));
+    }
+
+    Result result;
+    if (constraints.empty()) {
+        result.reserve(slots.size());
+        for (const auto& [syspath, slot] : slots) {
+            result.push_back(records[slot].snapshot);
+        }
+        return result;
+    }
+    // A key nobody has, nothing can match.
+    if (std::find(constraints.begin(), constraints.end(), nullptr) != constraints.end()) {
+        return result;
+    }
+
+    std::sort(constraints.begin(), constraints.end(), [](const PostingList* lhs, const PostingList* rhs) {
+        return lhs->size() < rhs->size();
+    });
+    for (const Slot slot : *constraints.front()) {
+        const bool matches = std::all_of(constraints.begin() + 1, constraints.end(), [slot](const PostingList* postingList) {
+            return postingList->count(slot) > 0;
+        });
+        if (matches) {
+            result.push_back(records[slot].snapshot);
+        }
+    }
+    return result;
+}
+
+// *** Private ***
+
+std::string DeviceIndex::MakeVendorModelKey(std::string_view vendorID, std::string_view modelID) {
+    std::string key;
+    key.reserve(vendorID.size() + 1 + modelID.size());
+    key.append(vendorID).append(1, ':').append(modelID);
+    return key;
+}
+
+std::string DeviceIndex::MakeDevnumKey(dev_t devnum) {
+    return std::to_string(devnum);
+}
+
+void DeviceIndex::Index(Slot slot, Key key, std::string value) {
+    postings[key][value].insert(slot);
+    records[slot].keys.emplace_back(key, std::move(value));
+}
+
+const DeviceIndex::PostingList* DeviceIndex::GetPostingList(Key key, const std::string& value) const {
+    const auto it = postings[key].find(value);
+    return it != postings[key].end() ? &it->second : nullptr;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <sys/types.h>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/DeviceSnapshot.h>
+#include <EventMonitor/StringTable.h>
+
+// Conjunction of exact matches, unset members match every device.
+struct DeviceQuery {
+    std::optional<std::string> subsystem;
+    std::optional<std::string> driver;
+    std::optional<std::string> devtype;
+    // ID_VENDOR_ID, and ID_MODEL_ID which is only used along with the vendor.
+    std::optional<std::string> vendorID;
+    std::optional<std::string> modelID;
+    // Every tag must be present.
+    std::vector<std::string> tags;
+    std::optional<dev_t> devnum;
+};
+
+// Device collection with hash indexes on subsystem, driver, devtype, vendor, vendor and model, tags and devnum.
+//
+// Every index maps a key to the posting list of the devices having it. A query walks the shortest posting list of
+// its constraints and probes the others, so its cost depends on the result size, not on the number of devices.
+// Not thread-safe.
+class DeviceIndex {
+public:
+    using Result = std::vector<std::shared_ptr<const DeviceSnapshot>>;
+
+    explicit DeviceIndex(std::shared_ptr<StringTable> strings = StringTable::GetDefault());
+    ~DeviceIndex() = default;
+    DeviceIndex(const DeviceIndex&) = delete;
+    DeviceIndex(DeviceIndex&&) noexcept = default;
+    DeviceIndex& operator=(const DeviceIndex&) = delete;
+    DeviceIndex& operator=(DeviceIndex&&) noexcept = default;
+
+    // Replace the content of the index with the devices of the enumerator.
+    void Build(const DeviceEnumerator& enumerator);
+    // Add the device, replacing the one with the same syspath.
+    void Insert(const Device& device);
+    // Returns false if no device has this syspath.
+    bool Erase(std::string_view syspath);
+    void Clear();
+
+    // Devices matching every constraint of the query, in no particular order.
+    Result Find(const DeviceQuery& query) const;
+
+    std::size_t GetSize() const { return slots.size(); }
+
+private:
+    using Slot = uint32_t;
+    using PostingList = std::unordered_set<Slot>;
+
+    enum Key : uint8_t {
+        Subsystem,
+        Driver,
+        Devtype,
+        Vendor,
+        VendorModel,
+        Tag,
+        Devnum,
+        KeyCount
+    };
+
+    struct Record {
+        std::shared_ptr<const DeviceSnapshot> snapshot;
+        // What the record is indexed under, to remove it from the posting lists.
+        std::vector<std::pair<Key, std::string>> keys;
+    };
+
+    static std::string MakeVendorModelKey(std::string_view vendorID, std::string_view modelID);
+    static std::string MakeDevnumKey(dev_t devnum);
+
+    void Index(Slot slot, Key key, std::string value);
+    const PostingList* GetPostingList(Key key, const std::string& value) const;
+
+    std::shared_ptr<StringTable> strings;
+    std::vector<Record> records;
+    std::vector<Slot> freeSlots;
+    std::unordered_map<std::string, Slot> slots;
+    std::unordered_map<std::string, PostingList> postings[KeyCount];
+};
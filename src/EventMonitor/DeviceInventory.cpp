@@ -0,0 +1,348 @@
+#include <EventMonitor/DeviceInventory.h>
+#include <EventMonitor/Hash.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+namespace {
+    constexpr uint32_t hasDevnum = 1u;
+    constexpr const char* databaseDirectory = "/run/udev/data/";
+
+    std::string ReadBootId() {
+        std::ifstream file("/proc/sys/kernel/random/boot_id");
+        std::string bootId;
+        std::getline(file, bootId);
+        return bootId;
+    }
+
+    // Name of the udev database file of the device, the way udev derives it.
+    std::string GetDatabaseId(const Device& device) {
+        const auto subsystem = device.GetSubsystemView();
+        if (const auto devnum = device.GetDevnum(); devnum && major(*devnum) > 0) {
+            const char type = (subsystem == std::string_view("block")) ? 'b' : 'c';
+            return type + std::to_string(major(*devnum)) + ":" + std::to_string(minor(*devnum));
+        }
+        if (const auto ifindex = device.GetPropertyView("IFINDEX"); ifindex && *ifindex != "0") {
+            return "n" + std::string(*ifindex);
+        }
+        const auto sysname = device.GetSysnameView();
+        if (!subsystem || !sysname) {
+            return std::string();
+        }
+        return "+" + std::string(*subsystem) + ":" + std::string(*sysname);
+    }
+
+    // Nanoseconds, 0 if the file does not exist.
+    int64_t GetModificationTime(const std::string& path) {
+        struct stat st{};
+        if (stat(path.c_str(), &st) < 0) {
+            return 0;
+        }
+        return static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+    }
+
+    template <typename T>
+    void Append(std::vector<char>& buffer, const T& value) {
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer.insert(buffer.end(), bytes, bytes + sizeof(value));
+    }
+
+    void Append(std::vector<char>& buffer, std::string_view value) {
+        buffer.insert(buffer.end(), value.begin(), value.end());
+    }
+}
+
+// *** Entry ***
+
+DeviceInventory::Entry::Entry(const DeviceInventory& deviceInventory, const InventoryFile::Record& inventoryRecord)
+    : inventory(&deviceInventory),
+      record(&inventoryRecord) {
+}
+
+std::string_view DeviceInventory::Entry::GetSyspath() const {
+    return std::string_view(reinterpret_cast<const char*>(inventory->data + record->offset), record->syspathLength);
+}
+
+std::optional<dev_t> DeviceInventory::Entry::GetDevnum() const {
+    return (record->flags & hasDevnum) ? std::make_optional(static_cast<dev_t>(record->devnum)) : std::nullopt;
+}
+
+std::optional<std::string_view> DeviceInventory::Entry::GetProperty(std::string_view key) const {
+    // Properties are written sorted, a handful per device, a linear scan avoids any index in the file.
+    for (const auto& [propertyKey, value] : GetProperties()) {
+        if (propertyKey == key) {
+            return value;
+        }
+    }
+    return std::nullopt;
+}
+
+std::vector<DeviceProperties::Property> DeviceInventory::Entry::GetProperties() const {
+    const unsigned char* cursor = inventory->data + record->offset + record->syspathLength + record->databaseIdLength;
+    const unsigned char* const end = inventory->data + inventory->size;
+
+    std::vector<DeviceProperties::Property> properties;
+    properties.reserve(record->propertyCount);
+    for (uint32_t i = 0; i < record->propertyCount; ++i) {
+        uint32_t lengths[2];
+        if (static_cast<std::size_t>(end - cursor) < sizeof(lengths)) {
+            throw std::runtime_error("Failed to read inventory : Corrupted record!");
+        }
+        std::memcpy(lengths, cursor, sizeof(lengths));
+        cursor += sizeof(lengths);
+        if (static_cast<std::size_t>(end - cursor) < std::size_t(lengths[0]) + lengths[1]) {
+            throw std::runtime_error("Failed to read inventory : Corrupted record!");
+        }
+        const char* key = reinterpret_cast<const char*>(cursor);
+        properties.emplace_back(std::string_view(key, lengths[0]), std::string_view(key + lengths[0], lengths[1]));
+        cursor += std::size_t(lengths[0]) + lengths[1];
+    }
+    return properties;
+}
+
+Device DeviceInventory::Entry::ToDevice() const {
+    // The vector becomes the index of the properties, saving a copy.
+    return Device::CreateFromProperties(DeviceProperties(GetProperties()));
+}
+
+std::string_view DeviceInventory::Entry::GetDatabaseId() const {
+    return std::string_view(reinterpret_cast<const char*>(inventory->data + record->offset + record->syspathLength), record->databaseIdLength);
+}
+
+// *** DeviceInventory ***
+
+DeviceInventory::DeviceInventory(const std::string& path)
+    : data(nullptr),
+      size(0),
+      header(nullptr),
+      records(nullptr) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open DeviceInventory : Cannot open " + path + " : " + std::strerror(errno) + "!");
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(InventoryFile::Header)) {
+        close(fd);
+        throw std::runtime_error("Failed to open DeviceInventory : " + path + " is not an inventory!");
+    }
+    size = static_cast<std::size_t>(st.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to open DeviceInventory : mmap failed!");
+    }
+    data = static_cast<const unsigned char*>(mapping);
+    header = std::launder(reinterpret_cast<const InventoryFile::Header*>(data));
+    records = std::launder(reinterpret_cast<const InventoryFile::Record*>(data + sizeof(InventoryFile::Header)));
+
+    if (std::memcmp(header->magic, InventoryFile::magic, sizeof(header->magic)) != 0 || header->version != InventoryFile::version) {
+        munmap(mapping, size);
+        throw std::runtime_error("Failed to open DeviceInventory : " + path + " is not a compatible inventory!");
+    }
+    // Payloads are bounds checked once here, properties when read.
+    bool valid = (size - sizeof(InventoryFile::Header)) / sizeof(InventoryFile::Record) >= header->recordCount;
+    for (std::size_t i = 0; valid && i < header->recordCount; ++i) {
+        const InventoryFile::Record& record = records[i];
+        valid = record.offset <= size && size - record.offset >= std::size_t(record.syspathLength) + record.databaseIdLength;
+    }
+    if (!valid) {
+        munmap(mapping, size);
+        throw std::runtime_error("Failed to open DeviceInventory : " + path + " is truncated!");
+    }
+}
+
+DeviceInventory::~DeviceInventory() {
+    munmap(const_cast<unsigned char*>(data), size);
+}
+
+void DeviceInventory::Write(const std::string& path, const std::vector<Device>& devices, uint64_t ueventSeqnum) {
+    struct Pending {
+        InventoryFile::Record record;
+        const Device* device;
+        std::string syspath;
+        std::string databaseId;
+    };
+
+    std::vector<Pending> pending;
+    pending.reserve(devices.size());
+    for (const Device& device : devices) {
+        const auto syspath = device.GetSyspathView();
+        if (!syspath) {
+            continue;
+        }
+        Pending entry{ InventoryFile::Record{}, &device, std::string(*syspath), GetDatabaseId(device) };
+        entry.record.syspathHash = Fnv1aHash(entry.syspath);
+        entry.record.seqnum = device.GetSeqnum().value_or(0);
+        entry.record.usecInitialized = device.GetUsecInitialized().value_or(0);
+        if (const auto devnum = device.GetDevnum()) {
+            entry.record.devnum = static_cast<uint64_t>(*devnum);
+            entry.record.flags |= hasDevnum;
+        }
+        if (!entry.databaseId.empty()) {
+            entry.record.databaseModified = GetModificationTime(databaseDirectory + entry.databaseId);
+        }
+        pending.push_back(std::move(entry));
+    }
+    std::sort(pending.begin(), pending.end(), [](const Pending& lhs, const Pending& rhs) {
+        return std::tie(lhs.record.syspathHash, lhs.syspath) < std::tie(rhs.record.syspathHash, rhs.syspath);
+    });
+    if (pending.size() > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Failed to write inventory : Too many devices!");
+    }
+
+    InventoryFile::Header header{};
+    std::memcpy(header.magic, InventoryFile::magic, sizeof(header.magic));
+    header.version = InventoryFile::version;
+    header.recordCount = static_cast<uint32_t>(pending.size());
+    header.ueventSeqnum = ueventSeqnum;
+    ReadBootId().copy(header.bootId, sizeof(header.bootId) - 1);
+
+    // Payloads first, the record table in front of them is filled in once their offsets are known.
+    std::vector<char> payloads;
+    const std::size_t payloadOffset = sizeof(InventoryFile::Header) + pending.size() * sizeof(InventoryFile::Record);
+    for (Pending& entry : pending) {
+        const DeviceProperties properties = entry.device->GetAllProperties();
+        entry.record.offset = payloadOffset + payloads.size();
+        entry.record.syspathLength = static_cast<uint32_t>(entry.syspath.size());
+        entry.record.databaseIdLength = static_cast<uint32_t>(entry.databaseId.size());
+        entry.record.propertyCount = static_cast<uint32_t>(properties.GetSize());
+        Append(payloads, std::string_view(entry.syspath));
+        Append(payloads, std::string_view(entry.databaseId));
+        for (const auto& [key, value] : properties) {
+            Append(payloads, static_cast<uint32_t>(key.size()));
+            Append(payloads, static_cast<uint32_t>(value.size()));
+            Append(payloads, key);
+            Append(payloads, value);
+        }
+    }
+
+    std::vector<char> buffer;
+    buffer.reserve(payloadOffset + payloads.size());
+    Append(buffer, header);
+    for (const Pending& entry : pending) {
+        Append(buffer, entry.record);
+    }
+    buffer.insert(buffer.end(), payloads.begin(), payloads.end());
+
+    const std::string temporaryPath = path + ".tmp";
+    FILE* file = std::fopen(temporaryPath.c_str(), "w");
+    if (!file) {
+        throw std::runtime_error("Failed to write inventory : Cannot open " + temporaryPath + "!");
+    }
+    const bool written = std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    if (std::fclose(file) != 0 || !written || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Failed to write inventory : Cannot write " + path + "!");
+    }
+}
+
+void DeviceInventory::Write(const std::string& path, const DeviceEnumerator& enumerator) {
+    const uint64_t ueventSeqnum = ReadUeventSeqnum();
+    Write(path, enumerator.GetAllDevices(), ueventSeqnum);
+}
+
+uint64_t DeviceInventory::ReadUeventSeqnum() {
+    std::ifstream file("/sys/kernel/uevent_seqnum");
+    uint64_t seqnum = 0;
+    if (!(file >> seqnum)) {
+        throw std::runtime_error("Failed to read the uevent seqnum!");
+    }
+    return seqnum;
+}
+
+DeviceInventory::Entry DeviceInventory::operator[](std::size_t index) const {
+    return Entry(*this, records[index]);
+}
+
+std::optional<DeviceInventory::Entry> DeviceInventory::Find(std::string_view syspath) const {
+    const uint64_t hash = Fnv1aHash(syspath);
+    const InventoryFile::Record* const end = records + header->recordCount;
+    const InventoryFile::Record* it = std::lower_bound(records, end, hash, [](const InventoryFile::Record& record, uint64_t searched) {
+        return record.syspathHash < searched;
+    });
+    for (; it != end && it->syspathHash == hash; ++it) {
+        Entry entry(*this, *it);
+        if (entry.GetSyspath() == syspath) {
+            return entry;
+        }
+    }
+    return std::nullopt;
+}
+
+bool DeviceInventory::IsSameBoot() const {
+    const std::string bootId = ReadBootId();
+    return !bootId.empty() && std::string_view(header->bootId, strnlen(header->bootId, sizeof(header->bootId))) == bootId;
+}
+
+bool DeviceInventory::IsCurrent() const {
+    return IsSameBoot() && ReadUeventSeqnum() == header->ueventSeqnum;
+}
+
+bool DeviceInventory::IsUnchanged(const Entry& entry) const {
+    // udev rewrites the database file of a device on every event it processes.
+    const std::string databaseId(entry.GetDatabaseId());
+    const int64_t modified = databaseId.empty() ? 0 : GetModificationTime(databaseDirectory + databaseId);
+    if (modified != entry.record->databaseModified) {
+        return false;
+    }
+    // Without a database file, the device can only have gone away.
+    return modified != 0 || access(std::string(entry.GetSyspath()).c_str(), F_OK) == 0;
+}
+
+std::vector<Device> DeviceInventory::Load(const DeviceEnumerator& enumerator, LoadStats* stats) const {
+    LoadStats counts;
+    std::vector<Device> devices;
+
+    if (!IsSameBoot()) {
+        devices = enumerator.GetAllDevices();
+        counts.requeried = devices.size();
+    }
+    else if (IsCurrent() && !enumerator.HasFilters()) {
+        devices.reserve(GetSize());
+        for (std::size_t i = 0; i < GetSize(); ++i) {
+            devices.push_back((*this)[i].ToDevice());
+        }
+        counts.reused = devices.size();
+    }
+    else {
+        std::size_t found = 0;
+        devices.reserve(GetSize());
+        for (const Device& device : enumerator.Borrowed()) {
+            const auto syspath = device.GetSyspathView();
+            if (!syspath) {
+                continue;
+            }
+            const auto entry = Find(*syspath);
+            found += entry ? 1 : 0;
+            if (entry && IsUnchanged(*entry)) {
+                devices.push_back(entry->ToDevice());
+                ++counts.reused;
+            }
+            else {
+                // The borrowed device is released by the next iteration, keep a fresh one.
+                devices.push_back(Device::CreateFromSyspath(std::string(*syspath)));
+                ++counts.requeried;
+            }
+        }
+        // Entries outside of the filters are not gone.
+        counts.removed = enumerator.HasFilters() ? 0 : GetSize() - found;
+    }
+
+    if (stats) {
+        *stats = counts;
+    }
+    return devices;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+
+// On-disk layout of a device inventory, in native byte order since it is only meant to be read back on the writing host.
+//
+// The file starts with an InventoryFile::Header, followed by one InventoryFile::Record per device sorted by syspath
+// hash then syspath, followed by the payloads. A payload is the syspath, the udev database id, then the properties
+// laid out like in an event log (see EventLog) : two uint32_t (key and value lengths) then the characters.
+namespace InventoryFile {
+    constexpr char magic[8] = { 'E', 'V', 'M', 'O', 'N', 'I', 'N', 'V' };
+    constexpr uint32_t version = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordCount;
+        // /sys/kernel/uevent_seqnum before the devices were enumerated.
+        uint64_t ueventSeqnum;
+        // /proc/sys/kernel/random/boot_id, devnums and database timestamps are only meaningful within one boot.
+        char bootId[40];
+    };
+
+    struct Record {
+        // FNV-1a of the syspath.
+        uint64_t syspathHash;
+        uint64_t seqnum;
+        uint64_t usecInitialized;
+        uint64_t devnum;
+        // Modification time of the udev database file of the device in nanoseconds, 0 if it had none.
+        int64_t databaseModified;
+        // From the start of the file.
+        uint64_t offset;
+        uint32_t syspathLength;
+        uint32_t databaseIdLength;
+        uint32_t propertyCount;
+        // Bit 0 : devnum is set.
+        uint32_t flags;
+    };
+}
+
+// Enumerated device set persisted to a memory-mapped file, so a restarting process answers lookups straight from
+// the page cache instead of rescanning sysfs.
+//
+// Write() the inventory, e.g. on shutdown or after seeding, then open it on the next start : Find() is a binary search
+// over the mapped records and Entry reads its properties in place. Load() turns the inventory back into devices,
+// only querying libsystemd for the ones that changed since it was written.
+// Read-only once opened, thread-safe.
+class DeviceInventory {
+public:
+    // View of one device of the inventory, valid as long as the inventory is alive.
+    class Entry {
+    public:
+        std::string_view GetSyspath() const;
+        // Seqnum of the event the device came from, 0 for an enumerated device.
+        uint64_t GetSeqnum() const { return record->seqnum; }
+        // USEC_INITIALIZED, 0 if udev had not initialized the device.
+        uint64_t GetUsecInitialized() const { return record->usecInitialized; }
+        std::optional<dev_t> GetDevnum() const;
+        std::optional<std::string_view> GetProperty(std::string_view key) const;
+        // Views into the mapping.
+        std::vector<DeviceProperties::Property> GetProperties() const;
+        // Detached device holding a copy of the properties.
+        Device ToDevice() const;
+
+    private:
+        friend class DeviceInventory;
+
+        explicit Entry(const DeviceInventory& inventory, const InventoryFile::Record& record);
+
+        std::string_view GetDatabaseId() const;
+
+        const DeviceInventory* inventory;
+        const InventoryFile::Record* record;
+    };
+
+    struct LoadStats {
+        // Devices built from the inventory.
+        std::size_t reused = 0;
+        // Devices new or changed since the inventory was written, queried from libsystemd.
+        std::size_t requeried = 0;
+        // Devices of the inventory gone since it was written, not counted with a filtered enumerator.
+        std::size_t removed = 0;
+    };
+
+    // Map the inventory, which must have a compatible header.
+    explicit DeviceInventory(const std::string& path);
+    ~DeviceInventory();
+    DeviceInventory(const DeviceInventory&) = delete;
+    DeviceInventory(DeviceInventory&&) = delete;
+    DeviceInventory& operator=(const DeviceInventory&) = delete;
+    DeviceInventory& operator=(DeviceInventory&&) = delete;
+
+    // Write the devices to path, replacing the previous inventory atomically.
+    // ueventSeqnum must have been read before the devices were enumerated, so no event falls between the two.
+    static void Write(const std::string& path, const std::vector<Device>& devices, uint64_t ueventSeqnum);
+    // Enumerate the devices and write them.
+    static void Write(const std::string& path, const DeviceEnumerator& enumerator);
+    // Seqnum of the last uevent emitted by the kernel.
+    static uint64_t ReadUeventSeqnum();
+
+    std::size_t GetSize() const { return header->recordCount; }
+    Entry operator[](std::size_t index) const;
+    std::optional<Entry> Find(std::string_view syspath) const;
+
+    // Written during the current boot.
+    bool IsSameBoot() const;
+    // No uevent was emitted since the inventory was written, so every entry still describes the system.
+    bool IsCurrent() const;
+    // Cheap check of a single device, a stat() of its udev database file (or of its syspath when it had none).
+    bool IsUnchanged(const Entry& entry) const;
+
+    // Devices of the enumerator, built from the inventory when unchanged and queried otherwise.
+    // A current inventory is trusted as is, without enumerating, unless the enumerator has filters : the inventory
+    // does not record them, so the enumerator still selects the devices. Another boot's inventory is ignored entirely.
+    std::vector<Device> Load(const DeviceEnumerator& enumerator, LoadStats* stats = nullptr) const;
+
+private:
+    const unsigned char* data;
+    std::size_t size;
+    const InventoryFile::Header* header;
+    const InventoryFile::Record* records;
+};
@@ -1,6 +1,42 @@
 #include <stdexcept>
-#include <iostream>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <fnmatch.h>
+#include <sys/stat.h>
 #include <EventMonitor/DeviceMonitor.h>
+#include <EventMonitor/DeviceEnumerator.h>
+
+namespace {
+    // Missing seqnums tracked at most, older ones are counted as missed right away.
+    constexpr std::size_t maxMissingSeqnums = 4096;
+
+    // Drops of a netlink socket, from the "Drops" column of /proc/net/netlink.
+    std::optional<uint64_t> ReadNetlinkDrops(int fd) {
+        struct stat status {};
+        if (fd < 0 || fstat(fd, &status) < 0) {
+            return std::nullopt;
+        }
+
+        std::ifstream file("/proc/net/netlink");
+        std::string line;
+        std::getline(file, line); // Header.
+        while (std::getline(file, line)) {
+            // sk Eth Pid Groups Rmem Wmem Dump Locks Drops Inode
+            std::istringstream fields(line);
+            std::string skip;
+            uint64_t drops = 0;
+            uint64_t inode = 0;
+            for (int i = 0; i < 8; ++i) {
+                fields >> skip;
+            }
+            if (fields >> drops >> inode && inode == status.st_ino) {
+                return drops;
+            }
+        }
+        return std::nullopt;
+    }
+}
 
 // *** Public ***
 
@@ -8,7 +44,22 @@ DeviceMonitor::DeviceMonitor()
     : isMonitoring(false),
       deviceMonitor(nullptr, &sd_device_monitor_unref),
       eventLoop(nullptr),
-      userCallback(nullptr) {
+      userCallback(nullptr),
+      waiters(std::make_unique<WaiterList>()),
+      hasMonitorFilters(false),
+      overflowStats{},
+      dropCheckInterval(0),
+      dropCheckCount(0),
+      lastSeqnum(0),
+      lastSocketDrops(0),
+      lastQueueDrops(0),
+      coalesceWindow(0),
+      coalesceStats{},
+      batchCallback(nullptr),
+      maxBatchSize(0),
+      maxBatchDelay(0),
+      handoffSource(nullptr, &sd_event_source_unref),
+      droppedCount(0) {
     // Reference a new sd_device_monitor instance.
     sd_device_monitor* monitorTemp = nullptr;
     if (sd_device_monitor_new(&monitorTemp) < 0 || !monitorTemp) {
@@ -19,16 +70,283 @@ DeviceMonitor::DeviceMonitor()
 
 DeviceMonitor::DeviceMonitor(std::shared_ptr<Event> event)
     : DeviceMonitor() { 
-    std::cout << "Building DeviceMonitor..." << std::endl; // TODO : REMOVE
     AttachToEvent(std::move(event));
 }
 
+DeviceMonitor::~DeviceMonitor() {
+    CancelWaiters();
+}
+
 void DeviceMonitor::SetCallback(const DeviceEventCallback callback) {
     if (!callback) {
         throw std::invalid_argument("Failed to set callback : Callback cannot be null!");
     }
+    if (dispatchQueue || executor) {
+        throw std::runtime_error("Failed to set callback : Queued or executor dispatch is enabled!");
+    }
     userCallback = std::move(callback);
-    std::cout << "Callback set!" << std::endl; // TODO : REMOVE
+
+    // Leave batched mode, handing over what was already buffered.
+    if (batchCallback) {
+        FlushBatch();
+        batchCallback = nullptr;
+        batchTimer.reset();
+    }
+}
+
+void DeviceMonitor::SetBatchCallback(const DeviceBatchCallback callback, std::size_t batchSize, std::chrono::microseconds batchDelay) {
+    if (!callback) {
+        throw std::invalid_argument("Failed to set batch callback : Callback cannot be null!");
+    }
+    if (batchSize == 0) {
+        throw std::invalid_argument("Failed to set batch callback : Batch size cannot be 0!");
+    }
+    if (batchDelay.count() < 0) {
+        throw std::invalid_argument("Failed to set batch callback : Batch delay cannot be negative!");
+    }
+    if (dispatchQueue || executor) {
+        throw std::runtime_error("Failed to set batch callback : Queued or executor dispatch is enabled!");
+    }
+
+    FlushBatch();
+    batchTimer.reset();
+
+    batchCallback = std::move(callback);
+    maxBatchSize = batchSize;
+    maxBatchDelay = batchDelay;
+    batch.reserve(maxBatchSize);
+    userCallback = nullptr;
+}
+
+void DeviceMonitor::FlushBatch() {
+    if (batchTimer) {
+        batchTimer->Disarm();
+    }
+    if (batch.empty() || !batchCallback) {
+        return;
+    }
+
+    // Swap in a fresh buffer first so the callback can take ownership of the devices.
+    std::vector<Device> devices;
+    devices.reserve(maxBatchSize);
+    devices.swap(batch);
+
+    metrics.dispatched.Add(devices.size());
+    if (!latencyTracker && !metrics.callbackDuration) {
+        batchCallback(*this, std::move(devices));
+        return;
+    }
+    if (!latencyTracker) {
+        const uint64_t entered = LatencyTracker::Now();
+        batchCallback(*this, std::move(devices));
+        metrics.callbackDuration->Record(LatencyTracker::Now() - entered);
+        return;
+    }
+
+    struct Timing {
+        LatencyTracker::Series* series;
+        uint64_t initialized;
+        uint64_t received;
+    };
+    std::vector<Timing> timings;
+    timings.reserve(devices.size());
+    for (const Device& device : devices) {
+        const auto action = device.GetAction();
+        timings.push_back({
+            &latencyTracker->GetSeries(device.GetSubsystemView().value_or(std::string_view()), action),
+            action == SD_DEVICE_ADD ? device.GetUsecInitialized().value_or(0) * 1000 : 0,
+            device.GetReceiveTime()
+        });
+    }
+
+    const uint64_t entered = LatencyTracker::Now();
+    batchCallback(*this, std::move(devices));
+    const uint64_t returned = LatencyTracker::Now();
+    for (const Timing& timing : timings) {
+        latencyTracker->Record(*timing.series, timing.initialized, timing.received, entered, returned);
+    }
+    if (metrics.callbackDuration) {
+        metrics.callbackDuration->Record(returned - entered);
+    }
+}
+
+void DeviceMonitor::EnableQueuedDispatch(std::size_t queueCapacity, std::size_t consumerCount, const std::vector<int>& cpuAffinity,
+                                         OverflowPolicy policy) {
+    if (!userCallback) {
+        throw std::runtime_error("Failed to enable queued dispatch : Callback is not set!");
+    }
+
+    DisableQueuedDispatch();
+    DisableExecutorDispatch();
+
+    // Staging never reallocates on the hot path, see Dispatch.
+    stagedDevices.reserve(maxStagedDevices);
+
+    dispatchQueue = std::make_unique<DispatchQueue>(
+        queueCapacity,
+        consumerCount,
+        [this, callback = userCallback, tracker = latencyTracker, metrics = metrics](Device device) {
+            InvokeCallback(callback, tracker.get(), metrics, std::move(device));
+        },
+        cpuAffinity,
+        policy);
+}
+
+void DeviceMonitor::DisableQueuedDispatch() {
+    if (!dispatchQueue) {
+        return;
+    }
+
+    PublishStagedDevices();
+    handoffSource.reset();
+
+    dispatchQueue->Stop();
+    droppedCount += dispatchQueue->GetDroppedCount();
+    dispatchQueue.reset();
+}
+
+void DeviceMonitor::EnableExecutorDispatch(std::size_t threadCount, DeviceExecutor::KeyFunction keyFunction,
+                                           std::size_t shardCount, const std::vector<int>& cpuAffinity) {
+    if (!userCallback) {
+        throw std::runtime_error("Failed to enable executor dispatch : Callback is not set!");
+    }
+
+    DisableQueuedDispatch();
+    DisableExecutorDispatch();
+
+    stagedDevices.reserve(maxStagedDevices);
+
+    executor = std::make_unique<DeviceExecutor>(
+        [this, callback = userCallback, tracker = latencyTracker, metrics = metrics](Device device) {
+            InvokeCallback(callback, tracker.get(), metrics, std::move(device));
+        },
+        threadCount,
+        std::move(keyFunction),
+        shardCount,
+        cpuAffinity);
+}
+
+void DeviceMonitor::DisableExecutorDispatch() {
+    if (!executor) {
+        return;
+    }
+
+    PublishStagedDevices();
+    handoffSource.reset();
+
+    executor->Wait();
+    executor.reset();
+}
+
+DeviceExecutor::Stats DeviceMonitor::GetExecutorStats() const {
+    if (!executor) {
+        throw std::runtime_error("Failed to get executor stats : Executor dispatch is not enabled!");
+    }
+    return executor->GetStats();
+}
+
+void DeviceMonitor::EnableCoalescing(std::chrono::microseconds window) {
+    if (!eventLoop) {
+        throw std::runtime_error("Failed to enable coalescing : Event ptr is null!");
+    }
+    if (window.count() <= 0) {
+        throw std::invalid_argument("Failed to enable coalescing : Window must be positive!");
+    }
+
+    FlushCoalesced();
+    coalesceWindow = window;
+    if (!coalesceTimer) {
+        coalesceTimer = std::make_unique<EventTimer>(eventLoop, [this]() { OnCoalesceWindow(); });
+    }
+}
+
+void DeviceMonitor::DisableCoalescing() {
+    FlushCoalesced();
+    coalesceTimer.reset();
+}
+
+void DeviceMonitor::FlushCoalesced() {
+    if (coalesceTimer) {
+        coalesceTimer->Disarm();
+    }
+    // Emitting may reenter through the callback, detach the pending events first.
+    auto order = std::move(pendingOrder);
+    pendingOrder.clear();
+    for (const auto& [deadline, syspath] : order) {
+        auto it = pendingDevices.find(syspath);
+        if (it != pendingDevices.end() && it->second.deadline == deadline) {
+            EmitCoalesced(syspath);
+        }
+    }
+}
+
+DispatchQueue::Stats DeviceMonitor::GetQueueStats() const {
+    if (!dispatchQueue) {
+        throw std::runtime_error("Failed to get queue stats : Queued dispatch is not enabled!");
+    }
+    return dispatchQueue->GetStats();
+}
+
+void DeviceMonitor::SetReceiveBufferSize(std::size_t size) {
+    if (size == 0) {
+        throw std::invalid_argument("Failed to set receive buffer size : Size cannot be 0!");
+    }
+    if (sd_device_monitor_set_receive_buffer_size(deviceMonitor.get(), size) < 0) {
+        throw std::runtime_error("Failed to set receive buffer size : sd_device_monitor_set_receive_buffer_size failed!");
+    }
+}
+
+void DeviceMonitor::EnableOverflowDetection(std::chrono::microseconds interval) {
+    if (!eventLoop) {
+        throw std::runtime_error("Failed to enable overflow detection : Event ptr is null!");
+    }
+    if (interval.count() <= 0) {
+        throw std::invalid_argument("Failed to enable overflow detection : Interval must be positive!");
+    }
+
+    dropCheckInterval = interval;
+    lastSeqnum = 0;
+    missingSeqnums.clear();
+    lastQueueDrops = GetDroppedCount();
+    lastSocketDrops = 0;
+    if (sd_event_source* source = sd_device_monitor_get_event_source(deviceMonitor.get())) {
+        lastSocketDrops = ReadNetlinkDrops(sd_event_source_get_io_fd(source)).value_or(0);
+    }
+
+    if (!dropCheckTimer) {
+        dropCheckTimer = std::make_unique<EventTimer>(eventLoop, [this]() { CheckDrops(); });
+    }
+    dropCheckTimer->Arm(dropCheckInterval);
+}
+
+void DeviceMonitor::DisableOverflowDetection() {
+    dropCheckTimer.reset();
+    missingSeqnums.clear();
+}
+
+void DeviceMonitor::SetMetrics(std::shared_ptr<MetricsRegistry> registry, const MetricsRegistry::Labels& labels) {
+    if (!registry) {
+        metrics = Metrics();
+        return;
+    }
+
+    Metrics updated;
+    updated.received = registry->AddCounter("eventmonitor_events_received_total", "Events received, before property matches.", labels);
+    updated.filtered = registry->AddCounter("eventmonitor_events_filtered_total", "Events rejected by property matches.", labels);
+    updated.dispatched = registry->AddCounter("eventmonitor_events_dispatched_total", "Events handed to the callback.", labels);
+    updated.dropped = registry->AddCounter("eventmonitor_events_dropped_total", "Events dropped by the dispatch queue.", labels);
+    updated.coalesced = registry->AddCounter("eventmonitor_events_coalesced_total", "Events merged into or cancelled by a later event of the same device.", labels);
+    updated.queueDepth = registry->AddGauge("eventmonitor_queue_depth", "Devices waiting in the dispatch queue, sampled on push.", labels);
+    updated.callbackDuration = &registry->AddSummary("eventmonitor_callback_duration_seconds", "Time spent in the callback.", labels);
+    updated.registry = std::move(registry);
+    metrics = std::move(updated);
+}
+
+void DeviceMonitor::SetResyncCallback(ResyncCallback callback) {
+    resyncCallback = std::move(callback);
+    if (!resyncCallback) {
+        resyncTimer.reset();
+    }
 }
 
 void DeviceMonitor::AttachToEvent(std::shared_ptr<Event> event) {
@@ -46,12 +364,20 @@ void DeviceMonitor::AttachToEvent(std::shared_ptr<Event> event) {
     if (sd_device_monitor_attach_event(deviceMonitor.get(), eventLoop.get()->GetEvent()) < 0) {
         throw std::runtime_error("Failed to attach DeviceMonitor to event loop : sd_device_monitor_attach_event failed!");
     }
-    std::cout << "Attached to event!" << std::endl; // TODO : REMOVE
 }
 
 void DeviceMonitor::DetachFromEvent() {
     // TODO : Write warning in else when calling this on !eventLoop ?
     if (eventLoop) {
+        // The timers and handoff source live on the event loop we are leaving.
+        DisableCoalescing();
+        FlushBatch();
+        batchTimer.reset();
+        PublishStagedDevices();
+        handoffSource.reset();
+        DisableOverflowDetection();
+        resyncTimer.reset();
+
         if (sd_device_monitor_detach_event(deviceMonitor.get()) < 0) {
             throw std::runtime_error("Failed to detach DeviceMonitor from event loop : sd_device_monitor_detach_event failed!");
         }
@@ -60,7 +386,6 @@ void DeviceMonitor::DetachFromEvent() {
 }
 
 void DeviceMonitor::StartMonitoring() {
-    std::cout << "Trying to start monitoring..." << std::endl; // TODO : REMOVE
     if (isMonitoring) {
         // TODO : log warning (already monitoring...) and return?
         throw std::runtime_error("Failed to start monitoring : Already monitoring!");
@@ -70,7 +395,7 @@ void DeviceMonitor::StartMonitoring() {
     if (!eventLoop) {
         throw std::runtime_error("Failed to start monitoring : Event ptr is null!");
     }
-    if (!userCallback) {
+    if (!userCallback && !batchCallback && !HasWaiters()) {
         throw std::runtime_error("Failed to start monitoring : Callback is not set!");
     }
 
@@ -79,15 +404,35 @@ void DeviceMonitor::StartMonitoring() {
         deviceMonitor.get(), 
         [](sd_device_monitor* monitor, sd_device* device, void* userdata) -> int {
             (void) monitor; // Unused.
-            std::cout << "Callback being called..." << std::endl; // TODO : REMOVE
 
             auto* self = static_cast<DeviceMonitor*>(userdata);
             if (!self) {
                 return -1;
             }
 
-            self->userCallback(*self, Device(device));
-            std::cout << "Callback has been triggered.." << std::endl; // TODO : REMOVE
+            if (self->dropCheckTimer) {
+                self->CheckSeqnum(device);
+            }
+
+            self->metrics.received.Add();
+            if (!self->propertyMatches.empty() && !self->MatchesProperties(device)) {
+                self->metrics.filtered.Add();
+                return 0;
+            }
+
+            // The device is released by sd_device_monitor once we return, take our own reference.
+            Device received(sd_device_ref(device));
+            received.receiveTime = LatencyTracker::Now();
+            if (self->recorder) {
+                self->recorder->Record(received);
+            }
+            self->ResumeWaiters(received);
+            if (self->coalesceTimer) {
+                self->Coalesce(std::move(received));
+            }
+            else if (self->userCallback || self->batchCallback) {
+                self->Dispatch(std::move(received));
+            }
 
             return 0;
         },
@@ -100,7 +445,6 @@ void DeviceMonitor::StartMonitoring() {
 
     isMonitoring = true;
 
-    std::cout << "Monitoring started!" << std::endl; // TODO : REMOVE
 }
 
 void DeviceMonitor::StopMonitoring() {
@@ -115,4 +459,538 @@ void DeviceMonitor::StopMonitoring() {
     }
 
     isMonitoring = false;
-}
\ No newline at end of file
+
+    // Nothing else will be received, hand over what is left.
+    FlushCoalesced();
+    FlushBatch();
+    PublishStagedDevices();
+}
+
+void DeviceMonitor::Inject(Device device) {
+    if (!userCallback && !batchCallback) {
+        if (!HasWaiters()) {
+            throw std::runtime_error("Failed to inject device : Callback is not set!");
+        }
+        ResumeWaiters(device);
+        return;
+    }
+    if (device.receiveTime == 0) {
+        device.receiveTime = LatencyTracker::Now();
+    }
+    metrics.received.Add();
+    ResumeWaiters(device);
+    if (coalesceTimer) {
+        Coalesce(std::move(device));
+        return;
+    }
+
+    // No libsystemd reference to hand off, skip the staging.
+    if (device.IsDetached() && (dispatchQueue || executor)) {
+        HandOff(std::move(device));
+        return;
+    }
+    else if ((dispatchQueue || executor) && !eventLoop) {
+        throw std::runtime_error("Failed to inject device : Event ptr is null!");
+    }
+
+    Dispatch(std::move(device));
+}
+
+DeviceMonitor::Awaiter DeviceMonitor::WaitFor(DeviceFilter predicate, std::chrono::microseconds timeout) {
+    if (timeout.count() <= 0) {
+        throw std::invalid_argument("Failed to wait for device : Timeout must be positive!");
+    }
+    return Awaiter(*this, std::move(predicate), timeout);
+}
+
+std::size_t DeviceMonitor::GetWaiterCount() const {
+    std::size_t count = 0;
+    for (const Awaiter* waiter = waiters ? waiters->first : nullptr; waiter; waiter = waiter->next) {
+        ++count;
+    }
+    return count;
+}
+
+void DeviceMonitor::AddMatchSubsystemDevtype(const std::string& subsystem, const std::string& devtype) {
+    if (sd_device_monitor_filter_add_match_subsystem_devtype(deviceMonitor.get(), subsystem.c_str(), devtype.empty() ? nullptr : devtype.c_str()) < 0) {
+        throw std::runtime_error("Failed to add subsystem/devtype match!");
+    }
+    hasMonitorFilters = true;
+    UpdateFilter();
+}
+
+void DeviceMonitor::AddMatchTag(const std::string& tag) {
+    if (sd_device_monitor_filter_add_match_tag(deviceMonitor.get(), tag.c_str()) < 0) {
+        throw std::runtime_error("Failed to add tag match!");
+    }
+    hasMonitorFilters = true;
+    UpdateFilter();
+}
+
+void DeviceMonitor::AddMatchSysattr(const std::string& sysattr, const std::string& value, bool matchSysattr) {
+    if (sd_device_monitor_filter_add_match_sysattr(deviceMonitor.get(), sysattr.c_str(), value.c_str(), matchSysattr) < 0) {
+        throw std::runtime_error("Failed to add sysattr match!");
+    }
+    hasMonitorFilters = true;
+}
+
+void DeviceMonitor::AddMatchProperty(const std::string& property, const std::string& value) {
+    if (property.empty()) {
+        throw std::invalid_argument("Failed to add property match : Property cannot be empty!");
+    }
+    propertyMatches.emplace_back(property, value);
+}
+
+void DeviceMonitor::AddMatchParent(const Device& parent, bool matchParent) {
+    if (!parent.device) {
+        throw std::invalid_argument("Failed to add parent match : Parent device is invalid!");
+    }
+    if (sd_device_monitor_filter_add_match_parent(deviceMonitor.get(), parent.device.get(), matchParent) < 0) {
+        throw std::runtime_error("Failed to add parent match!");
+    }
+    hasMonitorFilters = true;
+}
+
+void DeviceMonitor::ResetFilters() {
+    if (sd_device_monitor_filter_remove(deviceMonitor.get()) < 0) {
+        throw std::runtime_error("Failed to reset DeviceMonitor filters!");
+    }
+    propertyMatches.clear();
+    hasMonitorFilters = false;
+    // Gaps seen so far were made by the filters.
+    missingSeqnums.clear();
+    lastSeqnum = 0;
+}
+
+// *** Private ***
+
+bool DeviceMonitor::MatchesProperties(sd_device* device) const {
+    for (const auto& [property, pattern] : propertyMatches) {
+        const char* value = nullptr;
+        if (sd_device_get_property_value(device, property.c_str(), &value) >= 0 && value && fnmatch(pattern.c_str(), value, 0) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DeviceMonitor::UpdateFilter() {
+    if (isMonitoring && sd_device_monitor_filter_update(deviceMonitor.get()) < 0) {
+        throw std::runtime_error("Failed to update DeviceMonitor filter : sd_device_monitor_filter_update failed!");
+    }
+}
+
+void DeviceMonitor::Coalesce(Device device) {
+    const auto action = device.GetAction().value_or(SD_DEVICE_CHANGE);
+    const auto syspathView = device.GetSyspathView();
+    if (!syspathView || action == SD_DEVICE_MOVE) {
+        if (action == SD_DEVICE_MOVE) {
+            if (const auto oldDevpath = device.GetPropertyView("DEVPATH_OLD")) {
+                EmitCoalesced("/sys" + std::string(*oldDevpath));
+            }
+            if (syspathView) {
+                EmitCoalesced(std::string(*syspathView));
+            }
+        }
+        if (userCallback || batchCallback) {
+            Dispatch(std::move(device));
+        }
+        return;
+    }
+
+    std::string syspath(*syspathView);
+    auto it = pendingDevices.find(syspath);
+    if (it != pendingDevices.end()) {
+        ++coalesceStats.merged;
+        metrics.coalesced.Add();
+        ++it->second.eventCount;
+        it->second.device = std::move(device);
+        return;
+    }
+
+    uint64_t now = 0;
+    if (sd_event_now(eventLoop->GetEvent(), CLOCK_MONOTONIC, &now) < 0) {
+        throw std::runtime_error("Failed to coalesce device : sd_event_now failed!");
+    }
+    const uint64_t deadline = now + static_cast<uint64_t>(coalesceWindow.count());
+    pendingOrder.emplace_back(deadline, syspath);
+    pendingDevices.emplace(std::move(syspath), PendingDevice{ std::move(device), action, 1, deadline });
+    if (pendingOrder.size() == 1) {
+        coalesceTimer->Arm(coalesceWindow);
+    }
+}
+
+void DeviceMonitor::EmitCoalesced(const std::string& syspath) {
+    auto node = pendingDevices.extract(syspath);
+    if (node.empty()) {
+        return;
+    }
+
+    PendingDevice& pending = node.mapped();
+    const auto lastAction = pending.device.GetAction().value_or(SD_DEVICE_CHANGE);
+    if (pending.firstAction == SD_DEVICE_ADD) {
+        if (lastAction == SD_DEVICE_REMOVE) {
+            // Came and went within the window.
+            coalesceStats.merged -= pending.eventCount - 1;
+            coalesceStats.suppressed += pending.eventCount;
+            // The add was not counted when merging the next event.
+            metrics.coalesced.Add();
+            return;
+        }
+        // Still new to the user, with its final state.
+        pending.device.netAction = SD_DEVICE_ADD;
+    }
+
+    ++coalesceStats.emitted;
+    if (userCallback || batchCallback) {
+        Dispatch(std::move(pending.device));
+    }
+}
+
+void DeviceMonitor::OnCoalesceWindow() {
+    uint64_t now = 0;
+    if (sd_event_now(eventLoop->GetEvent(), CLOCK_MONOTONIC, &now) < 0) {
+        throw std::runtime_error("Failed to coalesce device : sd_event_now failed!");
+    }
+
+    while (!pendingOrder.empty() && pendingOrder.front().first <= now) {
+        const auto [deadline, syspath] = std::move(pendingOrder.front());
+        pendingOrder.pop_front();
+        auto it = pendingDevices.find(syspath);
+        if (it != pendingDevices.end() && it->second.deadline == deadline) {
+            EmitCoalesced(syspath);
+        }
+    }
+
+    if (!pendingOrder.empty() && coalesceTimer) {
+        coalesceTimer->Arm(std::chrono::microseconds(pendingOrder.front().first - now));
+    }
+}
+
+void DeviceMonitor::InvokeCallback(const DeviceEventCallback& callback, LatencyTracker* tracker, const Metrics& callbackMetrics, Device device) const {
+    callbackMetrics.dispatched.Add();
+    if (!tracker && !callbackMetrics.callbackDuration) {
+        callback(*this, std::move(device));
+        return;
+    }
+
+    // Read before the device is handed over.
+    LatencyTracker::Series* series = nullptr;
+    uint64_t initialized = 0;
+    const uint64_t received = device.GetReceiveTime();
+    if (tracker) {
+        const auto action = device.GetAction();
+        series = &tracker->GetSeries(device.GetSubsystemView().value_or(std::string_view()), action);
+        initialized = action == SD_DEVICE_ADD ? device.GetUsecInitialized().value_or(0) * 1000 : 0;
+    }
+
+    const uint64_t entered = LatencyTracker::Now();
+    callback(*this, std::move(device));
+    const uint64_t returned = LatencyTracker::Now();
+    if (series) {
+        tracker->Record(*series, initialized, received, entered, returned);
+    }
+    if (callbackMetrics.callbackDuration) {
+        callbackMetrics.callbackDuration->Record(returned - entered);
+    }
+}
+
+void DeviceMonitor::HandOff(Device device) {
+    if (executor) {
+        executor->Submit(std::move(device));
+        return;
+    }
+    if (!dispatchQueue) {
+        return;
+    }
+    if (!metrics.registry) {
+        dispatchQueue->Push(std::move(device));
+        return;
+    }
+
+    // Only this thread pushes, the differences are what this push dropped or coalesced.
+    const auto before = dispatchQueue->GetStats();
+    dispatchQueue->Push(std::move(device));
+    const auto after = dispatchQueue->GetStats();
+    metrics.dropped.Add((after.droppedNewest - before.droppedNewest) + (after.droppedOldest - before.droppedOldest));
+    metrics.coalesced.Add(after.coalesced - before.coalesced);
+    metrics.queueDepth.Set(static_cast<int64_t>(dispatchQueue->GetDepth()));
+}
+
+void DeviceMonitor::Dispatch(Device device) {
+    if (dispatchQueue || executor) {
+        if (!handoffSource) {
+            sd_event_source* sourceTemp = nullptr;
+            if (sd_event_add_post(eventLoop->GetEvent(), &sourceTemp, &DeviceMonitor::OnHandoff, this) < 0 || !sourceTemp) {
+                throw std::runtime_error("Failed to dispatch device : sd_event_add_post failed!");
+            }
+            handoffSource.reset(sourceTemp);
+        }
+        // Rather than growing, hand over the devices staged by the previous handlers, which released them already.
+        if (stagedDevices.size() >= maxStagedDevices) {
+            PublishStagedDevices();
+        }
+        stagedDevices.push_back(std::move(device));
+        return;
+    }
+
+    if (!batchCallback) {
+        InvokeCallback(userCallback, latencyTracker.get(), metrics, std::move(device));
+        return;
+    }
+
+    batch.push_back(std::move(device));
+
+    if (batch.size() >= maxBatchSize) {
+        FlushBatch();
+    }
+    else if (batch.size() == 1 && maxBatchDelay.count() > 0) {
+        if (!batchTimer) {
+            batchTimer = std::make_unique<EventTimer>(eventLoop, [this]() { FlushBatch(); });
+        }
+        batchTimer->Arm(maxBatchDelay);
+    }
+}
+
+void DeviceMonitor::PublishStagedDevices() {
+    for (auto& device : stagedDevices) {
+        HandOff(std::move(device));
+    }
+    stagedDevices.clear();
+}
+
+int DeviceMonitor::OnHandoff(sd_event_source* source, void* userdata) {
+    (void) source; // Unused.
+
+    auto* self = static_cast<DeviceMonitor*>(userdata);
+    if (!self) {
+        return -1;
+    }
+
+    self->PublishStagedDevices();
+
+    return 0;
+}
+
+void DeviceMonitor::ResumeWaiters(const Device& device) {
+    if (!HasWaiters()) {
+        return;
+    }
+
+    // Unlink the matching waiters before resuming any, a resumed coroutine awaiting again waits for the next device.
+    Awaiter* ready = nullptr;
+    Awaiter* lastReady = nullptr;
+    for (Awaiter* waiter = waiters->first; waiter;) {
+        Awaiter* next = waiter->next;
+        if (!waiter->filter || waiter->filter(device)) {
+            waiter->Unlink();
+            (lastReady ? lastReady->next : ready) = waiter;
+            lastReady = waiter;
+        }
+        waiter = next;
+    }
+
+    while (ready) {
+        Awaiter* waiter = ready;
+        ready = waiter->next;
+        waiter->next = nullptr;
+        // Share the device, every waiter owns its own reference.
+        if (device.IsDetached()) {
+            waiter->result.emplace(Device::CreateFromProperties(*device.properties));
+        }
+        else {
+            waiter->result.emplace(Device(sd_device_ref(device.device.get())));
+        }
+        waiter->result->netAction = device.netAction;
+        waiter->resume(waiter->resumeAddress);
+    }
+}
+
+void DeviceMonitor::CancelWaiters() {
+    if (waiters) {
+        waiters->Cancel();
+    }
+}
+
+void DeviceMonitor::CheckSeqnum(sd_device* device) {
+    uint64_t seqnum = 0;
+    if (hasMonitorFilters || sd_device_get_seqnum(device, &seqnum) < 0 || seqnum == 0) {
+        return;
+    }
+
+    if (seqnum <= lastSeqnum) {
+        // Late, fills a gap.
+        missingSeqnums.erase(seqnum);
+        return;
+    }
+    uint64_t missed = 0;
+    if (lastSeqnum != 0) {
+        // Only the most recent seqnums of a large gap are tracked, the older ones are counted as missed right away.
+        uint64_t first = lastSeqnum + 1;
+        if (seqnum - first > maxMissingSeqnums) {
+            missed = seqnum - first - maxMissingSeqnums;
+            first += missed;
+        }
+        for (uint64_t missing = first; missing < seqnum; ++missing) {
+            missingSeqnums.emplace_hint(missingSeqnums.end(), missing, dropCheckCount);
+        }
+    }
+    lastSeqnum = seqnum;
+
+    if (missingSeqnums.size() > maxMissingSeqnums) {
+        const std::size_t excess = missingSeqnums.size() - maxMissingSeqnums;
+        missingSeqnums.erase(missingSeqnums.begin(), std::next(missingSeqnums.begin(), static_cast<std::ptrdiff_t>(excess)));
+        missed += excess;
+    }
+    if (missed > 0) {
+        overflowStats.missedSeqnums += missed;
+        OnOverflow();
+    }
+}
+
+void DeviceMonitor::CheckDrops() {
+    bool overflowed = false;
+
+    // Seqnums missing since before the previous check are not coming anymore.
+    uint64_t missed = 0;
+    for (auto it = missingSeqnums.begin(); it != missingSeqnums.end();) {
+        if (it->second < dropCheckCount) {
+            it = missingSeqnums.erase(it);
+            ++missed;
+        }
+        else {
+            ++it;
+        }
+    }
+    if (missed > 0) {
+        overflowStats.missedSeqnums += missed;
+        overflowed = true;
+    }
+    ++dropCheckCount;
+
+    if (sd_event_source* source = sd_device_monitor_get_event_source(deviceMonitor.get())) {
+        const auto drops = ReadNetlinkDrops(sd_event_source_get_io_fd(source));
+        if (drops && *drops > lastSocketDrops) {
+            overflowStats.socketDrops += *drops - lastSocketDrops;
+            overflowed = true;
+        }
+        if (drops) {
+            lastSocketDrops = *drops;
+        }
+    }
+
+    const uint64_t queueDrops = GetDroppedCount();
+    if (queueDrops > lastQueueDrops) {
+        overflowStats.queueDrops += queueDrops - lastQueueDrops;
+        overflowed = true;
+    }
+    lastQueueDrops = queueDrops;
+
+    if (overflowed) {
+        OnOverflow();
+    }
+    dropCheckTimer->Arm(dropCheckInterval);
+}
+
+void DeviceMonitor::OnOverflow() {
+    ++overflowStats.overflowCount;
+    if (!resyncCallback || !eventLoop) {
+        return;
+    }
+
+    // Out of the current dispatch, and only once however many overflows are seen until then.
+    if (!resyncTimer) {
+        resyncTimer = std::make_unique<EventTimer>(eventLoop, [this]() {
+            DeviceEnumerator enumerator;
+            ++overflowStats.resyncCount;
+            resyncCallback(*this, enumerator);
+        });
+    }
+    if (!resyncTimer->IsArmed()) {
+        resyncTimer->Arm(std::chrono::microseconds(0));
+    }
+}
+
+// *** Awaiter ***
+
+DeviceMonitor::Awaiter::Awaiter(DeviceMonitor& deviceMonitor, DeviceFilter deviceFilter, std::chrono::microseconds waitTimeout)
+    : monitor(&deviceMonitor),
+      list(nullptr),
+      filter(std::move(deviceFilter)),
+      timeout(waitTimeout),
+      timeoutSource(nullptr, &sd_event_source_unref),
+      resumeAddress(nullptr),
+      resume(nullptr),
+      previous(nullptr),
+      next(nullptr),
+      isLinked(false) {
+}
+
+DeviceMonitor::Awaiter::~Awaiter() {
+    // The awaiting coroutine was destroyed while suspended.
+    Unlink();
+}
+
+void DeviceMonitor::Awaiter::Suspend() {
+    if (timeout.count() > 0) {
+        if (!monitor->eventLoop) {
+            throw std::runtime_error("Failed to wait for device : Event ptr is null!");
+        }
+        sd_event_source* sourceTemp = nullptr;
+        if (sd_event_add_time_relative(monitor->eventLoop->GetEvent(), &sourceTemp, CLOCK_MONOTONIC,
+                                       static_cast<uint64_t>(timeout.count()), 1, &Awaiter::OnTimeout, this) < 0 || !sourceTemp) {
+            throw std::runtime_error("Failed to wait for device : sd_event_add_time_relative failed!");
+        }
+        timeoutSource.reset(sourceTemp);
+    }
+
+    list = monitor->waiters.get();
+    previous = list->last;
+    next = nullptr;
+    (list->last ? list->last->next : list->first) = this;
+    list->last = this;
+    isLinked = true;
+}
+
+void DeviceMonitor::Awaiter::Unlink() {
+    timeoutSource.reset();
+    if (!isLinked) {
+        return;
+    }
+
+    (previous ? previous->next : list->first) = next;
+    (next ? next->previous : list->last) = previous;
+    previous = nullptr;
+    next = nullptr;
+    isLinked = false;
+}
+
+int DeviceMonitor::Awaiter::OnTimeout(sd_event_source* source, uint64_t usec, void* userdata) {
+    (void) source; // Unused.
+    (void) usec; // Unused.
+
+    auto* self = static_cast<Awaiter*>(userdata);
+    if (!self) {
+        return -1;
+    }
+
+    // Resuming may destroy the waiter, and the source with it, so nothing is touched afterwards.
+    self->Unlink();
+    self->resume(self->resumeAddress);
+
+    return 0;
+}
+
+// *** WaiterList ***
+
+DeviceMonitor::WaiterList::~WaiterList() {
+    Cancel();
+}
+
+void DeviceMonitor::WaiterList::Cancel() {
+    while (first) {
+        Awaiter* waiter = first;
+        waiter->Unlink();
+        waiter->resume(waiter->resumeAddress);
+    }
+}
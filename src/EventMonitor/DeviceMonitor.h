@@ -2,31 +2,222 @@
 
 #include <memory>
 #include <functional>
+#include <vector>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <optional>
+#include <string>
+#include <utility>
 #include <EventMonitor/Event.h>
+#include <EventMonitor/EventTimer.h>
 #include <EventMonitor/Device.h>
+#include <EventMonitor/DispatchQueue.h>
+#include <EventMonitor/DeviceExecutor.h>
+#include <EventMonitor/EventRecorder.h>
+#include <EventMonitor/LatencyTracker.h>
+#include <EventMonitor/MetricsRegistry.h>
 
 extern "C" {
     #include <systemd/sd-device.h>
 }
 
 
+class DeviceEnumerator;
+
 class DeviceMonitor {
+private:
+    // Pending waiters of a monitor, defined below.
+    struct WaiterList;
+
 public:
     using DeviceEventCallback = std::function<void(const DeviceMonitor&, Device)>;
+    using DeviceBatchCallback = std::function<void(const DeviceMonitor&, std::vector<Device>)>;
+    using DeviceFilter = std::function<bool(const Device&)>;
+    using ResyncCallback = std::function<void(const DeviceMonitor&, DeviceEnumerator&)>;
+    using OverflowPolicy = DispatchQueue::OverflowPolicy;
+
+    struct OverflowStats {
+        // Times events were found to be lost, by any of the means below.
+        uint64_t overflowCount;
+        // Seqnums never received.
+        uint64_t missedSeqnums;
+        // Messages the kernel dropped because the socket receive buffer was full.
+        uint64_t socketDrops;
+        // Devices the dispatch queue dropped.
+        uint64_t queueDrops;
+        uint64_t resyncCount;
+    };
+
+    struct CoalesceStats {
+        // Events folded into a later event of the same device.
+        uint64_t merged;
+        // Events cancelled out, e.g. an add followed by a remove within the window.
+        uint64_t suppressed;
+        // Net events handed over.
+        uint64_t emitted;
+    };
+
+    // Pending wait for the next device passing a filter, returned by Next() and WaitFor().
+    //
+    // Meant to be co_await'ed (see DeviceWorkflow.h), it is linked into its monitor when suspending, then resumes
+    // the awaiting coroutine right from the event loop dispatch with the device, or with nullopt on timeout or
+    // when the monitor is destroyed. The waiter lives in the coroutine frame, so awaiting allocates nothing more
+    // than the filter and, with a timeout, the sd_event timer source.
+    // Works with any coroutine handle type, the header itself only needs C++17.
+    class Awaiter {
+    public:
+        ~Awaiter();
+        Awaiter(const Awaiter&) = delete;
+        Awaiter(Awaiter&&) = delete;
+        Awaiter& operator=(const Awaiter&) = delete;
+        Awaiter& operator=(Awaiter&&) = delete;
+
+        bool await_ready() const noexcept { return false; }
+        template <typename Handle>
+        void await_suspend(Handle handle) {
+            resumeAddress = handle.address();
+            resume = [](void* address) { Handle::from_address(address).resume(); };
+            Suspend();
+        }
+        std::optional<Device> await_resume() { return std::move(result); }
+
+    private:
+        friend class DeviceMonitor;
+
+        explicit Awaiter(DeviceMonitor& monitor, DeviceFilter filter, std::chrono::microseconds timeout);
+
+        // Link into the monitor and arm the timeout.
+        void Suspend();
+        // Unlink from the monitor and release the timeout, without resuming.
+        void Unlink();
+        static int OnTimeout(sd_event_source* source, uint64_t usec, void* userdata);
+
+        DeviceMonitor* monitor;
+        // The list the waiter was linked into.
+        WaiterList* list;
+        DeviceFilter filter;
+        std::chrono::microseconds timeout;
+        std::optional<Device> result;
+
+        std::unique_ptr<sd_event_source, decltype(&sd_event_source_unref)> timeoutSource;
+        void* resumeAddress;
+        void (*resume)(void*);
+        // Intrusive list of the waiters of the monitor.
+        Awaiter* previous;
+        Awaiter* next;
+        bool isLinked;
+    };
 
     explicit DeviceMonitor();
     explicit DeviceMonitor(std::shared_ptr<Event> eventLoop);
-    ~DeviceMonitor() = default;
+    // Resume the pending waiters with nullopt.
+    ~DeviceMonitor();
     DeviceMonitor(const DeviceMonitor&) = delete;
-    DeviceMonitor(DeviceMonitor&&) noexcept = default;
+    // Event sources, timers and dispatch threads point to the monitor.
+    DeviceMonitor(DeviceMonitor&&) = delete;
     DeviceMonitor& operator=(const DeviceMonitor&) = delete;
-    DeviceMonitor& operator=(DeviceMonitor&&) noexcept = default;
+    DeviceMonitor& operator=(DeviceMonitor&&) = delete;
 
     const std::shared_ptr<Event>& GetEvent() const { return eventLoop; }
     
     // Copy the callback used during the event loop.
     void SetCallback(const DeviceEventCallback callback);
+    // Copy the callback used during the event loop and switch to batched delivery.
+    // Devices are buffered and handed over together once maxBatchSize devices are pending,
+    // or once maxDelay has elapsed since the first pending device was received (0 disables the timer).
+    // Replaces any callback set with SetCallback(), and vice versa.
+    // Both throw while queued or executor dispatch is enabled, disable it first.
+    void SetBatchCallback(const DeviceBatchCallback callback, std::size_t maxBatchSize, std::chrono::microseconds maxDelay);
+    // Hand the pending batch over to the batch callback immediately.
+    void FlushBatch();
+
+    // Run the callback set with SetCallback() on dedicated consumer threads instead of the event loop thread.
+    // Received devices go through a bounded lock-free queue of queueCapacity slots (rounded up to a power of two),
+    // so a slow callback never stalls the event loop; when the queue is full, the device is dropped and counted.
+    // The callback is captured when calling this, and is called concurrently if consumerCount > 1.
+    // Consumer i is pinned to cpuAffinity[i % cpuAffinity.size()] when cpuAffinity is not empty.
+    // The overflow policy decides what happens when the queue is full, see DispatchQueue::OverflowPolicy.
+    void EnableQueuedDispatch(std::size_t queueCapacity, std::size_t consumerCount = 1, const std::vector<int>& cpuAffinity = {},
+                              OverflowPolicy policy = OverflowPolicy::DropNewest);
+    // Go back to calling the callback on the event loop thread, once the consumers drained the queue.
+    void DisableQueuedDispatch();
+    bool IsQueuedDispatchEnabled() const { return dispatchQueue != nullptr; }
+    std::size_t GetQueueDepth() const { return dispatchQueue ? dispatchQueue->GetDepth() : 0; }
+    uint64_t GetDroppedCount() const { return droppedCount + (dispatchQueue ? dispatchQueue->GetDroppedCount() : 0); }
+    // Per policy counters of the dispatch queue.
+    DispatchQueue::Stats GetQueueStats() const;
+
+    // Run the callback set with SetCallback() on a work-stealing thread pool instead of the event loop thread.
+    // Devices sharing a key (by default their syspath) are handled one at a time and in the order they were received,
+    // devices with different keys are handled in parallel. See DeviceExecutor.
+    // The callback is captured when calling this. Replaces queued dispatch, and vice versa.
+    void EnableExecutorDispatch(std::size_t threadCount = 0, DeviceExecutor::KeyFunction keyFunction = nullptr,
+                                std::size_t shardCount = 1024, const std::vector<int>& cpuAffinity = {});
+    // Go back to calling the callback on the event loop thread, once every pending device has been handled.
+    void DisableExecutorDispatch();
+    bool IsExecutorDispatchEnabled() const { return executor != nullptr; }
+    // Queue depths and steal counts of the executor, to tune its size.
+    DeviceExecutor::Stats GetExecutorStats() const;
     
+    // Record every received device that passes the filters, before it is dispatched. Null stops recording.
+    // The recorder is used from the event loop thread.
+    void SetRecorder(std::shared_ptr<EventRecorder> recorder) { this->recorder = std::move(recorder); }
+
+    // Time every event into the tracker : reception, callback entry and return, and USEC_INITIALIZED for add events.
+    // Queued and executor dispatch capture the tracker when enabled, like the callback. With a batch callback, every
+    // device of a batch is charged the duration of the whole call. Null stops it.
+    void SetLatencyTracker(std::shared_ptr<LatencyTracker> tracker) { latencyTracker = std::move(tracker); }
+    const std::shared_ptr<LatencyTracker>& GetLatencyTracker() const { return latencyTracker; }
+
+    // Count received, filtered, dispatched, dropped and coalesced events, time the callback and sample the queue depth
+    // into the registry, every series labelled with the given labels (e.g. monitor="usb").
+    // Like the callback, queued and executor dispatch capture the metrics when enabled. Null stops it.
+    void SetMetrics(std::shared_ptr<MetricsRegistry> registry, const MetricsRegistry::Labels& labels = {});
+
+    // Deliver a device as if it had just been received, through the same path (batching, queue or executor).
+    // Must be called from the thread running the event loop, or while it is not running.
+    // Detached devices are handed to the consumer threads right away, others wait for the event loop like
+    // received devices do.
+    void Inject(Device device);
+
+    // co_await the next received device passing the filter (any device if null), e.g. on one monitor shared by many
+    // workflows instead of one monitor per step. Waiters see devices before the callback, which still gets them.
+    // Must be awaited from the thread running the event loop. A monitor may start without any callback when
+    // a waiter is pending, unclaimed devices are then dropped.
+    Awaiter Next(DeviceFilter filter = nullptr) { return Awaiter(*this, std::move(filter), std::chrono::microseconds(0)); }
+    // Like Next(), resuming with nullopt if no device passed the predicate within the timeout.
+    Awaiter WaitFor(DeviceFilter predicate, std::chrono::microseconds timeout);
+    std::size_t GetWaiterCount() const;
+
+    // Hold received devices for the window, from the first event of a device, and collapse the events of a syspath
+    // into one net event: add then remove cancel out, an add followed by changes becomes an add of the final state,
+    // anything else keeps the last event. Moves are not held, they hand over the pending events of both syspaths
+    // right away. Waiters still see every event.
+    void EnableCoalescing(std::chrono::microseconds window);
+    // Hand over the pending events, then stop coalescing.
+    void DisableCoalescing();
+    bool IsCoalescingEnabled() const { return coalesceTimer != nullptr; }
+    // Hand over the pending events right away.
+    void FlushCoalesced();
+    CoalesceStats GetCoalesceStats() const { return coalesceStats; }
+
+    // Size of the netlink socket receive buffer, which absorbs bursts while the event loop is busy.
+    // Above net.core.rmem_max, libsystemd needs CAP_NET_ADMIN to force it.
+    void SetReceiveBufferSize(std::size_t size);
+
+    // Detect lost events while monitoring: seqnum gaps not filled after dropCheckInterval (only without
+    // sd_device_monitor filters, which make gaps normal), drops of the netlink socket and of the dispatch queue,
+    // both checked every dropCheckInterval.
+    void EnableOverflowDetection(std::chrono::microseconds dropCheckInterval = std::chrono::seconds(1));
+    void DisableOverflowDetection();
+    bool IsOverflowDetectionEnabled() const { return dropCheckTimer != nullptr; }
+    OverflowStats GetOverflowStats() const { return overflowStats; }
+    // Once events were lost, hand a new DeviceEnumerator to the callback on the next loop iteration, so state can
+    // converge again, e.g. through DeviceRegistry::Seed(). Null disables it.
+    void SetResyncCallback(ResyncCallback callback);
+
     bool IsAttachedToEvent() const { return eventLoop != nullptr; }
     bool IsMonitoringForEvents() const { return isMonitoring; }
 
@@ -40,7 +231,66 @@ public:
     // Stop monitoring for device events.
     void StopMonitoring();
 
+    // Filters, which can be added before or while monitoring.
+    // Subsystem, devtype and tag matches are compiled into a BPF socket filter, so the kernel drops unmatched events
+    // before they ever wake the event loop. Sysattr and parent matches are checked by sd_device_monitor, and property
+    // matches right after, both before any Device is built for the event.
+    // An empty devtype matches any devtype of the subsystem.
+    void AddMatchSubsystemDevtype(const std::string& subsystem, const std::string& devtype = std::string());
+    void AddMatchTag(const std::string& tag);
+    void AddMatchSysattr(const std::string& sysattr, const std::string& value, bool matchSysattr);
+    // Like DeviceEnumerator, a device passes if any property match does. Values may be shell-style glob patterns.
+    void AddMatchProperty(const std::string& property, const std::string& value);
+    void AddMatchParent(const Device& parent, bool matchParent);
+
+    // Remove all filters from the monitor.
+    void ResetFilters();
+
 private:
+    // Property matches are not supported by sd_device_monitor, they are checked on the raw sd_device.
+    bool MatchesProperties(sd_device* device) const;
+    // Recompile the BPF filter when monitoring, otherwise sd_device_monitor_start() takes care of it.
+    void UpdateFilter();
+
+    // Hold a received device in the coalescing stage.
+    void Coalesce(Device device);
+    // Hand over the net event of the pending device, if any.
+    void EmitCoalesced(const std::string& syspath);
+    // Hand over the events whose window elapsed, and arm the timer for the next one.
+    void OnCoalesceWindow();
+
+    struct Metrics {
+        std::shared_ptr<MetricsRegistry> registry;
+        MetricsRegistry::Counter received;
+        MetricsRegistry::Counter filtered;
+        MetricsRegistry::Counter dispatched;
+        MetricsRegistry::Counter dropped;
+        MetricsRegistry::Counter coalesced;
+        MetricsRegistry::Gauge queueDepth;
+        LatencyHistogram* callbackDuration = nullptr;
+    };
+
+    // Call the callback, timing it into the tracker and the metrics if there are any.
+    void InvokeCallback(const DeviceEventCallback& callback, LatencyTracker* tracker, const Metrics& metrics, Device device) const;
+    // Push a device into the dispatch queue or the executor, counting what the queue dropped or coalesced.
+    void HandOff(Device device);
+
+    // Deliver a received device to the user, either directly, through the pending batch or through the dispatch queue.
+    void Dispatch(Device device);
+    // Push the devices staged for the consumer threads into the dispatch queue or the executor.
+    void PublishStagedDevices();
+    static int OnHandoff(sd_event_source* source, void* userdata);
+    // Resume the waiters whose filter passes with a device sharing the received one.
+    void ResumeWaiters(const Device& device);
+    // Resume every waiter with nullopt.
+    void CancelWaiters();
+    bool HasWaiters() const { return waiters && waiters->first; }
+    // Track the seqnum of a received device, whether or not it passes the property matches.
+    void CheckSeqnum(sd_device* device);
+    // Periodic part of the overflow detection.
+    void CheckDrops();
+    void OnOverflow();
+
     bool isMonitoring;
 
     std::unique_ptr<sd_device_monitor, decltype(&sd_device_monitor_unref)> deviceMonitor;
@@ -48,6 +298,72 @@ private:
 
     DeviceEventCallback userCallback;
 
+    std::vector<std::pair<std::string, std::string>> propertyMatches;
+    std::shared_ptr<EventRecorder> recorder;
+    std::shared_ptr<LatencyTracker> latencyTracker;
+    Metrics metrics;
+
+    // Destroying it with the monitor cancels the waiters left.
+    struct WaiterList {
+        Awaiter* first = nullptr;
+        Awaiter* last = nullptr;
+
+        WaiterList() = default;
+        ~WaiterList();
+        WaiterList(const WaiterList&) = delete;
+        WaiterList& operator=(const WaiterList&) = delete;
+
+        // Resume every waiter with nullopt.
+        void Cancel();
+    };
+    std::unique_ptr<WaiterList> waiters;
+
+    // Filters applied by sd_device_monitor, which make seqnum gaps expected.
+    bool hasMonitorFilters;
+    OverflowStats overflowStats;
+    std::chrono::microseconds dropCheckInterval;
+    std::unique_ptr<EventTimer> dropCheckTimer;
+    uint64_t dropCheckCount;
+    uint64_t lastSeqnum;
+    // Seqnums skipped over, with the drop check count when noticed. udevd may deliver out of order,
+    // they are only counted as missed if still missing at the next check.
+    std::map<uint64_t, uint64_t> missingSeqnums;
+    uint64_t lastSocketDrops;
+    uint64_t lastQueueDrops;
+    ResyncCallback resyncCallback;
+    std::unique_ptr<EventTimer> resyncTimer;
+
+    struct PendingDevice {
+        Device device;
+        sd_device_action_t firstAction;
+        uint64_t eventCount;
+        uint64_t deadline;
+    };
+    std::chrono::microseconds coalesceWindow;
+    std::unique_ptr<EventTimer> coalesceTimer;
+    std::unordered_map<std::string, PendingDevice> pendingDevices;
+    // Syspaths in order of their first pending event, with its deadline. Entries whose device was handed over
+    // early no longer match a pending deadline and are skipped.
+    std::deque<std::pair<uint64_t, std::string>> pendingOrder;
+    CoalesceStats coalesceStats;
+
+    DeviceBatchCallback batchCallback;
+    std::size_t maxBatchSize;
+    std::chrono::microseconds maxBatchDelay;
+    std::vector<Device> batch;
+    std::unique_ptr<EventTimer> batchTimer;
+
+    // sd_device_monitor drops its own reference on a device right after our handler returns, and sd_device
+    // reference counting is not thread-safe. Devices are thus staged until a post source runs, after that
+    // release, and only then handed to the consumer threads which become their sole owners.
+    static constexpr std::size_t maxStagedDevices = 64;
+    std::vector<Device> stagedDevices;
+    std::unique_ptr<sd_event_source, decltype(&sd_event_source_unref)> handoffSource;
+    uint64_t droppedCount;
+    // Declared last so the consumer threads are joined before anything they may use is destroyed.
+    std::unique_ptr<DispatchQueue> dispatchQueue;
+    std::unique_ptr<DeviceExecutor> executor;
+
 #ifdef ENABLE_TESTS
     friend class DeviceMonitorTest;
 #endif // ENABLE_TESTS
@@ -0,0 +1,59 @@
+#include <EventMonitor/DeviceProperties.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Copy the view into the buffer at the cursor, then advance the cursor past it.
+    std::string_view CopyInto(char*& cursor, std::string_view value) {
+        if (value.empty()) {
+            return std::string_view();
+        }
+        std::memcpy(cursor, value.data(), value.size());
+        const std::string_view copied(cursor, value.size());
+        cursor += value.size();
+        return copied;
+    }
+}
+
+// *** Public ***
+
+DeviceProperties::DeviceProperties(std::vector<Property> propertiesToCopy)
+    : properties(std::move(propertiesToCopy)) {
+    std::size_t bufferSize = 0;
+    for (const auto& [key, value] : properties) {
+        bufferSize += key.size() + value.size();
+    }
+
+    buffer.reset(new char[bufferSize]);
+    char* cursor = buffer.get();
+    for (auto& [key, value] : properties) {
+        key = CopyInto(cursor, key);
+        value = CopyInto(cursor, value);
+    }
+
+    std::sort(properties.begin(), properties.end(), [](const Property& lhs, const Property& rhs) {
+        return lhs.first < rhs.first;
+    });
+}
+
+DeviceProperties::DeviceProperties(const DeviceProperties& other)
+    : DeviceProperties(other.properties) {
+}
+
+DeviceProperties& DeviceProperties::operator=(const DeviceProperties& other) {
+    if (this != &other) {
+        DeviceProperties copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+std::optional<std::string_view> DeviceProperties::Find(std::string_view key) const {
+    const auto it = std::lower_bound(properties.begin(), properties.end(), key, [](const Property& property, std::string_view searched) {
+        return property.first < searched;
+    });
+    if (it == properties.end() || it->first != key) {
+        return std::nullopt;
+    }
+    return it->second;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <optional>
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Flat, read-only set of device properties, sorted by key.
+//
+// Keys and values are copied back to back into a single character buffer and indexed by a single sorted vector,
+// so a whole property set costs two allocations and a lookup is a binary search.
+class DeviceProperties {
+public:
+    using Property = std::pair<std::string_view, std::string_view>;
+    using const_iterator = std::vector<Property>::const_iterator;
+
+    explicit DeviceProperties() = default;
+    // Copy the properties, whose views only need to be valid during the call.
+    // The vector itself is reused as the index, so moving it in saves an allocation.
+    explicit DeviceProperties(std::vector<Property> properties);
+    ~DeviceProperties() = default;
+    DeviceProperties(const DeviceProperties& other);
+    DeviceProperties(DeviceProperties&&) noexcept = default;
+    DeviceProperties& operator=(const DeviceProperties& other);
+    DeviceProperties& operator=(DeviceProperties&&) noexcept = default;
+
+    std::optional<std::string_view> Find(std::string_view key) const;
+
+    std::size_t GetSize() const { return properties.size(); }
+    bool IsEmpty() const { return properties.empty(); }
+    const Property& operator[](std::size_t index) const { return properties[index]; }
+    const_iterator begin() const { return properties.begin(); }
+    const_iterator end() const { return properties.end(); }
+
+private:
+    std::unique_ptr<char[]> buffer;
+    // Views into the buffer.
+    std::vector<Property> properties;
+};
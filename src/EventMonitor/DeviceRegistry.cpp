@@ -0,0 +1,114 @@
+#include <EventMonitor/DeviceRegistry.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+// *** Public ***
+
+DeviceRegistry::DeviceRegistry(std::shared_ptr<StringTable> stringTable)
+    : strings(std::move(stringTable)),
+      generation(0) {
+    if (!strings) {
+        throw std::invalid_argument("Failed to create DeviceRegistry : StringTable is null!");
+    }
+}
+
+void DeviceRegistry::Seed(const DeviceEnumerator& enumerator) {
+    // Snapshots are built without the lock, borrowing is enough since they copy the fields.
+    std::vector<std::shared_ptr<const DeviceSnapshot>> snapshots;
+    for (const Device& device : enumerator.Borrowed()) {
+        snapshots.push_back(std::make_shared<const DeviceSnapshot>(DeviceSnapshot::FromDevice(device, strings)));
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    entries.clear();
+    entries.reserve(snapshots.size());
+    for (auto& snapshot : snapshots) {
+        Insert(std::move(snapshot));
+    }
+}
+
+void DeviceRegistry::Apply(const Device& device) {
+    Apply(device.GetAction().value_or(SD_DEVICE_ADD), device);
+}
+
+void DeviceRegistry::Apply(sd_device_action_t action, const Device& device) {
+    if (action == SD_DEVICE_REMOVE) {
+        const auto syspath = device.GetSyspathView();
+        if (syspath) {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            Erase(*syspath);
+        }
+        return;
+    }
+
+    auto snapshot = std::make_shared<const DeviceSnapshot>(DeviceSnapshot::FromDevice(device, strings));
+    if (!snapshot->GetSyspath()) {
+        return;
+    }
+
+    std::optional<std::string> oldSyspath;
+    if (action == SD_DEVICE_MOVE) {
+        if (const auto oldDevpath = device.GetPropertyView("DEVPATH_OLD")) {
+            oldSyspath = "/sys" + std::string(*oldDevpath);
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    if (oldSyspath) {
+        Erase(*oldSyspath);
+    }
+    Insert(std::move(snapshot));
+}
+
+std::optional<DeviceRegistry::Entry> DeviceRegistry::Find(std::string_view syspath) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const auto it = entries.find(syspath);
+    if (it == entries.end()) {
+        return std::nullopt;
+    }
+    return it->second;
+}
+
+bool DeviceRegistry::Contains(std::string_view syspath) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return entries.find(syspath) != entries.end();
+}
+
+bool DeviceRegistry::IsCurrent(std::string_view syspath, uint64_t entryGeneration) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const auto it = entries.find(syspath);
+    return it != entries.end() && it->second.generation == entryGeneration;
+}
+
+void DeviceRegistry::ForEach(const std::function<void(const Entry&)>& visitor) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    for (const auto& [syspath, entry] : entries) {
+        visitor(entry);
+    }
+}
+
+std::size_t DeviceRegistry::GetSize() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return entries.size();
+}
+
+// *** Private ***
+
+void DeviceRegistry::Insert(std::shared_ptr<const DeviceSnapshot> snapshot) {
+    const auto syspath = snapshot->GetSyspath();
+    if (!syspath) {
+        return;
+    }
+
+    // The key views the old snapshot, drop the whole node before inserting the new one.
+    entries.erase(*syspath);
+    const uint64_t entryGeneration = generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+    entries.emplace(*syspath, Entry{ std::move(snapshot), entryGeneration });
+}
+
+void DeviceRegistry::Erase(std::string_view syspath) {
+    if (entries.erase(syspath) > 0) {
+        generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+}
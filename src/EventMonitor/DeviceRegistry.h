@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/DeviceSnapshot.h>
+#include <EventMonitor/StringTable.h>
+
+// In-memory view of the devices present on the system, keyed by syspath.
+//
+// Apply() every event of a DeviceMonitor to keep it current, and Seed() it once from a DeviceEnumerator : start the
+// monitor first, then seed from its event loop thread (e.g. through Event::Invoke()). The events raised while
+// enumerating wait in the monitor socket and are applied after the seed, instead of being lost.
+// Lookups never touch sysfs. Every entry carries the registry generation of its last update, so a reader holding
+// an entry can check whether it is still current with a single hash lookup.
+// Thread-safe : lookups take a shared lock, updates an exclusive one.
+class DeviceRegistry {
+public:
+    struct Entry {
+        std::shared_ptr<const DeviceSnapshot> snapshot;
+        uint64_t generation;
+    };
+
+    explicit DeviceRegistry(std::shared_ptr<StringTable> strings = StringTable::GetDefault());
+    ~DeviceRegistry() = default;
+    DeviceRegistry(const DeviceRegistry&) = delete;
+    DeviceRegistry(DeviceRegistry&&) = delete;
+    DeviceRegistry& operator=(const DeviceRegistry&) = delete;
+    DeviceRegistry& operator=(DeviceRegistry&&) = delete;
+
+    // Replace the content of the registry with the devices of the enumerator.
+    // Call it from the event loop thread of an already started monitor, so no event is lost or overwritten.
+    void Seed(const DeviceEnumerator& enumerator);
+    // Apply a DeviceMonitor event, a device without action (e.g. enumerated) is added.
+    void Apply(const Device& device);
+    // Remove erases the device, move erases DEVPATH_OLD then adds the device, any other action adds or replaces it.
+    void Apply(sd_device_action_t action, const Device& device);
+
+    std::optional<Entry> Find(std::string_view syspath) const;
+    bool Contains(std::string_view syspath) const;
+    // Whether the entry of the syspath was not updated or removed since it had this generation.
+    bool IsCurrent(std::string_view syspath, uint64_t generation) const;
+    // Visit every entry under the shared lock, the visitor must not call back into the registry.
+    void ForEach(const std::function<void(const Entry&)>& visitor) const;
+
+    std::size_t GetSize() const;
+    // Bumped on every update, 0 for a registry never updated.
+    uint64_t GetGeneration() const { return generation.load(std::memory_order_acquire); }
+
+private:
+    // Keys view the syspath stored in the snapshot of their entry.
+    using Map = std::unordered_map<std::string_view, Entry>;
+
+    // Must be called with the exclusive lock held.
+    void Insert(std::shared_ptr<const DeviceSnapshot> snapshot);
+    void Erase(std::string_view syspath);
+
+    std::shared_ptr<StringTable> strings;
+    mutable std::shared_mutex mutex;
+    Map entries;
+    std::atomic<uint64_t> generation;
+};
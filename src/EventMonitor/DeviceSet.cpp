@@ -0,0 +1,174 @@
+#include <EventMonitor/DeviceSet.h>
+#include <EventMonitor/Hash.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr uint64_t actionKeyHash = Fnv1aHash("ACTION");
+    constexpr uint64_t seqnumKeyHash = Fnv1aHash("SEQNUM");
+}
+
+// *** Public ***
+
+DeviceSet::DeviceSet(const std::vector<Device>& devices) {
+    entries.reserve(devices.size());
+    for (const Device& device : devices) {
+        if (const auto syspath = device.GetSyspathView()) {
+            Add(*syspath, [&device](auto&& visitor) { device.ForEachProperty(visitor); });
+        }
+    }
+    Sort();
+}
+
+DeviceSet::DeviceSet(const DeviceEnumerator& enumerator) {
+    for (const Device& device : enumerator.Borrowed()) {
+        if (const auto syspath = device.GetSyspathView()) {
+            Add(*syspath, [&device](auto&& visitor) { device.ForEachProperty(visitor); });
+        }
+    }
+    Sort();
+}
+
+DeviceSet::DeviceSet(const DeviceInventory& inventory) {
+    entries.reserve(inventory.GetSize());
+    for (std::size_t i = 0; i < inventory.GetSize(); ++i) {
+        const DeviceInventory::Entry entry = inventory[i];
+        Add(entry.GetSyspath(), [&entry](auto&& visitor) {
+            for (const auto& [key, value] : entry.GetProperties()) {
+                visitor(key, value);
+            }
+        });
+    }
+    Sort();
+}
+
+DeviceDiff DeviceSet::Diff(const DeviceSet& newer) const {
+    DeviceDiff diff;
+    auto older = entries.begin();
+    auto current = newer.entries.begin();
+    while (older != entries.end() || current != newer.entries.end()) {
+        // Same order as Sort(), hash then syspath.
+        int order = 0;
+        if (older == entries.end()) {
+            order = 1;
+        }
+        else if (current == newer.entries.end()) {
+            order = -1;
+        }
+        else if (older->syspathHash != current->syspathHash) {
+            order = (older->syspathHash < current->syspathHash) ? -1 : 1;
+        }
+        else {
+            order = GetSyspath(*older).compare(newer.GetSyspath(*current));
+        }
+
+        if (order < 0) {
+            diff.removed.emplace_back(GetSyspath(*older));
+            ++older;
+        }
+        else if (order > 0) {
+            diff.added.emplace_back(newer.GetSyspath(*current));
+            ++current;
+        }
+        else {
+            if (older->fingerprint != current->fingerprint) {
+                diff.changed.push_back({ std::string(GetSyspath(*older)), GetChangedKeys(*older, newer, *current) });
+            }
+            ++older;
+            ++current;
+        }
+    }
+
+    std::sort(diff.added.begin(), diff.added.end());
+    std::sort(diff.removed.begin(), diff.removed.end());
+    std::sort(diff.changed.begin(), diff.changed.end(), [](const DeviceDiff::Change& lhs, const DeviceDiff::Change& rhs) {
+        return lhs.syspath < rhs.syspath;
+    });
+    return diff;
+}
+
+// *** Private ***
+
+template <typename VisitProperties>
+void DeviceSet::Add(std::string_view syspath, VisitProperties&& visitProperties) {
+    if (syspaths.size() + syspath.size() > std::numeric_limits<uint32_t>::max() ||
+        properties.size() >= std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Failed to add device to DeviceSet : Too many devices!");
+    }
+
+    Entry entry{};
+    entry.syspathHash = Fnv1aHash(syspath);
+    entry.syspathOffset = static_cast<uint32_t>(syspaths.size());
+    entry.syspathLength = static_cast<uint32_t>(syspath.size());
+    entry.firstProperty = static_cast<uint32_t>(properties.size());
+    syspaths.append(syspath);
+
+    visitProperties([this](std::string_view key, std::string_view value) {
+        const uint64_t keyHash = Fnv1aHash(key);
+        if (keyHash == actionKeyHash || keyHash == seqnumKeyHash) {
+            return;
+        }
+        if (keys.find(keyHash) == keys.end()) {
+            keys.emplace(keyHash, std::string(key));
+        }
+        properties.push_back({ keyHash, Fnv1aHash(value) });
+    });
+
+    const auto first = properties.begin() + entry.firstProperty;
+    std::sort(first, properties.end(), [](const PropertyHash& lhs, const PropertyHash& rhs) {
+        return lhs.keyHash < rhs.keyHash;
+    });
+    entry.propertyCount = static_cast<uint32_t>(properties.end() - first);
+    entry.fingerprint = fnv1aOffset;
+    for (auto it = first; it != properties.end(); ++it) {
+        entry.fingerprint = Fnv1aHash(std::string_view(reinterpret_cast<const char*>(&*it), sizeof(PropertyHash)), entry.fingerprint);
+    }
+    entries.push_back(entry);
+}
+
+void DeviceSet::Sort() {
+    // Stable, so the first of duplicated syspaths stays in front.
+    std::stable_sort(entries.begin(), entries.end(), [this](const Entry& lhs, const Entry& rhs) {
+        if (lhs.syspathHash != rhs.syspathHash) {
+            return lhs.syspathHash < rhs.syspathHash;
+        }
+        return GetSyspath(lhs) < GetSyspath(rhs);
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [this](const Entry& lhs, const Entry& rhs) {
+        return lhs.syspathHash == rhs.syspathHash && GetSyspath(lhs) == GetSyspath(rhs);
+    }), entries.end());
+}
+
+std::string_view DeviceSet::GetSyspath(const Entry& entry) const {
+    return std::string_view(syspaths.data() + entry.syspathOffset, entry.syspathLength);
+}
+
+std::vector<std::string> DeviceSet::GetChangedKeys(const Entry& entry, const DeviceSet& newer, const Entry& newerEntry) const {
+    std::vector<std::string> changedKeys;
+    const PropertyHash* older = properties.data() + entry.firstProperty;
+    const PropertyHash* const olderEnd = older + entry.propertyCount;
+    const PropertyHash* current = newer.properties.data() + newerEntry.firstProperty;
+    const PropertyHash* const currentEnd = current + newerEntry.propertyCount;
+
+    while (older != olderEnd || current != currentEnd) {
+        if (current == currentEnd || (older != olderEnd && older->keyHash < current->keyHash)) {
+            changedKeys.push_back(keys.at(older->keyHash));
+            ++older;
+        }
+        else if (older == olderEnd || current->keyHash < older->keyHash) {
+            changedKeys.push_back(newer.keys.at(current->keyHash));
+            ++current;
+        }
+        else {
+            if (older->valueHash != current->valueHash) {
+                changedKeys.push_back(keys.at(older->keyHash));
+            }
+            ++older;
+            ++current;
+        }
+    }
+
+    std::sort(changedKeys.begin(), changedKeys.end());
+    return changedKeys;
+}
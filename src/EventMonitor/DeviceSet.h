@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/DeviceInventory.h>
+
+// Difference between two device sets, see DeviceSet::Diff(). Every list is sorted.
+struct DeviceDiff {
+    struct Change {
+        std::string syspath;
+        // Keys added, removed or whose value changed.
+        std::vector<std::string> keys;
+    };
+
+    std::vector<std::string> added;
+    std::vector<std::string> removed;
+    std::vector<Change> changed;
+
+    bool IsEmpty() const { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+// Hashed summary of a set of devices, meant to be diffed against another one.
+//
+// Each device is reduced to its syspath hash, a fingerprint of its properties and one (key hash, value hash) pair
+// per property, all in flat vectors sorted by syspath hash. Diffing two sets is then a single merge pass comparing
+// integers, the properties of a device only being walked when the fingerprints differ.
+// ACTION and SEQNUM describe an event rather than the device, they are left out so received devices compare
+// equal to enumerated ones.
+class DeviceSet {
+public:
+    explicit DeviceSet(const std::vector<Device>& devices);
+    // Enumerate the devices, without keeping them.
+    explicit DeviceSet(const DeviceEnumerator& enumerator);
+    explicit DeviceSet(const DeviceInventory& inventory);
+    ~DeviceSet() = default;
+    DeviceSet(const DeviceSet&) = default;
+    DeviceSet(DeviceSet&&) noexcept = default;
+    DeviceSet& operator=(const DeviceSet&) = default;
+    DeviceSet& operator=(DeviceSet&&) noexcept = default;
+
+    std::size_t GetSize() const { return entries.size(); }
+
+    // Devices of newer missing from this set, missing from newer, and present in both with different properties.
+    DeviceDiff Diff(const DeviceSet& newer) const;
+
+private:
+    struct Entry {
+        uint64_t syspathHash;
+        uint64_t fingerprint;
+        // Into syspaths.
+        uint32_t syspathOffset;
+        uint32_t syspathLength;
+        // Into properties.
+        uint32_t firstProperty;
+        uint32_t propertyCount;
+    };
+
+    struct PropertyHash {
+        uint64_t keyHash;
+        uint64_t valueHash;
+    };
+
+    // visitProperties(visitor) must call visitor(key, value) for every property of the device.
+    template <typename VisitProperties>
+    void Add(std::string_view syspath, VisitProperties&& visitProperties);
+    // Sort the entries and drop duplicated syspaths, keeping the first one added.
+    void Sort();
+
+    std::string_view GetSyspath(const Entry& entry) const;
+    // Keys of the properties that differ between the entry of this set and the one of newer, sorted.
+    std::vector<std::string> GetChangedKeys(const Entry& entry, const DeviceSet& newer, const Entry& newerEntry) const;
+
+    std::vector<Entry> entries;
+    // Properties of each entry, sorted by key hash.
+    std::vector<PropertyHash> properties;
+    // Syspaths back to back.
+    std::string syspaths;
+    // Property keys are a small vocabulary, each one is only stored once.
+    std::unordered_map<uint64_t, std::string> keys;
+};
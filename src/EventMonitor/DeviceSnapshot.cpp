@@ -0,0 +1,122 @@
+#include <EventMonitor/DeviceSnapshot.h>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+// *** Public ***
+
+DeviceSnapshot DeviceSnapshot::FromDevice(const Device& device, const std::shared_ptr<StringTable>& strings) {
+    if (!strings) {
+        throw std::invalid_argument("Failed to create DeviceSnapshot : StringTable is null!");
+    }
+
+    device.PrefetchAll();
+
+    // First pass : read the fields and size the blob.
+    Header header{};
+    std::size_t blobSize = 0;
+    for (std::size_t i = 0; i < fieldCount; ++i) {
+        const auto field = static_cast<DeviceField>(i);
+        const auto& value = device.GetField(field);
+        if (!value) {
+            continue;
+        }
+
+        header.presence |= static_cast<uint16_t>(1u << i);
+        if (IsInterned(field)) {
+            header.interned |= static_cast<uint16_t>(1u << i);
+            header.fields[i] = { strings->Intern(*value), static_cast<uint32_t>(value->size()) };
+        }
+        else {
+            header.fields[i] = { static_cast<uint32_t>(blobSize), static_cast<uint32_t>(value->size()) };
+            blobSize += value->size();
+        }
+    }
+    if (blobSize > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Failed to create DeviceSnapshot : Device fields are too large!");
+    }
+    header.blobSize = static_cast<uint32_t>(blobSize);
+
+    // Second pass : lay the header and the characters out in one allocation.
+    std::unique_ptr<unsigned char[]> data(new unsigned char[sizeof(Header) + blobSize]);
+    new (data.get()) Header(header);
+    char* blob = reinterpret_cast<char*>(data.get() + sizeof(Header));
+    for (std::size_t i = 0; i < fieldCount; ++i) {
+        const auto field = static_cast<DeviceField>(i);
+        if ((header.presence & (1u << i)) && !IsInterned(field)) {
+            std::memcpy(blob + header.fields[i].offset, device.GetField(field)->data(), header.fields[i].length);
+        }
+    }
+
+    return DeviceSnapshot(std::move(data), strings);
+}
+
+DeviceSnapshot::DeviceSnapshot(const DeviceSnapshot& other)
+    : data(other.data ? new unsigned char[other.GetMemoryUsage()] : nullptr),
+      strings(other.strings) {
+    if (data) {
+        new (data.get()) Header(other.GetHeader());
+        std::memcpy(data.get() + sizeof(Header), other.GetBlob(), other.GetHeader().blobSize);
+    }
+}
+
+DeviceSnapshot& DeviceSnapshot::operator=(const DeviceSnapshot& other) {
+    if (this != &other) {
+        DeviceSnapshot copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+bool DeviceSnapshot::Has(DeviceField field) const {
+    const auto index = static_cast<std::size_t>(field);
+    return index < fieldCount && (GetHeader().presence & (1u << index));
+}
+
+std::optional<std::string_view> DeviceSnapshot::Get(DeviceField field) const {
+    if (!Has(field)) {
+        return std::nullopt;
+    }
+
+    const Header& header = GetHeader();
+    const auto index = static_cast<std::size_t>(field);
+    const FieldEntry& entry = header.fields[index];
+    if (header.interned & (1u << index)) {
+        return strings->Lookup(entry.offset);
+    }
+    return std::string_view(GetBlob() + entry.offset, entry.length);
+}
+
+std::size_t DeviceSnapshot::GetMemoryUsage() const {
+    return data ? sizeof(Header) + GetHeader().blobSize : 0;
+}
+
+// *** Private ***
+
+bool DeviceSnapshot::IsInterned(DeviceField field) {
+    switch (field) {
+        case DeviceField::Devtype:
+        case DeviceField::Driver:
+        case DeviceField::Subsystem:
+        case DeviceField::Type:
+            return true;
+        default:
+            return false;
+    }
+}
+
+DeviceSnapshot::DeviceSnapshot(std::unique_ptr<unsigned char[]> snapshotData, std::shared_ptr<const StringTable> stringTable)
+    : data(std::move(snapshotData)),
+      strings(std::move(stringTable)) {
+}
+
+const DeviceSnapshot::Header& DeviceSnapshot::GetHeader() const {
+    // A moved-from snapshot has no field.
+    static constexpr Header emptyHeader{};
+    return data ? *std::launder(reinterpret_cast<const Header*>(data.get())) : emptyHeader;
+}
+
+const char* DeviceSnapshot::GetBlob() const {
+    return reinterpret_cast<const char*>(data.get() + sizeof(Header));
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/StringTable.h>
+
+// Immutable, compact copy of the fields of a Device.
+//
+// Everything lives in a single allocation : a fixed-size header holding a presence bitmask and an (offset, length)
+// pair per field, followed by the characters of the fields. Low-cardinality fields (subsystem, driver, devtype, type)
+// are interned in a shared StringTable instead, their header entry then holding the string id.
+// Reading a snapshot never touches libsystemd and does not require the device to still be plugged.
+class DeviceSnapshot {
+public:
+    // Read every field of the device, fetching the ones not cached yet.
+    static DeviceSnapshot FromDevice(const Device& device, const std::shared_ptr<StringTable>& strings = StringTable::GetDefault());
+
+    ~DeviceSnapshot() = default;
+    DeviceSnapshot(const DeviceSnapshot& other);
+    // A moved-from snapshot is empty : it has no field and owns no memory.
+    DeviceSnapshot(DeviceSnapshot&&) noexcept = default;
+    DeviceSnapshot& operator=(const DeviceSnapshot& other);
+    DeviceSnapshot& operator=(DeviceSnapshot&&) noexcept = default;
+
+    bool Has(DeviceField field) const;
+    // The view stays valid as long as the snapshot and its string table do.
+    std::optional<std::string_view> Get(DeviceField field) const;
+
+    std::optional<std::string_view> GetDevname() const { return Get(DeviceField::Devname); }
+    std::optional<std::string_view> GetDevpath() const { return Get(DeviceField::Devpath); }
+    std::optional<std::string_view> GetDevtype() const { return Get(DeviceField::Devtype); }
+    std::optional<std::string_view> GetDriver() const { return Get(DeviceField::Driver); }
+    std::optional<std::string_view> GetName() const { return Get(DeviceField::Name); }
+    std::optional<std::string_view> GetPath() const { return Get(DeviceField::Path); }
+    std::optional<std::string_view> GetProductID() const { return Get(DeviceField::ProductID); }
+    std::optional<std::string_view> GetSerial() const { return Get(DeviceField::Serial); }
+    std::optional<std::string_view> GetSubsystem() const { return Get(DeviceField::Subsystem); }
+    std::optional<std::string_view> GetSysname() const { return Get(DeviceField::Sysname); }
+    std::optional<std::string_view> GetSysnum() const { return Get(DeviceField::Sysnum); }
+    std::optional<std::string_view> GetSyspath() const { return Get(DeviceField::Syspath); }
+    std::optional<std::string_view> GetType() const { return Get(DeviceField::Type); }
+    std::optional<std::string_view> GetVendorID() const { return Get(DeviceField::VendorID); }
+
+    // Bytes owned by this snapshot, interned strings excluded.
+    std::size_t GetMemoryUsage() const;
+
+private:
+    static constexpr std::size_t fieldCount = static_cast<std::size_t>(DeviceField::Count);
+
+    struct FieldEntry {
+        // Offset in the character blob, or StringTable id for interned fields.
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    struct Header {
+        uint16_t presence;
+        uint16_t interned;
+        uint32_t blobSize;
+        FieldEntry fields[fieldCount];
+    };
+
+    static bool IsInterned(DeviceField field);
+
+    explicit DeviceSnapshot(std::unique_ptr<unsigned char[]> data, std::shared_ptr<const StringTable> strings);
+
+    const Header& GetHeader() const;
+    const char* GetBlob() const;
+
+    std::unique_ptr<unsigned char[]> data;
+    std::shared_ptr<const StringTable> strings;
+};
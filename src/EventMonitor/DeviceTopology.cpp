@@ -0,0 +1,290 @@
+#include <EventMonitor/DeviceTopology.h>
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+// *** Public ***
+
+void DeviceTopology::Build(const DeviceEnumerator& enumerator) {
+    Clear();
+    for (const Device& device : enumerator.Borrowed()) {
+        Insert(device);
+    }
+}
+
+DeviceTopology::NodeId DeviceTopology::Insert(const Device& device) {
+    const auto syspath = device.GetSyspathView();
+    if (!syspath) {
+        throw std::invalid_argument("Failed to insert device in DeviceTopology : Device has no syspath!");
+    }
+
+    std::string key(*syspath);
+    if (const auto it = index.find(key); it != index.end()) {
+        nodes[it->second].subsystem = InternSubsystem(device.GetSubsystemView());
+        return it->second;
+    }
+
+    // Inserting the parent first stops at the first ancestor already known.
+    // Without sysfs, a detached device can only hang from the closest ancestor known so far.
+    NodeId parent = none;
+    if (const auto parentDevice = device.GetParent()) {
+        parent = Insert(*parentDevice);
+    }
+    else if (device.IsDetached()) {
+        parent = FindAncestor(key);
+    }
+    return Insert(key, device.GetSubsystemView(), parent, device.IsDetached());
+}
+
+std::vector<std::string> DeviceTopology::Erase(std::string_view syspath) {
+    std::vector<std::string> erased;
+    const auto root = Find(syspath);
+    if (!root) {
+        return erased;
+    }
+
+    Unlink(*root);
+    for (NodeId node = *root; node != none; node = GetNextInSubtree(node, *root)) {
+        erased.push_back(*nodes[node].syspath);
+    }
+    // The walk reads the links, free the nodes once it is done.
+    for (const std::string& erasedSyspath : erased) {
+        const auto it = index.find(erasedSyspath);
+        guessedNodes -= nodes[it->second].guessedParent ? 1 : 0;
+        freeNodes.push_back(it->second);
+        index.erase(it);
+    }
+    return erased;
+}
+
+std::vector<std::string> DeviceTopology::Apply(const Device& device) {
+    return Apply(device.GetAction().value_or(SD_DEVICE_ADD), device);
+}
+
+std::vector<std::string> DeviceTopology::Apply(sd_device_action_t action, const Device& device) {
+    const auto syspath = device.GetSyspathView();
+    if (!syspath) {
+        return {};
+    }
+    if (action == SD_DEVICE_REMOVE) {
+        return Erase(*syspath);
+    }
+
+    if (action == SD_DEVICE_MOVE) {
+        const auto oldDevpath = device.GetPropertyView("DEVPATH_OLD");
+        const auto node = oldDevpath ? Find("/sys" + std::string(*oldDevpath)) : std::nullopt;
+        if (node) {
+            // Children move along with the device, keep the subtree and only rename it.
+            std::vector<std::string> erased = Erase(*syspath);
+            Unlink(*node);
+            const std::string newSyspath(*syspath);
+            Rename(*node, GetSyspath(*node), newSyspath);
+            nodes[*node].subsystem = InternSubsystem(device.GetSubsystemView());
+            const auto parentDevice = device.GetParent();
+            NodeId parent = none;
+            if (parentDevice) {
+                parent = Insert(*parentDevice);
+            }
+            else if (device.IsDetached()) {
+                parent = FindAncestor(newSyspath);
+            }
+            guessedNodes -= nodes[*node].guessedParent ? 1 : 0;
+            nodes[*node].guessedParent = !parentDevice && device.IsDetached();
+            guessedNodes += nodes[*node].guessedParent ? 1 : 0;
+            Link(*node, parent);
+            return erased;
+        }
+    }
+
+    Insert(device);
+    return {};
+}
+
+void DeviceTopology::Clear() {
+    nodes.clear();
+    freeNodes.clear();
+    firstRoot = none;
+    guessedNodes = 0;
+    index.clear();
+    subsystems.clear();
+}
+
+std::optional<DeviceTopology::NodeId> DeviceTopology::Find(std::string_view syspath) const {
+    const auto it = index.find(std::string(syspath));
+    return (it != index.end()) ? std::make_optional(it->second) : std::nullopt;
+}
+
+std::vector<DeviceTopology::NodeId> DeviceTopology::GetRoots() const {
+    std::vector<NodeId> roots;
+    for (NodeId root = firstRoot; root != none; root = nodes[root].nextSibling) {
+        roots.push_back(root);
+    }
+    return roots;
+}
+
+std::optional<std::string_view> DeviceTopology::GetSubsystem(NodeId node) const {
+    const uint16_t subsystem = nodes[node].subsystem;
+    return (subsystem != noSubsystem) ? std::make_optional<std::string_view>(subsystems[subsystem]) : std::nullopt;
+}
+
+std::optional<DeviceTopology::NodeId> DeviceTopology::GetParent(NodeId node) const {
+    const NodeId parent = nodes[node].parent;
+    return (parent != none) ? std::make_optional(parent) : std::nullopt;
+}
+
+std::vector<DeviceTopology::NodeId> DeviceTopology::GetChildren(NodeId node) const {
+    std::vector<NodeId> children;
+    for (NodeId child = nodes[node].firstChild; child != none; child = nodes[child].nextSibling) {
+        children.push_back(child);
+    }
+    return children;
+}
+
+std::vector<DeviceTopology::NodeId> DeviceTopology::GetDescendants(NodeId node, std::string_view subsystem) const {
+    std::vector<NodeId> descendants;
+    const uint16_t filter = subsystem.empty() ? noSubsystem : FindSubsystem(subsystem);
+    if (!subsystem.empty() && filter == noSubsystem) {
+        return descendants;
+    }
+    for (NodeId descendant = GetNextInSubtree(node, node); descendant != none; descendant = GetNextInSubtree(descendant, node)) {
+        if (subsystem.empty() || nodes[descendant].subsystem == filter) {
+            descendants.push_back(descendant);
+        }
+    }
+    return descendants;
+}
+
+std::vector<DeviceTopology::NodeId> DeviceTopology::GetAncestors(NodeId node, std::string_view subsystem) const {
+    std::vector<NodeId> ancestors;
+    const uint16_t filter = subsystem.empty() ? noSubsystem : FindSubsystem(subsystem);
+    if (!subsystem.empty() && filter == noSubsystem) {
+        return ancestors;
+    }
+    for (NodeId ancestor = nodes[node].parent; ancestor != none; ancestor = nodes[ancestor].parent) {
+        if (subsystem.empty() || nodes[ancestor].subsystem == filter) {
+            ancestors.push_back(ancestor);
+        }
+    }
+    return ancestors;
+}
+
+// *** Private ***
+
+DeviceTopology::NodeId DeviceTopology::Insert(const std::string& syspath, std::optional<std::string_view> subsystem, NodeId parent, bool guessedParent) {
+    NodeId node = none;
+    if (!freeNodes.empty()) {
+        node = freeNodes.back();
+        freeNodes.pop_back();
+    }
+    else {
+        if (nodes.size() >= none) {
+            throw std::runtime_error("Failed to insert device in DeviceTopology : Too many devices!");
+        }
+        node = static_cast<NodeId>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    const auto [it, inserted] = index.emplace(syspath, node);
+    (void) inserted; // Callers checked the syspath is new.
+    nodes[node] = Node{ &it->first, none, none, none, none, InternSubsystem(subsystem), guessedParent };
+
+    // Detached devices inserted before this ancestor of theirs hang from a higher node, adopt them.
+    // Every other node knows its exact parent, so the siblings are only scanned when there are such devices.
+    if (guessedNodes > 0) {
+        const std::string prefix = syspath + "/";
+        NodeId sibling = (parent != none) ? nodes[parent].firstChild : firstRoot;
+        while (sibling != none) {
+            const NodeId next = nodes[sibling].nextSibling;
+            if (nodes[sibling].guessedParent && nodes[sibling].syspath->compare(0, prefix.size(), prefix) == 0) {
+                Unlink(sibling);
+                Link(sibling, node);
+            }
+            sibling = next;
+        }
+    }
+    guessedNodes += guessedParent ? 1 : 0;
+
+    Link(node, parent);
+    return node;
+}
+
+DeviceTopology::NodeId DeviceTopology::FindAncestor(std::string_view syspath) const {
+    std::string candidate(syspath);
+    for (auto slash = candidate.rfind('/'); slash != std::string::npos && slash > 0; slash = candidate.rfind('/')) {
+        candidate.resize(slash);
+        if (const auto it = index.find(candidate); it != index.end()) {
+            return it->second;
+        }
+    }
+    return none;
+}
+
+DeviceTopology::NodeId DeviceTopology::GetNextInSubtree(NodeId node, NodeId root) const {
+    if (nodes[node].firstChild != none) {
+        return nodes[node].firstChild;
+    }
+    for (; node != root; node = nodes[node].parent) {
+        if (nodes[node].nextSibling != none) {
+            return nodes[node].nextSibling;
+        }
+    }
+    return none;
+}
+
+void DeviceTopology::Link(NodeId node, NodeId parent) {
+    NodeId& first = (parent != none) ? nodes[parent].firstChild : firstRoot;
+    nodes[node].parent = parent;
+    nodes[node].previousSibling = none;
+    nodes[node].nextSibling = first;
+    if (first != none) {
+        nodes[first].previousSibling = node;
+    }
+    first = node;
+}
+
+void DeviceTopology::Unlink(NodeId node) {
+    Node& unlinked = nodes[node];
+    if (unlinked.previousSibling != none) {
+        nodes[unlinked.previousSibling].nextSibling = unlinked.nextSibling;
+    }
+    else {
+        NodeId& first = (unlinked.parent != none) ? nodes[unlinked.parent].firstChild : firstRoot;
+        first = unlinked.nextSibling;
+    }
+    if (unlinked.nextSibling != none) {
+        nodes[unlinked.nextSibling].previousSibling = unlinked.previousSibling;
+    }
+    unlinked.parent = none;
+    unlinked.previousSibling = none;
+    unlinked.nextSibling = none;
+}
+
+void DeviceTopology::Rename(NodeId root, std::string_view oldSyspath, const std::string& newSyspath) {
+    // The views into the keys are invalidated by the renaming.
+    const std::string oldPrefix(oldSyspath);
+    for (NodeId node = root; node != none; node = GetNextInSubtree(node, root)) {
+        auto handle = index.extract(*nodes[node].syspath);
+        handle.key() = newSyspath + handle.key().substr(oldPrefix.size());
+        nodes[node].syspath = &index.insert(std::move(handle)).position->first;
+    }
+}
+
+uint16_t DeviceTopology::InternSubsystem(std::optional<std::string_view> subsystem) {
+    if (!subsystem) {
+        return noSubsystem;
+    }
+    const uint16_t id = FindSubsystem(*subsystem);
+    if (id != noSubsystem) {
+        return id;
+    }
+    if (subsystems.size() >= noSubsystem) {
+        throw std::runtime_error("Failed to insert device in DeviceTopology : Too many subsystems!");
+    }
+    subsystems.emplace_back(*subsystem);
+    return static_cast<uint16_t>(subsystems.size() - 1);
+}
+
+uint16_t DeviceTopology::FindSubsystem(std::string_view subsystem) const {
+    const auto it = std::find(subsystems.begin(), subsystems.end(), subsystem);
+    return (it != subsystems.end()) ? static_cast<uint16_t>(it - subsystems.begin()) : noSubsystem;
+}
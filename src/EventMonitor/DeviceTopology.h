@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+
+extern "C" {
+    #include <systemd/sd-device.h>
+}
+
+// Parent/child graph of the devices, e.g. the partitions and block devices behind a USB hub.
+//
+// Nodes live in a flat vector and link to each other by index : parent, first child and siblings. Inserting or
+// erasing a node is O(1) once its parent is known, walking a subtree is O(subtree) and never touches sysfs.
+// Build() it once from a DeviceEnumerator, then Apply() every event of a DeviceMonitor to keep it current.
+// Node ids of erased devices are reused. Not thread-safe.
+class DeviceTopology {
+public:
+    using NodeId = uint32_t;
+
+    explicit DeviceTopology() = default;
+    ~DeviceTopology() = default;
+    DeviceTopology(const DeviceTopology&) = delete;
+    DeviceTopology(DeviceTopology&&) noexcept = default;
+    DeviceTopology& operator=(const DeviceTopology&) = delete;
+    DeviceTopology& operator=(DeviceTopology&&) noexcept = default;
+
+    // Replace the content of the topology with the devices of the enumerator and their ancestors.
+    void Build(const DeviceEnumerator& enumerator);
+    // Add the device below its closest known ancestor, along with its missing ancestors when it is not detached.
+    // A device already present keeps its node, its subsystem is updated.
+    NodeId Insert(const Device& device);
+    // Erase the device and its whole subtree, returns the erased syspaths, the device first.
+    std::vector<std::string> Erase(std::string_view syspath);
+    // Apply a DeviceMonitor event : remove erases the subtree, move renames it, any other action inserts the device.
+    // Returns the erased syspaths.
+    std::vector<std::string> Apply(const Device& device);
+    std::vector<std::string> Apply(sd_device_action_t action, const Device& device);
+    void Clear();
+
+    std::optional<NodeId> Find(std::string_view syspath) const;
+    // Nodes without parent.
+    std::vector<NodeId> GetRoots() const;
+    std::string_view GetSyspath(NodeId node) const { return *nodes[node].syspath; }
+    std::optional<std::string_view> GetSubsystem(NodeId node) const;
+    std::optional<NodeId> GetParent(NodeId node) const;
+    std::vector<NodeId> GetChildren(NodeId node) const;
+    // Nodes below the node, depth first, only the ones of the subsystem unless it is empty.
+    std::vector<NodeId> GetDescendants(NodeId node, std::string_view subsystem = {}) const;
+    // Nodes above the node, closest first, only the ones of the subsystem unless it is empty.
+    std::vector<NodeId> GetAncestors(NodeId node, std::string_view subsystem = {}) const;
+
+    std::size_t GetSize() const { return index.size(); }
+
+private:
+    static constexpr NodeId none = UINT32_MAX;
+    static constexpr uint16_t noSubsystem = UINT16_MAX;
+
+    struct Node {
+        // Key of the node in the index, stable since unordered_map never moves its keys.
+        const std::string* syspath;
+        NodeId parent;
+        NodeId firstChild;
+        NodeId previousSibling;
+        NodeId nextSibling;
+        uint16_t subsystem;
+        // Detached devices only know their closest ancestor already in the topology, see Insert().
+        bool guessedParent;
+    };
+
+    NodeId Insert(const std::string& syspath, std::optional<std::string_view> subsystem, NodeId parent, bool guessedParent);
+    // Closest node whose syspath is a prefix of the syspath, none if there is none.
+    NodeId FindAncestor(std::string_view syspath) const;
+    // Next node of a depth first walk of the subtree of root, none once done.
+    NodeId GetNextInSubtree(NodeId node, NodeId root) const;
+    void Link(NodeId node, NodeId parent);
+    void Unlink(NodeId node);
+    // Replace the syspath prefix of the node and its subtree, the nodes keep their ids.
+    void Rename(NodeId node, std::string_view oldSyspath, const std::string& newSyspath);
+    // Subsystems are a small vocabulary, interned as 16 bits ids.
+    uint16_t InternSubsystem(std::optional<std::string_view> subsystem);
+    // noSubsystem if the topology has no node of that subsystem.
+    uint16_t FindSubsystem(std::string_view subsystem) const;
+
+    std::vector<Node> nodes;
+    std::vector<NodeId> freeNodes;
+    // Roots are siblings of each other, like the children of a node.
+    NodeId firstRoot = none;
+    std::size_t guessedNodes = 0;
+    std::unordered_map<std::string, NodeId> index;
+    std::vector<std::string> subsystems;
+};
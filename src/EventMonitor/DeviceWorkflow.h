@@ -0,0 +1,29 @@
+#pragma once
+
+// C++20 coroutine support, for code built with coroutines enabled. The library itself only needs C++17.
+#if defined(__cpp_impl_coroutine)
+
+#include <coroutine>
+#include <exception>
+#include <EventMonitor/DeviceMonitor.h>
+
+// Return type of a fire-and-forget coroutine awaiting devices, e.g.
+//
+//     DeviceWorkflow WaitForFilesystem(DeviceMonitor& monitor) {
+//         auto disk = co_await monitor.Next([](const Device& device) { return device.GetAction() == SD_DEVICE_ADD; });
+//         auto formatted = co_await monitor.WaitFor([](const Device& device) { ... }, std::chrono::seconds(5));
+//     }
+//
+// The coroutine runs until its first co_await when called, then from the event loop dispatch of the monitor.
+// Its frame is freed once it returns. It must not throw.
+struct DeviceWorkflow {
+    struct promise_type {
+        DeviceWorkflow get_return_object() noexcept { return {}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { std::terminate(); }
+    };
+};
+
+#endif // __cpp_impl_coroutine
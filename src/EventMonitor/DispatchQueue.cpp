@@ -0,0 +1,217 @@
+#include <EventMonitor/DispatchQueue.h>
+#include <EventMonitor/ThreadUtils.h>
+#include <stdexcept>
+
+namespace {
+    // Number of empty polls a consumer spins through before going to sleep.
+    constexpr int spinsBeforeSleep = 64;
+}
+
+// *** Public ***
+
+DispatchQueue::DispatchQueue(std::size_t capacity, std::size_t consumerCount, DeviceHandler deviceHandler, const std::vector<int>& cpuAffinity,
+                             OverflowPolicy overflowPolicy)
+    : buffer(capacity),
+      handler(std::move(deviceHandler)),
+      policy(overflowPolicy),
+      stopping(false),
+      droppedCount(0),
+      evictedCount(0),
+      blockedCount(0),
+      coalescedCount(0),
+      hasCoalesced(false),
+      sleepingConsumers(0) {
+    if (!handler) {
+        throw std::invalid_argument("Failed to create DispatchQueue : Handler cannot be null!");
+    }
+    if (consumerCount == 0) {
+        throw std::invalid_argument("Failed to create DispatchQueue : Consumer count cannot be 0!");
+    }
+
+    consumers.reserve(consumerCount);
+    try {
+        for (std::size_t i = 0; i < consumerCount; ++i) {
+            consumers.emplace_back(&DispatchQueue::ConsumerLoop, this);
+            if (!cpuAffinity.empty()) {
+                SetThreadAffinity(consumers.back(), { cpuAffinity[i % cpuAffinity.size()] });
+            }
+        }
+    }
+    catch (...) {
+        Stop();
+        throw;
+    }
+}
+
+DispatchQueue::~DispatchQueue() {
+    Stop();
+}
+
+bool DispatchQueue::TryPush(Device&& device) {
+    if (stopping.load(std::memory_order_relaxed) || !buffer.TryPush(std::move(device))) {
+        return false;
+    }
+
+    WakeConsumer();
+    return true;
+}
+
+void DispatchQueue::Push(Device device) {
+    // Consumers may already be gone, a coalesced device would never be handled.
+    if (stopping.load(std::memory_order_acquire)) {
+        droppedCount.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (policy == OverflowPolicy::CoalescePerDevice && hasCoalesced.load(std::memory_order_acquire)) {
+        Coalesce(std::move(device));
+        return;
+    }
+    if (TryPush(std::move(device))) {
+        return;
+    }
+
+    switch (policy) {
+        case OverflowPolicy::DropNewest:
+            break;
+        case OverflowPolicy::DropOldest:
+            // Consumers may race us to the freed slot, evict until the device fits.
+            while (!stopping.load(std::memory_order_relaxed)) {
+                if (buffer.TryPop()) {
+                    evictedCount.fetch_add(1, std::memory_order_relaxed);
+                }
+                if (TryPush(std::move(device))) {
+                    return;
+                }
+            }
+            break;
+        case OverflowPolicy::Block:
+            blockedCount.fetch_add(1, std::memory_order_relaxed);
+            while (!stopping.load(std::memory_order_relaxed)) {
+                WakeConsumer();
+                std::this_thread::yield();
+                if (TryPush(std::move(device))) {
+                    return;
+                }
+            }
+            break;
+        case OverflowPolicy::CoalescePerDevice:
+            if (!stopping.load(std::memory_order_relaxed)) {
+                Coalesce(std::move(device));
+                return;
+            }
+            break;
+    }
+    droppedCount.fetch_add(1, std::memory_order_relaxed);
+}
+
+DispatchQueue::Stats DispatchQueue::GetStats() const {
+    return Stats{
+        droppedCount.load(std::memory_order_relaxed),
+        evictedCount.load(std::memory_order_relaxed),
+        blockedCount.load(std::memory_order_relaxed),
+        coalescedCount.load(std::memory_order_relaxed)
+    };
+}
+
+void DispatchQueue::Stop() {
+    if (stopping.exchange(true)) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_all();
+    }
+
+    for (auto& consumer : consumers) {
+        if (consumer.joinable()) {
+            consumer.join();
+        }
+    }
+}
+
+// *** Private ***
+
+void DispatchQueue::ConsumerLoop() {
+    int idleSpins = 0;
+    for (;;) {
+        if (auto device = buffer.TryPop()) {
+            idleSpins = 0;
+            handler(std::move(*device));
+            continue;
+        }
+        if (hasCoalesced.load(std::memory_order_acquire)) {
+            if (auto device = TakeCoalesced()) {
+                idleSpins = 0;
+                handler(std::move(*device));
+                continue;
+            }
+        }
+
+        // Only leave once the queue is drained.
+        if (stopping.load(std::memory_order_acquire)) {
+            if (buffer.IsEmpty() && !hasCoalesced.load(std::memory_order_acquire)) {
+                return;
+            }
+            continue;
+        }
+
+        if (++idleSpins < spinsBeforeSleep) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Announced before the last check, so a producer pushing after it sees a sleeper to wake.
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepingConsumers.fetch_add(1);
+        wakeUp.wait(lock, [this]() {
+            return !buffer.IsEmpty() || hasCoalesced.load(std::memory_order_acquire) || stopping.load(std::memory_order_acquire);
+        });
+        sleepingConsumers.fetch_sub(1);
+        idleSpins = 0;
+    }
+}
+
+void DispatchQueue::WakeConsumer() {
+    // Orders the push before the load, against the consumer announcing itself before its last check.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleepingConsumers.load() > 0) {
+        // Under the lock, an announced consumer is already waiting rather than between its last check and its wait.
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        wakeUp.notify_one();
+    }
+}
+
+void DispatchQueue::Coalesce(Device device) {
+    std::string syspath(device.GetSyspathView().value_or(std::string_view()));
+
+    {
+        std::lock_guard<std::mutex> lock(coalescedMutex);
+        auto it = coalescedDevices.find(syspath);
+        if (it != coalescedDevices.end()) {
+            it->second = std::move(device);
+            coalescedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        else {
+            coalescedOrder.push_back(syspath);
+            coalescedDevices.emplace(std::move(syspath), std::move(device));
+        }
+        hasCoalesced.store(true, std::memory_order_release);
+    }
+
+    WakeConsumer();
+}
+
+std::optional<Device> DispatchQueue::TakeCoalesced() {
+    std::lock_guard<std::mutex> lock(coalescedMutex);
+    if (coalescedOrder.empty()) {
+        return std::nullopt;
+    }
+
+    auto node = coalescedDevices.extract(coalescedOrder.front());
+    coalescedOrder.pop_front();
+    if (coalescedOrder.empty()) {
+        hasCoalesced.store(false, std::memory_order_release);
+    }
+    return std::move(node.mapped());
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/RingBuffer.h>
+
+// Hands devices over from the event loop thread to dedicated consumer threads.
+//
+// Push() never blocks nor allocates : it moves the device into a bounded lock-free ring buffer and,
+// only if a consumer is asleep, wakes it up. What happens when the buffer is full depends on the OverflowPolicy.
+class DispatchQueue {
+public:
+    using DeviceHandler = std::function<void(Device)>;
+
+    enum class OverflowPolicy {
+        // Drop the pushed device.
+        DropNewest,
+        // Drop the oldest queued devices until the pushed one fits.
+        DropOldest,
+        // Wait for the consumers to make room, stalling the producer (and the kernel socket behind it).
+        Block,
+        // Keep only the latest device per syspath in an overflow area, drained once the buffer is empty.
+        // Devices keep being coalesced until the overflow area is drained, to preserve their order.
+        CoalescePerDevice
+    };
+
+    struct Stats {
+        uint64_t droppedNewest;
+        uint64_t droppedOldest;
+        // Pushes which had to wait for room.
+        uint64_t blocked;
+        // Devices replaced by a later one of the same syspath.
+        uint64_t coalesced;
+    };
+
+    // Consumer i is pinned to cpuAffinity[i % cpuAffinity.size()] when cpuAffinity is not empty.
+    explicit DispatchQueue(std::size_t capacity, std::size_t consumerCount, DeviceHandler handler, const std::vector<int>& cpuAffinity = {},
+                           OverflowPolicy policy = OverflowPolicy::DropNewest);
+    // Stop() the queue.
+    ~DispatchQueue();
+    DispatchQueue(const DispatchQueue&) = delete;
+    DispatchQueue(DispatchQueue&&) = delete;
+    DispatchQueue& operator=(const DispatchQueue&) = delete;
+    DispatchQueue& operator=(DispatchQueue&&) = delete;
+
+    // Returns false, leaving the device untouched, if the queue is full.
+    bool TryPush(Device&& device);
+    // Queue the device, applying the overflow policy if the queue is full.
+    void Push(Device device);
+
+    // Let the consumers drain the queue, then join them. Devices pushed afterwards are dropped.
+    void Stop();
+
+    std::size_t GetCapacity() const { return buffer.GetCapacity(); }
+    std::size_t GetDepth() const { return buffer.GetSize(); }
+    OverflowPolicy GetOverflowPolicy() const { return policy; }
+    // Devices lost, whichever end they were dropped from.
+    uint64_t GetDroppedCount() const {
+        return droppedCount.load(std::memory_order_relaxed) + evictedCount.load(std::memory_order_relaxed);
+    }
+    Stats GetStats() const;
+
+private:
+    void ConsumerLoop();
+    void WakeConsumer();
+    // Store the device in the overflow area, replacing the pending one with the same syspath.
+    void Coalesce(Device device);
+    std::optional<Device> TakeCoalesced();
+
+    RingBuffer<Device> buffer;
+    DeviceHandler handler;
+    const OverflowPolicy policy;
+
+    std::atomic<bool> stopping;
+    std::atomic<uint64_t> droppedCount;
+    std::atomic<uint64_t> evictedCount;
+    std::atomic<uint64_t> blockedCount;
+    std::atomic<uint64_t> coalescedCount;
+
+    // Overflow area of OverflowPolicy::CoalescePerDevice, in arrival order of the syspaths.
+    std::atomic<bool> hasCoalesced;
+    std::mutex coalescedMutex;
+    std::unordered_map<std::string, Device> coalescedDevices;
+    std::deque<std::string> coalescedOrder;
+
+    // Idle consumers sleep on the condition variable, producers only notify when someone is asleep.
+    std::atomic<std::size_t> sleepingConsumers;
+    std::mutex sleepMutex;
+    std::condition_variable wakeUp;
+
+    std::vector<std::thread> consumers;
+};
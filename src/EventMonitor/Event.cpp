@@ -1,11 +1,198 @@
 #include <EventMonitor/Event.h>
 #include <stdexcept>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
-Event::Event() 
-: eventLoop(nullptr, &sd_event_unref) {
+// *** Public ***
+
+Event::Event(LoopType type) 
+: loopType(type),
+  eventLoop(nullptr, &sd_event_unref),
+  dispatcher(std::make_shared<Dispatcher>()) {
     sd_event* eventLoopTemp = nullptr;
-    if (sd_event_default(&eventLoopTemp) < 0 || !eventLoopTemp) {
+    const int result = (loopType == LoopType::New) ? sd_event_new(&eventLoopTemp) : sd_event_default(&eventLoopTemp);
+    if (result < 0 || !eventLoopTemp) {
         throw std::runtime_error("Failed to create an Event!");
     }
     eventLoop.reset(eventLoopTemp);
-}
\ No newline at end of file
+
+    dispatcher->wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (dispatcher->wakeupFd < 0) {
+        throw std::runtime_error("Failed to create an Event : eventfd failed!");
+    }
+    sd_event_source* sourceTemp = nullptr;
+    if (sd_event_add_io(eventLoop.get(), &sourceTemp, dispatcher->wakeupFd, EPOLLIN, &Event::OnWakeup, dispatcher.get()) < 0 || !sourceTemp) {
+        throw std::runtime_error("Failed to create an Event : sd_event_add_io failed!");
+    }
+    dispatcher->wakeupSource.reset(sourceTemp);
+}
+
+Event::~Event() {
+    if (IsInLoopThread()) {
+        // The thread cannot join itself.
+        dispatcher->stopRequested = true;
+        dispatcher->thread.detach();
+        return;
+    }
+    Stop();
+}
+
+void Event::RunInBackground(const ThreadOptions& options) {
+    if (IsRunningInBackground()) {
+        throw std::runtime_error("Failed to run Event in background : Already running!");
+    }
+    if (loopType != LoopType::New) {
+        throw std::runtime_error("Failed to run Event in background : The default loop can only run on the thread which created it!");
+    }
+
+    dispatcher->stopRequested = false;
+    // Set before starting the thread, so Invoke() never runs a task inline while the loop thread runs.
+    {
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        dispatcher->running = true;
+    }
+    try {
+        dispatcher->thread = std::thread(&Event::RunLoop, sd_event_ref(eventLoop.get()), dispatcher);
+    }
+    catch (...) {
+        sd_event_unref(eventLoop.get());
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        dispatcher->running = false;
+        throw;
+    }
+    try {
+        ApplyThreadOptions(dispatcher->thread, options);
+    }
+    catch (...) {
+        Stop();
+        throw;
+    }
+}
+
+void Event::Stop() {
+    if (!IsRunningInBackground()) {
+        return;
+    }
+    if (IsInLoopThread()) {
+        throw std::runtime_error("Failed to stop Event : Cannot join the loop thread from itself!");
+    }
+
+    dispatcher->stopRequested = true;
+    dispatcher->Wakeup();
+    dispatcher->thread.join();
+}
+
+void Event::Post(Task task) {
+    if (!task) {
+        throw std::invalid_argument("Failed to post task : Task cannot be null!");
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        dispatcher->tasks.push_back(std::move(task));
+    }
+    dispatcher->Wakeup();
+}
+
+void Event::Invoke(const Task& task) {
+    if (!task) {
+        throw std::invalid_argument("Failed to invoke task : Task cannot be null!");
+    }
+    if (IsInLoopThread()) {
+        task();
+        return;
+    }
+
+    // Queued under the mutex, so a loop thread being stopped either runs the task before leaving or is already gone.
+    std::promise<void> done;
+    bool queued = false;
+    {
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        if (dispatcher->running) {
+            dispatcher->tasks.push_back([&task, &done]() {
+                try {
+                    task();
+                    done.set_value();
+                }
+                catch (...) {
+                    done.set_exception(std::current_exception());
+                }
+            });
+            queued = true;
+        }
+    }
+    if (!queued) {
+        task();
+        return;
+    }
+    dispatcher->Wakeup();
+    done.get_future().get();
+}
+
+// *** Private ***
+
+Event::Dispatcher::~Dispatcher() {
+    // Release the source before closing the descriptor it watches.
+    wakeupSource.reset();
+    if (wakeupFd >= 0) {
+        close(wakeupFd);
+    }
+}
+
+void Event::Dispatcher::Wakeup() const {
+    const uint64_t one = 1;
+    // Only fails when the counter would overflow, the loop is then already due to wake up.
+    (void) !write(wakeupFd, &one, sizeof(one));
+}
+
+int Event::OnWakeup(sd_event_source* source, int fd, uint32_t revents, void* userdata) {
+    (void) source;
+    (void) revents;
+
+    uint64_t count = 0;
+    (void) !read(fd, &count, sizeof(count));
+
+    auto* dispatcher = static_cast<Dispatcher*>(userdata);
+    std::vector<Task> tasks;
+    {
+        std::lock_guard<std::mutex> lock(dispatcher->mutex);
+        tasks.swap(dispatcher->tasks);
+    }
+    for (auto& task : tasks) {
+        task();
+    }
+    return 0;
+}
+
+void Event::RunLoop(sd_event* event, std::shared_ptr<Dispatcher> dispatcher) {
+    const std::unique_ptr<sd_event, decltype(&sd_event_unref)> eventRef(event, &sd_event_unref);
+    dispatcher->loopThread = std::this_thread::get_id();
+
+    // sd_event_run() fails once sd_event_exit() finished the loop, which then can never run again.
+    while (!dispatcher->stopRequested.load()) {
+        if (sd_event_run(event, UINT64_MAX) < 0) {
+            break;
+        }
+    }
+
+    // Run what was posted before leaving, including what those tasks post, so no Invoke() waits forever.
+    for (;;) {
+        std::vector<Task> tasks;
+        {
+            std::lock_guard<std::mutex> lock(dispatcher->mutex);
+            if (dispatcher->tasks.empty()) {
+                dispatcher->running = false;
+                break;
+            }
+            tasks.swap(dispatcher->tasks);
+        }
+        for (auto& task : tasks) {
+            task();
+        }
+    }
+
+    dispatcher->loopThread = std::thread::id();
+}
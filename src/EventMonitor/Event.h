@@ -1,24 +1,85 @@
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <EventMonitor/ThreadUtils.h>
 
 extern "C" {
     #include <systemd/sd-event.h>
 }
 
-// TODO : Without adding new functionalities, this class could be replaced by directly using std::shared_ptr<sd_event>
-// TODO : However, it does provide the custom destructor implementation and could be used to add new functionalities in the future.
 class Event {
 public:
-    explicit Event();
-    ~Event() = default;
+    using Task = std::function<void()>;
+
+    enum class LoopType {
+        // The default loop of the calling thread (sd_event_default()), shared by every Event created on it.
+        // libsystemd only lets its owner thread run it, so it cannot RunInBackground().
+        Default,
+        // A new independent loop (sd_event_new()), which may run on any one thread.
+        New
+    };
+
+    explicit Event(LoopType loopType = LoopType::Default);
+    // Stop() the loop thread. Released from the loop thread itself, e.g. by a task or a callback, the thread is
+    // detached instead and leaves once the current iteration ends and the posted tasks ran.
+    ~Event();
     Event(const Event&) = delete;
-    Event(Event&&) noexcept = default;
+    // The loop thread and the sources attached to the loop keep pointers to it, share it through a shared_ptr instead.
+    Event(Event&&) = delete;
     Event& operator=(const Event&) = delete;
-    Event& operator=(Event&&) noexcept = default;
+    Event& operator=(Event&&) = delete;
 
     sd_event* GetEvent() const {return eventLoop.get();}
 
+    LoopType GetLoopType() const { return loopType; }
+
+    // Run the loop on a dedicated thread, scheduled according to the options. Requires a LoopType::New loop.
+    // sd_event is not thread-safe : once running, only touch the loop (and the monitors attached to it)
+    // from the loop thread, e.g. through Post().
+    void RunInBackground(const ThreadOptions& options = ThreadOptions());
+    // Wake the loop thread up and join it once its current iteration ends and the posted tasks ran.
+    // The loop can be run again afterwards.
+    // Must not be called from the loop thread.
+    void Stop();
+    bool IsRunningInBackground() const { return dispatcher->thread.joinable(); }
+    bool IsInLoopThread() const { return dispatcher->loopThread.load() == std::this_thread::get_id(); }
+
+    // Run the task on the thread running the loop, background or not. Thread-safe.
+    // Tasks run in order, on the next iteration of the loop. They must not throw.
+    void Post(Task task);
+    // Run the task on the loop thread and wait for it, rethrowing what it throws.
+    // Runs it right away when called from the loop thread or when the loop does not run in background.
+    void Invoke(const Task& task);
+
 private:
+    // Shared with the wakeup source and the loop thread.
+    struct Dispatcher {
+        std::mutex mutex;
+        std::vector<Task> tasks;
+        // Whether the loop thread still takes tasks, guarded by the mutex.
+        bool running = false;
+        // eventfd waking the loop up for posted tasks and stop requests.
+        int wakeupFd = -1;
+        std::unique_ptr<sd_event_source, decltype(&sd_event_source_unref)> wakeupSource{nullptr, &sd_event_source_unref};
+        std::atomic<bool> stopRequested{false};
+        std::atomic<std::thread::id> loopThread{};
+        std::thread thread;
+
+        ~Dispatcher();
+        void Wakeup() const;
+    };
+
+    static int OnWakeup(sd_event_source* source, int fd, uint32_t revents, void* userdata);
+    // Holds its own references, the loop thread may outlive the Event.
+    static void RunLoop(sd_event* event, std::shared_ptr<Dispatcher> dispatcher);
+
+    LoopType loopType;
     std::unique_ptr<sd_event, decltype(&sd_event_unref)> eventLoop;
-};
\ No newline at end of file
+    // Declared last so the loop thread is joined and the source released before the loop.
+    std::shared_ptr<Dispatcher> dispatcher;
+};
@@ -0,0 +1,77 @@
+#include <EventMonitor/EventLoopGroup.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+// *** Public ***
+
+EventLoopGroup::EventLoopGroup(std::size_t loopCount, const ThreadOptions& options)
+    : nextLoop(0) {
+    if (loopCount == 0) {
+        loopCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    loops.reserve(loopCount);
+    for (std::size_t i = 0; i < loopCount; ++i) {
+        ThreadOptions loopOptions = options;
+        if (!options.cpuAffinity.empty()) {
+            loopOptions.cpuAffinity = { options.cpuAffinity[i % options.cpuAffinity.size()] };
+        }
+        if (!options.name.empty()) {
+            loopOptions.name = options.name + std::to_string(i);
+        }
+
+        loops.push_back(std::make_shared<Event>(Event::LoopType::New));
+        try {
+            loops.back()->RunInBackground(loopOptions);
+        }
+        catch (...) {
+            Stop();
+            throw;
+        }
+    }
+}
+
+EventLoopGroup::~EventLoopGroup() {
+    Stop();
+}
+
+std::shared_ptr<DeviceMonitor> EventLoopGroup::AddMonitor(const MonitorSetup& setup) {
+    return AddMonitor(nextLoop.fetch_add(1, std::memory_order_relaxed) % loops.size(), setup);
+}
+
+std::shared_ptr<DeviceMonitor> EventLoopGroup::AddMonitor(std::size_t loopIndex, const MonitorSetup& setup) {
+    if (loopIndex >= loops.size()) {
+        throw std::out_of_range("Failed to add monitor : Invalid loop index!");
+    }
+    if (!setup) {
+        throw std::invalid_argument("Failed to add monitor : Setup cannot be null!");
+    }
+
+    const std::shared_ptr<Event>& loop = loops[loopIndex];
+    DeviceMonitor* monitor = nullptr;
+    loop->Invoke([&loop, &setup, &monitor]() {
+        auto created = std::make_unique<DeviceMonitor>(loop);
+        setup(*created);
+        created->StartMonitoring();
+        monitor = created.release();
+    });
+
+    // The monitor belongs to the loop thread, so does its destruction. The deleter keeps the loop alive until then.
+    // On the loop thread, the last reference may be dropped from the monitor's own dispatch : delete it afterwards.
+    return std::shared_ptr<DeviceMonitor>(monitor, [loop](DeviceMonitor* released) {
+        if (loop->IsInLoopThread()) {
+            loop->Post([released]() { delete released; });
+        }
+        else {
+            loop->Invoke([released]() { delete released; });
+        }
+    });
+}
+
+void EventLoopGroup::Stop() {
+    for (const auto& loop : loops) {
+        loop->Stop();
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <EventMonitor/DeviceMonitor.h>
+#include <EventMonitor/Event.h>
+#include <EventMonitor/ThreadUtils.h>
+
+// Independent event loops (LoopType::New), each one running on its own background thread.
+//
+// DeviceMonitors are spread over the loops, e.g. one per subsystem or per filter set, so every monitor receives,
+// filters and dispatches its events on its own core instead of all of them serializing on a single loop.
+class EventLoopGroup {
+public:
+    // Called on the loop thread, before monitoring starts, to set the callback and filters of the monitor.
+    using MonitorSetup = std::function<void(DeviceMonitor&)>;
+
+    // A loopCount of 0 runs one loop per hardware thread.
+    // Loop i is pinned to options.cpuAffinity[i % options.cpuAffinity.size()] when it is not empty,
+    // and named options.name followed by its index.
+    explicit EventLoopGroup(std::size_t loopCount = 0, const ThreadOptions& options = ThreadOptions());
+    // Stop() the loops.
+    ~EventLoopGroup();
+    EventLoopGroup(const EventLoopGroup&) = delete;
+    EventLoopGroup(EventLoopGroup&&) = delete;
+    EventLoopGroup& operator=(const EventLoopGroup&) = delete;
+    EventLoopGroup& operator=(EventLoopGroup&&) = delete;
+
+    std::size_t GetLoopCount() const { return loops.size(); }
+    const std::shared_ptr<Event>& GetLoop(std::size_t index) const { return loops.at(index); }
+
+    // Create a monitor on the given loop, or on the next one round-robin, then set it up and start it there.
+    // The monitor must only be used from its loop thread afterwards (see GetEvent()->Invoke()).
+    // Releasing the last reference stops and destroys it on its loop thread.
+    std::shared_ptr<DeviceMonitor> AddMonitor(const MonitorSetup& setup);
+    std::shared_ptr<DeviceMonitor> AddMonitor(std::size_t loopIndex, const MonitorSetup& setup);
+
+    // Stop every loop. Monitors still alive are then destroyed on whichever thread releases them.
+    void Stop();
+
+private:
+    std::vector<std::shared_ptr<Event>> loops;
+    std::atomic<std::size_t> nextLoop;
+};
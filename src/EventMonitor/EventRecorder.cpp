@@ -0,0 +1,118 @@
+#include <EventMonitor/EventRecorder.h>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// *** Public ***
+
+EventRecorder::EventRecorder(const std::string& path, std::size_t recorderBufferSize)
+    : fd(-1),
+      bufferSize(recorderBufferSize),
+      recordCount(0) {
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create EventRecorder : Cannot open " + path + " : " + std::strerror(errno) + "!");
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0) {
+        close(fd);
+        throw std::runtime_error("Failed to create EventRecorder : fstat failed!");
+    }
+
+    if (st.st_size == 0) {
+        EventLog::Header header{};
+        std::memcpy(header.magic, EventLog::magic, sizeof(header.magic));
+        header.version = EventLog::version;
+        Append(header);
+        return;
+    }
+
+    EventLog::Header header{};
+    if (pread(fd, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)) ||
+        std::memcmp(header.magic, EventLog::magic, sizeof(header.magic)) != 0 || header.version != EventLog::version) {
+        close(fd);
+        throw std::runtime_error("Failed to create EventRecorder : " + path + " is not a compatible event log!");
+    }
+}
+
+EventRecorder::~EventRecorder() {
+    try {
+        Flush();
+    }
+    catch (...) {
+        // Nothing sensible to do from a destructor, the tail of the log is lost.
+    }
+    close(fd);
+}
+
+void EventRecorder::Record(const Device& device) {
+    timespec now{};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    Record(device, std::chrono::microseconds(static_cast<int64_t>(now.tv_sec) * 1000000 + now.tv_nsec / 1000));
+}
+
+void EventRecorder::Record(const Device& device, std::chrono::microseconds timestamp) {
+    const DeviceProperties properties = device.GetAllProperties();
+
+    std::size_t size = 0;
+    for (const auto& [key, value] : properties) {
+        size += 2 * sizeof(uint32_t) + key.size() + value.size();
+    }
+    if (size > std::numeric_limits<uint32_t>::max()) {
+        throw std::runtime_error("Failed to record device : Properties are too large!");
+    }
+
+    const auto action = device.GetAction();
+    EventLog::Record record{};
+    record.size = static_cast<uint32_t>(size);
+    record.propertyCount = static_cast<uint32_t>(properties.GetSize());
+    record.seqnum = device.GetSeqnum().value_or(0);
+    record.timestamp = static_cast<uint64_t>(timestamp.count());
+    record.action = action ? static_cast<int32_t>(*action) : EventLog::noAction;
+
+    Append(record);
+    for (const auto& [key, value] : properties) {
+        Append(static_cast<uint32_t>(key.size()));
+        Append(static_cast<uint32_t>(value.size()));
+        Append(key.data(), key.size());
+        Append(value.data(), value.size());
+    }
+    ++recordCount;
+
+    if (buffer.size() >= bufferSize) {
+        Flush();
+    }
+}
+
+void EventRecorder::Flush() {
+    std::size_t written = 0;
+    while (written < buffer.size()) {
+        const ssize_t result = write(fd, buffer.data() + written, buffer.size() - written);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            buffer.erase(buffer.begin(), buffer.begin() + written);
+            throw std::runtime_error(std::string("Failed to flush EventRecorder : ") + std::strerror(errno) + "!");
+        }
+        written += static_cast<std::size_t>(result);
+    }
+    buffer.clear();
+}
+
+// *** Private ***
+
+template <typename T>
+void EventRecorder::Append(const T& value) {
+    Append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void EventRecorder::Append(const char* data, std::size_t size) {
+    buffer.insert(buffer.end(), data, data + size);
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <EventMonitor/Device.h>
+
+// On-disk layout of an event log, in native byte order since logs are meant to be replayed on the recording host.
+//
+// The file starts with an EventLogHeader, followed by records appended one after the other. Each record is an
+// EventLogRecord followed by its properties, each one being two uint32_t (key and value lengths) then the key and
+// value characters, without terminator.
+namespace EventLog {
+    constexpr char magic[8] = { 'E', 'V', 'M', 'O', 'N', 'L', 'O', 'G' };
+    constexpr uint32_t version = 1;
+    // Action of a record whose device had none.
+    constexpr int32_t noAction = -1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+    };
+
+    struct Record {
+        // Bytes of the properties following this struct.
+        uint32_t size;
+        uint32_t propertyCount;
+        uint64_t seqnum;
+        // CLOCK_MONOTONIC, in microseconds.
+        uint64_t timestamp;
+        int32_t action;
+        uint32_t reserved;
+    };
+}
+
+// Appends received devices to an event log, see EventLog and EventReplayer.
+//
+// Records are buffered in memory and written with a single write() once the buffer is full, on Flush()
+// and on destruction. Not thread-safe.
+class EventRecorder {
+public:
+    // Open the log for appending, creating it if needed. An existing log must have a compatible header.
+    explicit EventRecorder(const std::string& path, std::size_t bufferSize = 1 << 16);
+    // Flush() the buffer.
+    ~EventRecorder();
+    EventRecorder(const EventRecorder&) = delete;
+    EventRecorder(EventRecorder&&) = delete;
+    EventRecorder& operator=(const EventRecorder&) = delete;
+    EventRecorder& operator=(EventRecorder&&) = delete;
+
+    // Record the device with the current CLOCK_MONOTONIC time.
+    void Record(const Device& device);
+    void Record(const Device& device, std::chrono::microseconds timestamp);
+    void Flush();
+
+    uint64_t GetRecordCount() const { return recordCount; }
+
+private:
+    template <typename T>
+    void Append(const T& value);
+    void Append(const char* data, std::size_t size);
+
+    int fd;
+    std::size_t bufferSize;
+    std::vector<char> buffer;
+    uint64_t recordCount;
+};
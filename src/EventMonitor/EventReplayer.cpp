@@ -0,0 +1,196 @@
+#include <EventMonitor/EventReplayer.h>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// *** Public ***
+
+EventReplayer::EventReplayer(const std::string& path)
+    : data(nullptr),
+      size(0) {
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create EventReplayer : Cannot open " + path + " : " + std::strerror(errno) + "!");
+    }
+
+    struct stat st{};
+    if (fstat(fd, &st) < 0 || static_cast<std::size_t>(st.st_size) < sizeof(EventLog::Header)) {
+        close(fd);
+        throw std::runtime_error("Failed to create EventReplayer : " + path + " is not an event log!");
+    }
+    size = static_cast<std::size_t>(st.st_size);
+
+    void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to create EventReplayer : mmap failed!");
+    }
+    data = static_cast<const unsigned char*>(mapping);
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    EventLog::Header header{};
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, EventLog::magic, sizeof(header.magic)) != 0 || header.version != EventLog::version) {
+        munmap(mapping, size);
+        throw std::runtime_error("Failed to create EventReplayer : " + path + " is not a compatible event log!");
+    }
+}
+
+EventReplayer::~EventReplayer() {
+    munmap(const_cast<unsigned char*>(data), size);
+}
+
+std::size_t EventReplayer::Replay(const DeviceSink& sink, Pace pace, double speed) const {
+    if (!sink) {
+        throw std::invalid_argument("Failed to replay : Sink cannot be null!");
+    }
+    if (pace == Pace::Scaled && !(speed > 0)) {
+        throw std::invalid_argument("Failed to replay : Speed must be positive!");
+    }
+    const double scale = (pace == Pace::Scaled) ? speed : 1.0;
+
+    std::size_t replayed = 0;
+    uint64_t firstTimestamp = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    std::size_t offset = sizeof(EventLog::Header);
+    while (const auto record = PeekRecord(offset)) {
+        Device device = ReadRecord(*record, offset);
+        if (pace != Pace::AsFastAsPossible) {
+            if (replayed == 0) {
+                firstTimestamp = record->timestamp;
+            }
+            std::this_thread::sleep_until(start + GetDelay(record->timestamp, firstTimestamp, scale));
+        }
+        sink(std::move(device));
+        ++replayed;
+    }
+
+    return replayed;
+}
+
+std::size_t EventReplayer::Replay(DeviceMonitor& monitor, Pace pace, double speed, ReplayDone done) {
+    if (pacedReplay) {
+        // Cancel the replay in progress but keep its timer, whose callback may be the one calling this.
+        pacedReplay->timer->Disarm();
+        pacedReplay->offset = size;
+        ++pacedReplay->generation;
+    }
+    if (pace == Pace::AsFastAsPossible) {
+        const std::size_t replayed = Replay([&monitor](Device device) { monitor.Inject(std::move(device)); }, pace, speed);
+        if (done) {
+            done();
+        }
+        return replayed;
+    }
+    if (pace == Pace::Scaled && !(speed > 0)) {
+        throw std::invalid_argument("Failed to replay : Speed must be positive!");
+    }
+    if (!monitor.GetEvent()) {
+        throw std::runtime_error("Failed to replay : Event ptr is null!");
+    }
+
+    std::size_t scheduled = 0;
+    for (std::size_t offset = sizeof(EventLog::Header); const auto record = PeekRecord(offset);) {
+        offset += sizeof(EventLog::Record) + record->size;
+        ++scheduled;
+    }
+
+    if (!pacedReplay) {
+        pacedReplay = std::make_unique<PacedReplay>();
+    }
+    if (pacedReplay->loop != monitor.GetEvent().get()) {
+        pacedReplay->timer = std::make_unique<EventTimer>(monitor.GetEvent(), [this]() { OnPacedReplayTimer(); });
+        pacedReplay->loop = monitor.GetEvent().get();
+    }
+    const auto first = PeekRecord(sizeof(EventLog::Header));
+    pacedReplay->monitor = &monitor;
+    pacedReplay->scale = (pace == Pace::Scaled) ? speed : 1.0;
+    pacedReplay->offset = sizeof(EventLog::Header);
+    pacedReplay->firstTimestamp = first ? first->timestamp : 0;
+    pacedReplay->start = std::chrono::steady_clock::now();
+    pacedReplay->done = std::move(done);
+    pacedReplay->timer->Arm(std::chrono::microseconds(0));
+
+    return scheduled;
+}
+
+// *** Private ***
+
+std::optional<EventLog::Record> EventReplayer::PeekRecord(std::size_t offset) const {
+    EventLog::Record record{};
+    if (offset > size || size - offset < sizeof(record)) {
+        return std::nullopt;
+    }
+    std::memcpy(&record, data + offset, sizeof(record));
+    if (size - offset - sizeof(record) < record.size) {
+        return std::nullopt;
+    }
+    return record;
+}
+
+Device EventReplayer::ReadRecord(const EventLog::Record& record, std::size_t& offset) const {
+    // Views into the mapping, DeviceProperties copies them.
+    const unsigned char* cursor = data + offset + sizeof(record);
+    const unsigned char* const end = cursor + record.size;
+    std::vector<DeviceProperties::Property> properties;
+    properties.reserve(record.propertyCount);
+    for (uint32_t i = 0; i < record.propertyCount; ++i) {
+        uint32_t lengths[2];
+        if (static_cast<std::size_t>(end - cursor) < sizeof(lengths)) {
+            throw std::runtime_error("Failed to replay : Corrupted record!");
+        }
+        std::memcpy(lengths, cursor, sizeof(lengths));
+        cursor += sizeof(lengths);
+        if (static_cast<std::size_t>(end - cursor) < std::size_t(lengths[0]) + lengths[1]) {
+            throw std::runtime_error("Failed to replay : Corrupted record!");
+        }
+        const char* key = reinterpret_cast<const char*>(cursor);
+        properties.emplace_back(std::string_view(key, lengths[0]), std::string_view(key + lengths[0], lengths[1]));
+        cursor += std::size_t(lengths[0]) + lengths[1];
+    }
+    offset += sizeof(record) + record.size;
+
+    // The vector becomes the index of the properties, saving a copy.
+    return Device::CreateFromProperties(DeviceProperties(std::move(properties)));
+}
+
+std::chrono::steady_clock::duration EventReplayer::GetDelay(uint64_t timestamp, uint64_t firstTimestamp, double scale) {
+    const uint64_t elapsed = (timestamp > firstTimestamp) ? timestamp - firstTimestamp : 0;
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double, std::micro>(elapsed / scale));
+}
+
+void EventReplayer::OnPacedReplayTimer() {
+    PacedReplay& replay = *pacedReplay;
+    while (const auto record = PeekRecord(replay.offset)) {
+        const auto due = replay.start + GetDelay(record->timestamp, replay.firstTimestamp, replay.scale);
+        const auto now = std::chrono::steady_clock::now();
+        if (due > now) {
+            // Rounded up, the timer firing early would only re-arm it.
+            replay.timer->Arm(std::chrono::ceil<std::chrono::microseconds>(due - now));
+            return;
+        }
+        Device device = ReadRecord(*record, replay.offset);
+        const uint64_t generation = replay.generation;
+        replay.monitor->Inject(std::move(device));
+        if (replay.generation != generation) {
+            // The monitor callback started another replay.
+            return;
+        }
+    }
+
+    replay.offset = size;
+    if (replay.done) {
+        // Moved out, done may start another replay.
+        const ReplayDone done = std::move(replay.done);
+        replay.done = nullptr;
+        done();
+    }
+}
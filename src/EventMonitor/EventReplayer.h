@@ -0,0 +1,78 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceMonitor.h>
+#include <EventMonitor/EventRecorder.h>
+#include <EventMonitor/EventTimer.h>
+
+// Replays an event log written by EventRecorder.
+//
+// The log is memory-mapped, and every record becomes a detached Device built straight from the mapped properties.
+// A truncated last record, e.g. left by a recorder that did not flush, ends the replay.
+class EventReplayer {
+public:
+    enum class Pace {
+        // Keep the recorded delays between events.
+        Recorded,
+        // Recorded delays divided by the speed factor, e.g. 10 replays ten times faster.
+        Scaled,
+        // No delay at all.
+        AsFastAsPossible
+    };
+
+    using DeviceSink = std::function<void(Device)>;
+    using ReplayDone = std::function<void()>;
+
+    explicit EventReplayer(const std::string& path);
+    ~EventReplayer();
+    EventReplayer(const EventReplayer&) = delete;
+    EventReplayer(EventReplayer&&) = delete;
+    EventReplayer& operator=(const EventReplayer&) = delete;
+    EventReplayer& operator=(EventReplayer&&) = delete;
+
+    // Hand every recorded device to the sink, on the calling thread. Returns the number of devices replayed.
+    std::size_t Replay(const DeviceSink& sink, Pace pace = Pace::AsFastAsPossible, double speed = 1.0) const;
+    // Inject every recorded device in the monitor, so it reaches its callback like a received one.
+    // Same threading rules as DeviceMonitor::Inject(). AsFastAsPossible injects them all before returning.
+    // Other paces schedule the injections on the monitor's loop and return right away, so its timers and sources
+    // keep running in between like on the live path. done is then called on the loop thread after the last one.
+    // A new replay replaces the one in progress, destroying the replayer cancels it. The monitor must outlive both.
+    // Returns the number of devices replayed, or scheduled.
+    std::size_t Replay(DeviceMonitor& monitor, Pace pace = Pace::AsFastAsPossible, double speed = 1.0, ReplayDone done = nullptr);
+    // Whether a paced replay into a monitor is in progress.
+    bool IsReplaying() const { return pacedReplay && pacedReplay->offset < size; }
+
+private:
+    // Paced replay into a monitor, driven by a timer on its loop.
+    struct PacedReplay {
+        DeviceMonitor* monitor = nullptr;
+        // The loop the timer is attached to.
+        const Event* loop = nullptr;
+        double scale = 1.0;
+        std::size_t offset = 0;
+        uint64_t firstTimestamp = 0;
+        std::chrono::steady_clock::time_point start;
+        ReplayDone done;
+        // Bumped by every Replay(), so the timer notices being replaced from the monitor callback.
+        uint64_t generation = 0;
+        std::unique_ptr<EventTimer> timer;
+    };
+
+    // The header of the record at offset, nullopt at the end of the log or on a truncated record.
+    std::optional<EventLog::Record> PeekRecord(std::size_t offset) const;
+    // Build the device of the record at offset, then move offset past it.
+    Device ReadRecord(const EventLog::Record& record, std::size_t& offset) const;
+    // When the record was due, relative to the start of the replay.
+    static std::chrono::steady_clock::duration GetDelay(uint64_t timestamp, uint64_t firstTimestamp, double scale);
+    void OnPacedReplayTimer();
+
+    const unsigned char* data;
+    std::size_t size;
+    std::unique_ptr<PacedReplay> pacedReplay;
+};
@@ -0,0 +1,69 @@
+#include <EventMonitor/EventTimer.h>
+#include <stdexcept>
+#include <cstdint>
+#include <ctime>
+
+// *** Public ***
+
+EventTimer::EventTimer(std::shared_ptr<Event> event, TimerCallback timerCallback)
+    : eventLoop(std::move(event)),
+      source(nullptr, &sd_event_source_unref),
+      callback(std::move(timerCallback)) {
+    if (!eventLoop || !eventLoop->GetEvent()) {
+        throw std::runtime_error("Failed to create EventTimer : Event ptr is null!");
+    }
+    if (!callback) {
+        throw std::invalid_argument("Failed to create EventTimer : Callback cannot be null!");
+    }
+
+    // Created disabled with an infinite deadline, Arm() sets the real one.
+    sd_event_source* sourceTemp = nullptr;
+    if (sd_event_add_time(eventLoop->GetEvent(), &sourceTemp, CLOCK_MONOTONIC, UINT64_MAX, 1, &EventTimer::OnElapsed, this) < 0 || !sourceTemp) {
+        throw std::runtime_error("Failed to create EventTimer : sd_event_add_time failed!");
+    }
+    source.reset(sourceTemp);
+
+    if (sd_event_source_set_enabled(source.get(), SD_EVENT_OFF) < 0) {
+        throw std::runtime_error("Failed to create EventTimer : sd_event_source_set_enabled failed!");
+    }
+}
+
+void EventTimer::Arm(std::chrono::microseconds delay) {
+    uint64_t now = 0;
+    if (sd_event_now(eventLoop->GetEvent(), CLOCK_MONOTONIC, &now) < 0) {
+        throw std::runtime_error("Failed to arm EventTimer : sd_event_now failed!");
+    }
+
+    const uint64_t deadline = now + static_cast<uint64_t>(delay.count() > 0 ? delay.count() : 0);
+    if (sd_event_source_set_time(source.get(), deadline) < 0 ||
+        sd_event_source_set_enabled(source.get(), SD_EVENT_ONESHOT) < 0) {
+        throw std::runtime_error("Failed to arm EventTimer : sd_event_source update failed!");
+    }
+}
+
+void EventTimer::Disarm() {
+    if (sd_event_source_set_enabled(source.get(), SD_EVENT_OFF) < 0) {
+        throw std::runtime_error("Failed to disarm EventTimer : sd_event_source_set_enabled failed!");
+    }
+}
+
+bool EventTimer::IsArmed() const {
+    int enabled = SD_EVENT_OFF;
+    return sd_event_source_get_enabled(source.get(), &enabled) >= 0 && enabled != SD_EVENT_OFF;
+}
+
+// *** Private ***
+
+int EventTimer::OnElapsed(sd_event_source* eventSource, uint64_t usec, void* userdata) {
+    (void) eventSource; // Unused.
+    (void) usec; // Unused.
+
+    auto* self = static_cast<EventTimer*>(userdata);
+    if (!self) {
+        return -1;
+    }
+
+    self->callback();
+
+    return 0;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <EventMonitor/Event.h>
+
+extern "C" {
+    #include <systemd/sd-event.h>
+}
+
+// One-shot CLOCK_MONOTONIC timer attached to an Event loop.
+// The underlying sd_event_source is created once and re-armed on demand, so arming it does not allocate.
+class EventTimer {
+public:
+    using TimerCallback = std::function<void()>;
+
+    explicit EventTimer(std::shared_ptr<Event> eventLoop, TimerCallback callback);
+    ~EventTimer() = default;
+    // The sd_event_source keeps a pointer to this instance, so it can be neither copied nor moved.
+    EventTimer(const EventTimer&) = delete;
+    EventTimer(EventTimer&&) = delete;
+    EventTimer& operator=(const EventTimer&) = delete;
+    EventTimer& operator=(EventTimer&&) = delete;
+
+    // Fire the callback once, after the delay has elapsed. Re-arming an armed timer moves its deadline.
+    void Arm(std::chrono::microseconds delay);
+    void Disarm();
+    bool IsArmed() const;
+
+private:
+    static int OnElapsed(sd_event_source* source, uint64_t usec, void* userdata);
+
+    // Declared before the source so the loop outlives it.
+    std::shared_ptr<Event> eventLoop;
+    std::unique_ptr<sd_event_source, decltype(&sd_event_source_unref)> source;
+
+    TimerCallback callback;
+};
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// 64-bit FNV-1a, stable across builds and processes unlike std::hash, so it can be persisted.
+// Pass a previous hash as seed to chain several pieces of data.
+constexpr uint64_t fnv1aOffset = 14695981039346656037ull;
+
+constexpr uint64_t Fnv1aHash(std::string_view data, uint64_t hash = fnv1aOffset) {
+    for (const char c : data) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
@@ -0,0 +1,123 @@
+#include <EventMonitor/LatencyHistogram.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+// *** Public ***
+
+LatencyHistogram::LatencyHistogram()
+    : sum(0),
+      min(std::numeric_limits<uint64_t>::max()),
+      max(0) {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::Record(uint64_t nanoseconds) {
+    buckets[GetBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    UpdateMin(nanoseconds);
+    UpdateMax(nanoseconds);
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+    uint64_t total = 0;
+    for (const auto& bucket : buckets) {
+        total += bucket.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetMin() const {
+    const uint64_t value = min.load(std::memory_order_relaxed);
+    return std::chrono::nanoseconds(value == std::numeric_limits<uint64_t>::max() ? 0 : value);
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetMax() const {
+    return std::chrono::nanoseconds(max.load(std::memory_order_relaxed));
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetMean() const {
+    const uint64_t total = GetCount();
+    return std::chrono::nanoseconds(total == 0 ? 0 : sum.load(std::memory_order_relaxed) / total);
+}
+
+std::chrono::nanoseconds LatencyHistogram::GetPercentile(double percentile) const {
+    if (percentile < 0.0 || percentile > 100.0) {
+        throw std::invalid_argument("Failed to get percentile : Percentile must be between 0 and 100!");
+    }
+
+    const uint64_t total = GetCount();
+    if (total == 0) {
+        return std::chrono::nanoseconds(0);
+    }
+
+    const auto rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(total))));
+    uint64_t seen = 0;
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            return std::chrono::nanoseconds(std::min(GetBucketUpperBound(i), max.load(std::memory_order_relaxed)));
+        }
+    }
+    return GetMax();
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (std::size_t i = 0; i < bucketCount; ++i) {
+        buckets[i].fetch_add(other.buckets[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    sum.fetch_add(other.sum.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    UpdateMin(other.min.load(std::memory_order_relaxed));
+    UpdateMax(other.max.load(std::memory_order_relaxed));
+}
+
+void LatencyHistogram::Reset() {
+    for (auto& bucket : buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+    min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+std::size_t LatencyHistogram::GetBucketIndex(uint64_t nanoseconds) {
+    if (nanoseconds < subBucketCount) {
+        return static_cast<std::size_t>(nanoseconds);
+    }
+
+    const unsigned exponent = 63u - static_cast<unsigned>(__builtin_clzll(nanoseconds));
+    if (exponent > maxExponent) {
+        return bucketCount - 1;
+    }
+    // The leading bit picks the power of two, the next subBucketBits bits the linear bucket within it.
+    const unsigned shift = exponent - subBucketBits;
+    return (exponent - subBucketBits + 1) * subBucketCount + ((nanoseconds >> shift) & (subBucketCount - 1));
+}
+
+uint64_t LatencyHistogram::GetBucketUpperBound(std::size_t index) {
+    if (index < subBucketCount) {
+        return index;
+    }
+
+    const auto exponent = static_cast<unsigned>(index / subBucketCount) + subBucketBits - 1;
+    const uint64_t subBucket = index % subBucketCount;
+    const unsigned shift = exponent - subBucketBits;
+    return ((subBucketCount + subBucket + 1) << shift) - 1;
+}
+
+// *** Private ***
+
+void LatencyHistogram::UpdateMin(uint64_t value) {
+    uint64_t current = min.load(std::memory_order_relaxed);
+    while (value < current && !min.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::UpdateMax(uint64_t value) {
+    uint64_t current = max.load(std::memory_order_relaxed);
+    while (value > current && !max.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Lock-free log-linear latency histogram, in nanoseconds.
+//
+// Every power of two is split into 16 linear buckets, so a recorded value is off by at most 1/16th (6.25%) and
+// recording is a bit scan and two relaxed atomic increments, cheap enough to run on every event. The count is
+// summed from the buckets when queried.
+// Values from 2^36 ns (about 69 s) on share the last bucket.
+class LatencyHistogram {
+public:
+    static constexpr unsigned subBucketBits = 4;
+    static constexpr unsigned subBucketCount = 1u << subBucketBits;
+    static constexpr unsigned maxExponent = 36;
+    static constexpr std::size_t bucketCount = (maxExponent - subBucketBits + 2) * subBucketCount;
+
+    explicit LatencyHistogram();
+    ~LatencyHistogram() = default;
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+
+    // Thread-safe.
+    void Record(uint64_t nanoseconds);
+    void Record(std::chrono::nanoseconds value) { Record(value.count() > 0 ? static_cast<uint64_t>(value.count()) : 0); }
+
+    // Queries are thread-safe too, though only consistent while nothing is recorded.
+    uint64_t GetCount() const;
+    std::chrono::nanoseconds GetMin() const;
+    std::chrono::nanoseconds GetMax() const;
+    std::chrono::nanoseconds GetMean() const;
+    std::chrono::nanoseconds GetSum() const { return std::chrono::nanoseconds(sum.load(std::memory_order_relaxed)); }
+    // Upper bound of the bucket holding the percentile (0 to 100), capped by the max. 0 when empty.
+    std::chrono::nanoseconds GetPercentile(double percentile) const;
+
+    // Add the values recorded by the other histogram, e.g. to aggregate several subsystems.
+    void Merge(const LatencyHistogram& other);
+    void Reset();
+
+    static std::size_t GetBucketIndex(uint64_t nanoseconds);
+    // Largest value falling in the bucket.
+    static uint64_t GetBucketUpperBound(std::size_t index);
+
+private:
+    void UpdateMin(uint64_t value);
+    void UpdateMax(uint64_t value);
+
+    std::array<std::atomic<uint64_t>, bucketCount> buckets;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> min;
+    std::atomic<uint64_t> max;
+};
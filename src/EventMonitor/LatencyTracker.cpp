@@ -0,0 +1,109 @@
+#include <EventMonitor/LatencyTracker.h>
+#include <ctime>
+
+namespace {
+    std::size_t RoundUpToPowerOfTwo(std::size_t value) {
+        std::size_t power = 1;
+        while (power < value) {
+            power <<= 1;
+        }
+        return power;
+    }
+
+    bool Matches(const LatencyTracker::Series& series, std::string_view subsystem, std::optional<sd_device_action_t> action) {
+        return series.action == action && series.subsystem == subsystem;
+    }
+}
+
+// *** Public ***
+
+LatencyTracker::LatencyTracker(std::size_t maxSeries)
+    : mask(RoundUpToPowerOfTwo(maxSeries == 0 ? 1 : maxSeries) - 1),
+      slots(new std::atomic<Series*>[mask + 1]) {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        slots[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+LatencyTracker::~LatencyTracker() {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        delete slots[i].load(std::memory_order_relaxed);
+    }
+}
+
+LatencyTracker::Series& LatencyTracker::GetSeries(std::string_view subsystem, std::optional<sd_device_action_t> action) {
+    std::unique_ptr<Series> created;
+    std::size_t slot = GetSlot(subsystem, action);
+    for (std::size_t probe = 0; probe <= mask; ++probe, slot = (slot + 1) & mask) {
+        Series* series = slots[slot].load(std::memory_order_acquire);
+        if (!series) {
+            if (!created) {
+                created = std::make_unique<Series>();
+                created->subsystem = std::string(subsystem);
+                created->action = action;
+            }
+            // Someone else may claim the slot first, then check what they stored.
+            if (slots[slot].compare_exchange_strong(series, created.get(), std::memory_order_acq_rel)) {
+                return *created.release();
+            }
+        }
+        if (Matches(*series, subsystem, action)) {
+            return *series;
+        }
+    }
+    return overflow;
+}
+
+const LatencyTracker::Series* LatencyTracker::Find(std::string_view subsystem, std::optional<sd_device_action_t> action) const {
+    std::size_t slot = GetSlot(subsystem, action);
+    for (std::size_t probe = 0; probe <= mask; ++probe, slot = (slot + 1) & mask) {
+        const Series* series = slots[slot].load(std::memory_order_acquire);
+        if (!series) {
+            return nullptr;
+        }
+        if (Matches(*series, subsystem, action)) {
+            return series;
+        }
+    }
+    return nullptr;
+}
+
+void LatencyTracker::ForEach(const SeriesVisitor& visitor) const {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        if (const Series* series = slots[i].load(std::memory_order_acquire)) {
+            visitor(*series);
+        }
+    }
+    if (overflow.Get(Stage::Handler).GetCount() > 0) {
+        visitor(overflow);
+    }
+}
+
+void LatencyTracker::Record(Series& series, uint64_t initialized, uint64_t received, uint64_t entered, uint64_t returned) {
+    auto& stages = series.stages;
+    if (initialized != 0 && received >= initialized) {
+        stages[static_cast<std::size_t>(Stage::Udev)].Record(received - initialized);
+    }
+    if (received != 0) {
+        stages[static_cast<std::size_t>(Stage::Dispatch)].Record(entered - received);
+    }
+    stages[static_cast<std::size_t>(Stage::Handler)].Record(returned - entered);
+
+    const uint64_t start = initialized != 0 ? initialized : received;
+    if (start != 0) {
+        stages[static_cast<std::size_t>(Stage::Total)].Record(returned - start);
+    }
+}
+
+uint64_t LatencyTracker::Now() {
+    timespec now {};
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000ull + static_cast<uint64_t>(now.tv_nsec);
+}
+
+// *** Private ***
+
+std::size_t LatencyTracker::GetSlot(std::string_view subsystem, std::optional<sd_device_action_t> action) const {
+    const std::size_t hash = std::hash<std::string_view>()(subsystem) ^ (static_cast<std::size_t>(action.value_or(_SD_DEVICE_ACTION_INVALID) + 1) * 0x9e3779b97f4a7c15ull);
+    return hash & mask;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <EventMonitor/LatencyHistogram.h>
+
+extern "C" {
+    #include <systemd/sd-device.h>
+}
+
+// Event latency histograms of a DeviceMonitor, per subsystem and action (see DeviceMonitor::SetLatencyTracker()).
+//
+// Series are found through a fixed-size open-addressing table of atomic pointers, inserted once and never removed,
+// so recording takes no lock, and queries can run from any thread while events are recorded.
+class LatencyTracker {
+public:
+    enum class Stage {
+        // From udev initializing the device (USEC_INITIALIZED) to the monitor receiving it. Add events only,
+        // the timestamp predates any later event.
+        Udev,
+        // From the monitor receiving the device to the callback being entered, e.g. queueing, batching or coalescing.
+        Dispatch,
+        // Time spent in the callback.
+        Handler,
+        // From the earliest known timestamp (USEC_INITIALIZED for add events, reception otherwise)
+        // to the callback returning.
+        Total
+    };
+    static constexpr std::size_t stageCount = 4;
+
+    // Histograms of one subsystem and action.
+    struct Series {
+        std::string subsystem;
+        // Unset when the action is unknown.
+        std::optional<sd_device_action_t> action;
+        std::array<LatencyHistogram, stageCount> stages;
+
+        const LatencyHistogram& Get(Stage stage) const { return stages[static_cast<std::size_t>(stage)]; }
+    };
+    using SeriesVisitor = std::function<void(const Series&)>;
+
+    // Up to maxSeries subsystem and action pairs (rounded up to a power of two) get their own series,
+    // later ones share an overflow series with an empty subsystem.
+    explicit LatencyTracker(std::size_t maxSeries = 256);
+    ~LatencyTracker();
+    LatencyTracker(const LatencyTracker&) = delete;
+    LatencyTracker(LatencyTracker&&) = delete;
+    LatencyTracker& operator=(const LatencyTracker&) = delete;
+    LatencyTracker& operator=(LatencyTracker&&) = delete;
+
+    // The series of the pair, created the first time.
+    Series& GetSeries(std::string_view subsystem, std::optional<sd_device_action_t> action);
+    // Null if nothing was recorded for the pair.
+    const Series* Find(std::string_view subsystem, std::optional<sd_device_action_t> action) const;
+    void ForEach(const SeriesVisitor& visitor) const;
+
+    // Timestamps are CLOCK_MONOTONIC nanoseconds, 0 when unknown.
+    void Record(Series& series, uint64_t initialized, uint64_t received, uint64_t entered, uint64_t returned);
+
+    static uint64_t Now();
+
+private:
+    std::size_t GetSlot(std::string_view subsystem, std::optional<sd_device_action_t> action) const;
+
+    std::size_t mask;
+    std::unique_ptr<std::atomic<Series*>[]> slots;
+    Series overflow;
+};
@@ -0,0 +1,150 @@
+#include <EventMonitor/MetricsExporter.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // A stuck client must not hold the event loop for longer.
+    constexpr timeval sendTimeout { 1, 0 };
+
+    bool WriteAll(int fd, const std::string& data) {
+        std::size_t written = 0;
+        while (written < data.size()) {
+            const ssize_t result = write(fd, data.data() + written, data.size() - written);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            written += static_cast<std::size_t>(result);
+        }
+        return true;
+    }
+}
+
+// *** Public ***
+
+MetricsExporter::MetricsExporter(std::shared_ptr<Event> event, std::shared_ptr<MetricsRegistry> metricsRegistry)
+    : eventLoop(std::move(event)),
+      registry(std::move(metricsRegistry)),
+      listenFd(-1),
+      listenSource(nullptr, &sd_event_source_unref),
+      fileInterval(0) {
+    if (!eventLoop || !eventLoop->GetEvent()) {
+        throw std::runtime_error("Failed to create MetricsExporter : Event ptr is null!");
+    }
+    if (!registry) {
+        throw std::invalid_argument("Failed to create MetricsExporter : Registry cannot be null!");
+    }
+}
+
+MetricsExporter::~MetricsExporter() {
+    Stop();
+}
+
+void MetricsExporter::ServeUnixSocket(const std::string& path) {
+    sockaddr_un address {};
+    if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+        throw std::invalid_argument("Failed to serve metrics : Invalid socket path!");
+    }
+    if (listenFd >= 0) {
+        throw std::runtime_error("Failed to serve metrics : Already serving!");
+    }
+
+    const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to serve metrics : socket failed!");
+    }
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 || listen(fd, 16) < 0) {
+        close(fd);
+        throw std::runtime_error("Failed to serve metrics : Cannot listen on " + path + "!");
+    }
+
+    sd_event_source* sourceTemp = nullptr;
+    if (sd_event_add_io(eventLoop->GetEvent(), &sourceTemp, fd, EPOLLIN, &MetricsExporter::OnConnection, this) < 0 || !sourceTemp) {
+        close(fd);
+        unlink(path.c_str());
+        throw std::runtime_error("Failed to serve metrics : sd_event_add_io failed!");
+    }
+    listenSource.reset(sourceTemp);
+    listenFd = fd;
+    socketPath = path;
+}
+
+void MetricsExporter::WriteFilePeriodically(const std::string& path, std::chrono::microseconds interval) {
+    if (interval.count() <= 0) {
+        throw std::invalid_argument("Failed to write metrics periodically : Interval must be positive!");
+    }
+
+    WriteFile(path);
+    filePath = path;
+    fileInterval = interval;
+    if (!fileTimer) {
+        fileTimer = std::make_unique<EventTimer>(eventLoop, [this]() {
+            // A failed write is retried on the next tick.
+            try {
+                WriteFile(filePath);
+            }
+            catch (const std::runtime_error&) {
+            }
+            fileTimer->Arm(fileInterval);
+        });
+    }
+    fileTimer->Arm(fileInterval);
+}
+
+void MetricsExporter::WriteFile(const std::string& path) const {
+    const std::string temporaryPath = path + ".tmp";
+    FILE* file = std::fopen(temporaryPath.c_str(), "w");
+    if (!file) {
+        throw std::runtime_error("Failed to write metrics : Cannot open " + temporaryPath + "!");
+    }
+    const std::string text = registry->Export();
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (std::fclose(file) != 0 || !written || std::rename(temporaryPath.c_str(), path.c_str()) != 0) {
+        std::remove(temporaryPath.c_str());
+        throw std::runtime_error("Failed to write metrics : Cannot write " + path + "!");
+    }
+}
+
+void MetricsExporter::Stop() {
+    fileTimer.reset();
+    listenSource.reset();
+    if (listenFd >= 0) {
+        close(listenFd);
+        unlink(socketPath.c_str());
+        listenFd = -1;
+    }
+}
+
+// *** Private ***
+
+int MetricsExporter::OnConnection(sd_event_source* source, int fd, uint32_t revents, void* userdata) {
+    (void) source; // Unused.
+    (void) revents; // Unused.
+
+    auto* self = static_cast<MetricsExporter*>(userdata);
+    if (!self) {
+        return -1;
+    }
+
+    for (;;) {
+        const int client = accept4(fd, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            break;
+        }
+        setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+        WriteAll(client, self->registry->Export());
+        close(client);
+    }
+
+    return 0;
+}
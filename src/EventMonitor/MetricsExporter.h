@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <EventMonitor/Event.h>
+#include <EventMonitor/EventTimer.h>
+#include <EventMonitor/MetricsRegistry.h>
+
+// Publishes a MetricsRegistry from an event loop, over a local Unix socket and/or to a periodically rewritten file.
+//
+// A client connecting to the socket gets the Prometheus text export and the connection is closed, e.g.
+// `socat - UNIX-CONNECT:/run/eventmonitor.prom`. The file is rewritten atomically (written aside, then renamed),
+// as expected by the node_exporter textfile collector.
+class MetricsExporter {
+public:
+    explicit MetricsExporter(std::shared_ptr<Event> eventLoop, std::shared_ptr<MetricsRegistry> registry = MetricsRegistry::GetDefault());
+    // Stop serving and remove the socket.
+    ~MetricsExporter();
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter(MetricsExporter&&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+    // Listen on the path, replacing any stale socket there.
+    void ServeUnixSocket(const std::string& path);
+    // Write the export to the path now, then every interval.
+    void WriteFilePeriodically(const std::string& path, std::chrono::microseconds interval);
+    // Write the export to the path once.
+    void WriteFile(const std::string& path) const;
+
+    void Stop();
+
+private:
+    static int OnConnection(sd_event_source* source, int fd, uint32_t revents, void* userdata);
+
+    std::shared_ptr<Event> eventLoop;
+    std::shared_ptr<MetricsRegistry> registry;
+
+    std::string socketPath;
+    int listenFd;
+    std::unique_ptr<sd_event_source, decltype(&sd_event_source_unref)> listenSource;
+
+    std::string filePath;
+    std::chrono::microseconds fileInterval;
+    std::unique_ptr<EventTimer> fileTimer;
+};
@@ -0,0 +1,258 @@
+#include <EventMonitor/MetricsRegistry.h>
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+
+namespace {
+    std::atomic<uint64_t> nextRegistryId(1);
+
+    void AppendEscaped(std::string& out, const std::string& value) {
+        for (const char c : value) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '"': out += "\\\""; break;
+                case '\n': out += "\\n"; break;
+                default: out += c; break;
+            }
+        }
+    }
+
+    // Labels as {name="value",...}, with an optional extra label, nothing when empty.
+    void AppendLabels(std::string& out, const MetricsRegistry::Labels& labels, const char* extraName = nullptr, const char* extraValue = nullptr) {
+        if (labels.empty() && !extraName) {
+            return;
+        }
+        out += '{';
+        bool first = true;
+        for (const auto& [name, value] : labels) {
+            if (!first) {
+                out += ',';
+            }
+            first = false;
+            out += name;
+            out += "=\"";
+            AppendEscaped(out, value);
+            out += '"';
+        }
+        if (extraName) {
+            if (!first) {
+                out += ',';
+            }
+            out += extraName;
+            out += "=\"";
+            out += extraValue;
+            out += '"';
+        }
+        out += '}';
+    }
+
+    void AppendNumber(std::string& out, double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", value);
+        out += buffer;
+    }
+
+    double ToSeconds(std::chrono::nanoseconds value) {
+        return static_cast<double>(value.count()) / 1e9;
+    }
+}
+
+// *** Counter ***
+
+void MetricsRegistry::Counter::Add(uint64_t value) const {
+    if (!registry) {
+        return;
+    }
+    // Only this thread writes the slot, readers just need the store to be atomic.
+    auto& slot = registry->GetShard().values[index];
+    slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+// *** Public ***
+
+thread_local MetricsRegistry::ThreadCache MetricsRegistry::threadCache;
+
+MetricsRegistry::MetricsRegistry()
+    : id(nextRegistryId.fetch_add(1)),
+      counterCount(0),
+      pool(std::make_shared<ShardPool>()) {
+}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+MetricsRegistry::Counter MetricsRegistry::AddCounter(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Counter(this, FindOrAdd(name, help, Type::Counter, labels).counterIndex);
+}
+
+MetricsRegistry::Gauge MetricsRegistry::AddGauge(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return Gauge(FindOrAdd(name, help, Type::Gauge, labels).gauge.get());
+}
+
+LatencyHistogram& MetricsRegistry::AddSummary(const std::string& name, const std::string& help, const Labels& labels) {
+    std::lock_guard<std::mutex> lock(mutex);
+    return *FindOrAdd(name, help, Type::Summary, labels).summary;
+}
+
+uint64_t MetricsRegistry::GetValue(const Counter& counter) const {
+    if (counter.registry != this) {
+        throw std::invalid_argument("Failed to get counter value : Counter belongs to another registry!");
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    return Sum(counter.index);
+}
+
+std::size_t MetricsRegistry::GetShardCount() const {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    return pool->shards.size();
+}
+
+std::string MetricsRegistry::Export() const {
+    static constexpr std::pair<double, const char*> quantiles[] = { { 50.0, "0.5" }, { 90.0, "0.9" }, { 99.0, "0.99" } };
+
+    std::string out;
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Family& family : families) {
+        out += "# HELP " + family.name + ' ' + family.help + '\n';
+        out += "# TYPE " + family.name + (family.type == Type::Counter ? " counter\n" : family.type == Type::Gauge ? " gauge\n" : " summary\n");
+
+        for (const Series& series : family.series) {
+            switch (family.type) {
+                case Type::Counter:
+                    out += family.name;
+                    AppendLabels(out, series.labels);
+                    out += ' ' + std::to_string(Sum(series.counterIndex)) + '\n';
+                    break;
+                case Type::Gauge:
+                    out += family.name;
+                    AppendLabels(out, series.labels);
+                    out += ' ' + std::to_string(series.gauge->load(std::memory_order_relaxed)) + '\n';
+                    break;
+                case Type::Summary:
+                    for (const auto& [percentile, quantile] : quantiles) {
+                        out += family.name;
+                        AppendLabels(out, series.labels, "quantile", quantile);
+                        out += ' ';
+                        AppendNumber(out, ToSeconds(series.summary->GetPercentile(percentile)));
+                        out += '\n';
+                    }
+                    out += family.name + "_sum";
+                    AppendLabels(out, series.labels);
+                    out += ' ';
+                    AppendNumber(out, ToSeconds(series.summary->GetSum()));
+                    out += '\n' + family.name + "_count";
+                    AppendLabels(out, series.labels);
+                    out += ' ' + std::to_string(series.summary->GetCount()) + '\n';
+                    break;
+            }
+        }
+    }
+    return out;
+}
+
+const std::shared_ptr<MetricsRegistry>& MetricsRegistry::GetDefault() {
+    static const std::shared_ptr<MetricsRegistry> defaultRegistry = std::make_shared<MetricsRegistry>();
+    return defaultRegistry;
+}
+
+// *** Private ***
+
+MetricsRegistry::Series& MetricsRegistry::FindOrAdd(const std::string& name, const std::string& help, Type type, const Labels& labels) {
+    if (name.empty()) {
+        throw std::invalid_argument("Failed to add metric : Name cannot be empty!");
+    }
+
+    auto family = std::find_if(families.begin(), families.end(), [&name](const Family& candidate) { return candidate.name == name; });
+    if (family == families.end()) {
+        families.push_back(Family{ name, help, type, {} });
+        family = std::prev(families.end());
+    }
+    else if (family->type != type) {
+        throw std::invalid_argument("Failed to add metric : " + name + " is already registered with another type!");
+    }
+
+    for (Series& series : family->series) {
+        if (series.labels == labels) {
+            return series;
+        }
+    }
+
+    Series series{ labels, 0, nullptr, nullptr };
+    switch (type) {
+        case Type::Counter:
+            if (counterCount == maxCounters) {
+                throw std::runtime_error("Failed to add metric : Too many counters!");
+            }
+            series.counterIndex = counterCount++;
+            break;
+        case Type::Gauge:
+            series.gauge = std::make_unique<std::atomic<int64_t>>(0);
+            break;
+        case Type::Summary:
+            series.summary = std::make_unique<LatencyHistogram>();
+            break;
+    }
+    family->series.push_back(std::move(series));
+    return family->series.back();
+}
+
+MetricsRegistry::Shard& MetricsRegistry::GetShard() {
+    ThreadCache& cache = threadCache;
+    if (cache.lastId == id) {
+        return *cache.lastShard;
+    }
+
+    auto it = std::find_if(cache.entries.begin(), cache.entries.end(), [this](const auto& entry) { return entry.id == id; });
+    if (it == cache.entries.end()) {
+        // Forget the registries destroyed since, their shards went with them.
+        cache.entries.erase(std::remove_if(cache.entries.begin(), cache.entries.end(), [](const auto& entry) { return entry.pool.expired(); }),
+                            cache.entries.end());
+
+        Shard* shard = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(pool->mutex);
+            if (!pool->freeShards.empty()) {
+                shard = pool->freeShards.back();
+                pool->freeShards.pop_back();
+            }
+            else {
+                pool->shards.push_back(std::make_unique<Shard>());
+                shard = pool->shards.back().get();
+            }
+        }
+        cache.entries.push_back({ id, pool, shard });
+        it = std::prev(cache.entries.end());
+    }
+    cache.lastId = id;
+    cache.lastShard = it->shard;
+    return *it->shard;
+}
+
+uint64_t MetricsRegistry::Sum(std::size_t counterIndex) const {
+    std::lock_guard<std::mutex> lock(pool->mutex);
+    // Free shards are zeroed, summing them too is harmless.
+    uint64_t total = pool->retired[counterIndex];
+    for (const auto& shard : pool->shards) {
+        total += shard->values[counterIndex].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+// *** ThreadCache ***
+
+MetricsRegistry::ThreadCache::~ThreadCache() {
+    for (const Entry& entry : entries) {
+        const auto shardPool = entry.pool.lock();
+        if (!shardPool) {
+            continue;
+        }
+        // Fold the values into the retired totals in one step, so a concurrent Sum() never counts them twice.
+        std::lock_guard<std::mutex> lock(shardPool->mutex);
+        for (std::size_t i = 0; i < maxCounters; ++i) {
+            shardPool->retired[i] += entry.shard->values[i].load(std::memory_order_relaxed);
+            entry.shard->values[i].store(0, std::memory_order_relaxed);
+        }
+        shardPool->freeShards.push_back(entry.shard);
+    }
+}
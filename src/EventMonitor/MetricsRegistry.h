@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include <EventMonitor/LatencyHistogram.h>
+
+// Counters, gauges and latency summaries, exported in the Prometheus text format (see MetricsExporter).
+//
+// Counters are sharded per thread : every thread adds to its own slots, which only it writes, so an update is a
+// plain load and store with no lock prefix and no cache line shared between threads. Slots are summed on export.
+class MetricsRegistry {
+public:
+    using Labels = std::vector<std::pair<std::string, std::string>>;
+
+    static constexpr std::size_t maxCounters = 256;
+
+    // Handle to a counter, a default constructed one ignores updates.
+    class Counter {
+    public:
+        Counter() = default;
+
+        void Add(uint64_t value = 1) const;
+        explicit operator bool() const { return registry != nullptr; }
+
+    private:
+        friend class MetricsRegistry;
+        Counter(MetricsRegistry* owner, std::size_t slot) : registry(owner), index(slot) {}
+
+        MetricsRegistry* registry = nullptr;
+        std::size_t index = 0;
+    };
+
+    // Handle to a gauge, a default constructed one ignores updates.
+    class Gauge {
+    public:
+        Gauge() = default;
+
+        void Set(int64_t newValue) const {
+            if (value) {
+                value->store(newValue, std::memory_order_relaxed);
+            }
+        }
+        explicit operator bool() const { return value != nullptr; }
+
+    private:
+        friend class MetricsRegistry;
+        explicit Gauge(std::atomic<int64_t>* gauge) : value(gauge) {}
+
+        std::atomic<int64_t>* value = nullptr;
+    };
+
+    explicit MetricsRegistry();
+    ~MetricsRegistry();
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry(MetricsRegistry&&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(MetricsRegistry&&) = delete;
+
+    // Registering the same name and labels again returns the existing metric. Names follow the Prometheus
+    // conventions, e.g. a _total suffix for counters and a _seconds one for summaries. Thread-safe.
+    Counter AddCounter(const std::string& name, const std::string& help, const Labels& labels = {});
+    Gauge AddGauge(const std::string& name, const std::string& help, const Labels& labels = {});
+    // Exported as a summary in seconds, with the 0.5, 0.9 and 0.99 quantiles.
+    LatencyHistogram& AddSummary(const std::string& name, const std::string& help, const Labels& labels = {});
+
+    // Current value of a counter, summed over the threads.
+    uint64_t GetValue(const Counter& counter) const;
+    // Counter shards allocated, at most the number of threads updating counters at the same time.
+    std::size_t GetShardCount() const;
+    // Prometheus text exposition format. Thread-safe.
+    std::string Export() const;
+
+    // Process-wide registry, shared by default between the monitors and enumerators which record metrics.
+    static const std::shared_ptr<MetricsRegistry>& GetDefault();
+
+private:
+    struct Shard {
+        std::array<std::atomic<uint64_t>, maxCounters> values{};
+    };
+
+    // Shards of the threads which updated a counter. Shared with the thread caches, so a thread exiting after the
+    // registry is gone never touches it.
+    struct ShardPool {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<Shard>> shards;
+        // Zeroed shards of exited threads, handed to the next threads.
+        std::vector<Shard*> freeShards;
+        // What the exited threads counted.
+        std::array<uint64_t, maxCounters> retired{};
+    };
+
+    // Shards of the calling thread, per registry id, the last one used first. Retired into their pool on thread exit.
+    struct ThreadCache {
+        struct Entry {
+            uint64_t id;
+            std::weak_ptr<ShardPool> pool;
+            Shard* shard;
+        };
+
+        uint64_t lastId = 0;
+        Shard* lastShard = nullptr;
+        std::vector<Entry> entries;
+
+        ~ThreadCache();
+    };
+    static thread_local ThreadCache threadCache;
+
+    enum class Type {
+        Counter,
+        Gauge,
+        Summary
+    };
+
+    struct Series {
+        Labels labels;
+        std::size_t counterIndex;
+        std::unique_ptr<std::atomic<int64_t>> gauge;
+        std::unique_ptr<LatencyHistogram> summary;
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        Type type;
+        std::vector<Series> series;
+    };
+
+    Series& FindOrAdd(const std::string& name, const std::string& help, Type type, const Labels& labels);
+    // The shard of the calling thread, reused or created the first time.
+    Shard& GetShard();
+    uint64_t Sum(std::size_t counterIndex) const;
+
+    // Never reused, so a thread caching the shard of a destroyed registry never mistakes it for a new one.
+    const uint64_t id;
+
+    mutable std::mutex mutex;
+    std::vector<Family> families;
+    std::size_t counterCount;
+    std::shared_ptr<ShardPool> pool;
+};
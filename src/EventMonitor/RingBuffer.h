@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+// Bounded lock-free multi-producer multi-consumer queue.
+//
+// Every slot carries a sequence number telling producers and consumers whether it is free or filled
+// for their lap around the buffer, so neither side ever takes a lock or allocates once constructed.
+// The capacity is rounded up to the next power of two.
+template <typename T>
+class RingBuffer {
+public:
+    explicit RingBuffer(std::size_t capacity);
+    ~RingBuffer();
+    RingBuffer(const RingBuffer&) = delete;
+    RingBuffer(RingBuffer&&) = delete;
+    RingBuffer& operator=(const RingBuffer&) = delete;
+    RingBuffer& operator=(RingBuffer&&) = delete;
+
+    // Move the value into the queue. Returns false, leaving the value untouched, if the queue is full.
+    bool TryPush(T&& value);
+    // Move the oldest value out of the queue, or return std::nullopt if the queue is empty.
+    std::optional<T> TryPop();
+
+    std::size_t GetCapacity() const { return mask + 1; }
+    // Approximate number of queued values, exact only when no push or pop is in flight.
+    std::size_t GetSize() const;
+    bool IsEmpty() const { return GetSize() == 0; }
+
+private:
+    // Keep the producer and consumer positions on their own cache line to avoid false sharing.
+    static constexpr std::size_t cacheLineSize = 64;
+
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+
+    alignas(cacheLineSize) std::atomic<std::size_t> enqueuePosition;
+    alignas(cacheLineSize) std::atomic<std::size_t> dequeuePosition;
+};
+
+template <typename T>
+RingBuffer<T>::RingBuffer(std::size_t capacity)
+    : mask([capacity]() {
+          if (capacity == 0) {
+              throw std::invalid_argument("Failed to create RingBuffer : Capacity cannot be 0!");
+          }
+          std::size_t size = 1;
+          while (size < capacity) {
+              size <<= 1;
+          }
+          return size - 1;
+      }()),
+      cells(new Cell[mask + 1]),
+      enqueuePosition(0),
+      dequeuePosition(0) {
+    for (std::size_t i = 0; i <= mask; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+template <typename T>
+RingBuffer<T>::~RingBuffer() {
+    // Destroy whatever was never consumed.
+    while (TryPop()) {
+    }
+}
+
+template <typename T>
+bool RingBuffer<T>::TryPush(T&& value) {
+    std::size_t position = enqueuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells[position & mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0) {
+            // The slot is free for this lap, try to claim it.
+            if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                new (cell.storage) T(std::move(value));
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0) {
+            // The slot still holds a value from the previous lap : the queue is full.
+            return false;
+        }
+        else {
+            // Another producer claimed the slot first.
+            position = enqueuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+std::optional<T> RingBuffer<T>::TryPop() {
+    std::size_t position = dequeuePosition.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells[position & mask];
+        const std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+
+        if (difference == 0) {
+            // The slot is filled for this lap, try to claim it.
+            if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                T* stored = std::launder(reinterpret_cast<T*>(cell.storage));
+                std::optional<T> value(std::move(*stored));
+                stored->~T();
+                cell.sequence.store(position + mask + 1, std::memory_order_release);
+                return value;
+            }
+        }
+        else if (difference < 0) {
+            // Nothing was pushed in this slot yet : the queue is empty.
+            return std::nullopt;
+        }
+        else {
+            // Another consumer claimed the slot first.
+            position = dequeuePosition.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+std::size_t RingBuffer<T>::GetSize() const {
+    const std::size_t head = dequeuePosition.load(std::memory_order_acquire);
+    const std::size_t tail = enqueuePosition.load(std::memory_order_acquire);
+    return tail > head ? tail - head : 0;
+}
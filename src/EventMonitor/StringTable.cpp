@@ -0,0 +1,78 @@
+#include <EventMonitor/StringTable.h>
+#include <cstring>
+#include <stdexcept>
+
+// *** Public ***
+
+StringTable::StringTable()
+    : arenaCursor(nullptr),
+      arenaRemaining(0),
+      size(0) {
+    for (auto& chunk : chunks) {
+        chunk.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+StringTable::~StringTable() {
+    for (auto& chunk : chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
+StringTable::Id StringTable::Intern(std::string_view value) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    const auto it = ids.find(value);
+    if (it != ids.end()) {
+        return it->second;
+    }
+
+    const std::size_t id = size.load(std::memory_order_relaxed);
+    if (id >= chunkSize * maxChunks) {
+        throw std::runtime_error("Failed to intern string : StringTable is full!");
+    }
+
+    std::string_view* chunk = chunks[id >> chunkBits].load(std::memory_order_relaxed);
+    if (!chunk) {
+        chunk = new std::string_view[chunkSize];
+        chunks[id >> chunkBits].store(chunk, std::memory_order_release);
+    }
+
+    const std::string_view stored = Store(value);
+    chunk[id & (chunkSize - 1)] = stored;
+    ids.emplace(stored, static_cast<Id>(id));
+    size.store(id + 1, std::memory_order_release);
+
+    return static_cast<Id>(id);
+}
+
+std::string_view StringTable::Lookup(Id id) const {
+    return chunks[id >> chunkBits].load(std::memory_order_acquire)[id & (chunkSize - 1)];
+}
+
+const std::shared_ptr<StringTable>& StringTable::GetDefault() {
+    static const std::shared_ptr<StringTable> defaultTable = std::make_shared<StringTable>();
+    return defaultTable;
+}
+
+// *** Private ***
+
+std::string_view StringTable::Store(std::string_view value) {
+    if (value.empty()) {
+        return std::string_view();
+    }
+
+    if (value.size() > arenaRemaining) {
+        const std::size_t blockSize = value.size() > arenaBlockSize ? value.size() : arenaBlockSize;
+        arenaBlocks.push_back(std::make_unique<char[]>(blockSize));
+        arenaCursor = arenaBlocks.back().get();
+        arenaRemaining = blockSize;
+    }
+
+    std::memcpy(arenaCursor, value.data(), value.size());
+    const std::string_view stored(arenaCursor, value.size());
+    arenaCursor += value.size();
+    arenaRemaining -= value.size();
+
+    return stored;
+}
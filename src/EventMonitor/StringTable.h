@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Thread-safe, append-only string interning table.
+//
+// Every distinct string is stored once and identified by a dense id. Ids and the views returned by Lookup()
+// stay valid for the lifetime of the table. Interning takes a lock, looking up an id does not.
+class StringTable {
+public:
+    using Id = uint32_t;
+
+    explicit StringTable();
+    ~StringTable();
+    StringTable(const StringTable&) = delete;
+    StringTable(StringTable&&) = delete;
+    StringTable& operator=(const StringTable&) = delete;
+    StringTable& operator=(StringTable&&) = delete;
+
+    // Returns the id of the string, storing it first if it was never seen.
+    Id Intern(std::string_view value);
+    // The id must come from this table.
+    std::string_view Lookup(Id id) const;
+
+    std::size_t GetSize() const { return size.load(std::memory_order_acquire); }
+
+    // Process-wide table, shared by default between every DeviceSnapshot.
+    static const std::shared_ptr<StringTable>& GetDefault();
+
+private:
+    // Views are kept in fixed-size chunks that never move, so a lookup is two indirections and no lock.
+    static constexpr std::size_t chunkBits = 10;
+    static constexpr std::size_t chunkSize = std::size_t(1) << chunkBits;
+    static constexpr std::size_t maxChunks = 4096;
+    // Characters are copied into blocks of this size, longer strings get their own block.
+    static constexpr std::size_t arenaBlockSize = 64 * 1024;
+
+    std::string_view Store(std::string_view value);
+
+    std::mutex mutex;
+    std::unordered_map<std::string_view, Id> ids;
+    std::vector<std::unique_ptr<char[]>> arenaBlocks;
+    char* arenaCursor;
+    std::size_t arenaRemaining;
+
+    std::array<std::atomic<std::string_view*>, maxChunks> chunks;
+    std::atomic<std::size_t> size;
+};
@@ -0,0 +1,317 @@
+#include <EventMonitor/SysattrReader.h>
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#if __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define EVENTMONITOR_IO_URING 1
+#endif
+
+namespace {
+    // sysfs terminates values with a newline, libsystemd strips it.
+    std::string MakeValue(const char* data, std::size_t size) {
+        while (size > 0 && (data[size - 1] == '\n' || data[size - 1] == '\r')) {
+            --size;
+        }
+        return std::string(data, size);
+    }
+
+    // Symlink attributes (driver, subsystem...) read as the name of their target, like with libsystemd.
+    std::optional<std::string> ReadLinkName(const std::string& path) {
+        char target[PATH_MAX];
+        const ssize_t size = readlink(path.c_str(), target, sizeof(target));
+        if (size <= 0 || static_cast<std::size_t>(size) == sizeof(target)) {
+            return std::nullopt;
+        }
+        const std::string_view view(target, static_cast<std::size_t>(size));
+        return std::string(view.substr(view.rfind('/') + 1));
+    }
+
+    std::optional<std::string> ReadValue(const std::string& path, char* buffer) {
+        const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return std::nullopt;
+        }
+        ssize_t size = 0;
+        do {
+            size = pread(fd, buffer, SysattrReader::maxValueSize, 0);
+        } while (size < 0 && errno == EINTR);
+        const int error = errno;
+        close(fd);
+
+        if (size < 0) {
+            return (error == EISDIR) ? ReadLinkName(path) : std::nullopt;
+        }
+        return MakeValue(buffer, static_cast<std::size_t>(size));
+    }
+}
+
+// *** Ring ***
+
+#ifdef EVENTMONITOR_IO_URING
+
+// Minimal io_uring over the raw syscalls : one submitter, batches submitted then waited for as a whole.
+class SysattrReader::Ring {
+public:
+    // Null when io_uring is unavailable or misses one of the operations used.
+    static std::unique_ptr<Ring> Create(unsigned entries);
+    ~Ring();
+
+    unsigned GetEntries() const { return sqEntries; }
+    // Zeroed entry, at most GetEntries() per Run().
+    io_uring_sqe& Prepare(uint8_t opcode, uint64_t userData);
+    // Submit the prepared entries and wait for all of them, calling onCompletion(userData, result) for each.
+    template <typename OnCompletion>
+    void Run(OnCompletion&& onCompletion);
+
+private:
+    explicit Ring() = default;
+
+    int fd = -1;
+    void* rings = MAP_FAILED;
+    std::size_t ringsSize = 0;
+    void* sqes = MAP_FAILED;
+    std::size_t sqesSize = 0;
+
+    // The indices are shared with the kernel, hence accessed with atomic builtins.
+    unsigned* sqTail = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned sqMask = 0;
+    unsigned sqEntries = 0;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned cqMask = 0;
+    io_uring_cqe* cqes = nullptr;
+    unsigned prepared = 0;
+};
+
+std::unique_ptr<SysattrReader::Ring> SysattrReader::Ring::Create(unsigned entries) {
+    io_uring_params params{};
+    const int ringFd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (ringFd < 0) {
+        return nullptr;
+    }
+    std::unique_ptr<Ring> ring(new Ring());
+    ring->fd = ringFd;
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP)) {
+        return nullptr;
+    }
+
+    // Opening (5.6) comes later than io_uring itself (5.1).
+    constexpr unsigned probedOps = 256;
+    std::vector<unsigned char> probeBuffer(sizeof(io_uring_probe) + probedOps * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(probeBuffer.data());
+    if (syscall(__NR_io_uring_register, ringFd, IORING_REGISTER_PROBE, probe, probedOps) < 0) {
+        return nullptr;
+    }
+    for (const unsigned op : { IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE }) {
+        if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED)) {
+            return nullptr;
+        }
+    }
+
+    ring->ringsSize = std::max<std::size_t>(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                                            params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+    ring->rings = mmap(nullptr, ring->ringsSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = mmap(nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+    if (ring->rings == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        return nullptr;
+    }
+
+    auto* base = static_cast<unsigned char*>(ring->rings);
+    ring->sqTail = reinterpret_cast<unsigned*>(base + params.sq_off.tail);
+    ring->sqArray = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    ring->sqMask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    ring->sqEntries = params.sq_entries;
+    ring->cqHead = reinterpret_cast<unsigned*>(base + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned*>(base + params.cq_off.tail);
+    ring->cqMask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+    return ring;
+}
+
+SysattrReader::Ring::~Ring() {
+    if (sqes != MAP_FAILED) {
+        munmap(sqes, sqesSize);
+    }
+    if (rings != MAP_FAILED) {
+        munmap(rings, ringsSize);
+    }
+    close(fd);
+}
+
+io_uring_sqe& SysattrReader::Ring::Prepare(uint8_t opcode, uint64_t userData) {
+    // Only this thread moves the tail.
+    const unsigned index = (*sqTail + prepared) & sqMask;
+    io_uring_sqe& sqe = static_cast<io_uring_sqe*>(sqes)[index];
+    std::memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.user_data = userData;
+    sqArray[index] = index;
+    ++prepared;
+    return sqe;
+}
+
+template <typename OnCompletion>
+void SysattrReader::Ring::Run(OnCompletion&& onCompletion) {
+    const unsigned count = prepared;
+    prepared = 0;
+    __atomic_store_n(sqTail, *sqTail + count, __ATOMIC_RELEASE);
+
+    unsigned submitted = 0;
+    unsigned completed = 0;
+    while (completed < count) {
+        const long result = syscall(__NR_io_uring_enter, fd, count - submitted, count - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::runtime_error(std::string("Failed to read sysattrs : io_uring_enter failed : ") + std::strerror(errno) + "!");
+        }
+        submitted += static_cast<unsigned>(result);
+
+        unsigned head = *cqHead;
+        const unsigned tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe& cqe = cqes[head & cqMask];
+            onCompletion(cqe.user_data, cqe.res);
+            ++completed;
+        }
+        __atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+    }
+}
+
+#else
+
+class SysattrReader::Ring {
+public:
+    static std::unique_ptr<Ring> Create(unsigned) { return nullptr; }
+};
+
+#endif
+
+// *** SysattrReader ***
+
+SysattrReader::SysattrReader(Backend backend, std::size_t queueDepth, std::size_t threadCount) {
+    if (queueDepth < 2) {
+        throw std::invalid_argument("Failed to create SysattrReader : Queue depth must be at least 2!");
+    }
+    if (backend == Backend::IoUring) {
+        ring = Ring::Create(static_cast<unsigned>(std::min<std::size_t>(queueDepth, 4096)));
+    }
+    if (!ring) {
+        pool = std::make_unique<WorkStealingPool>(threadCount);
+    }
+}
+
+SysattrReader::~SysattrReader() = default;
+
+std::size_t SysattrReader::Add(const Device& device, const std::string& sysattr) {
+    const auto syspath = device.GetSyspathView();
+    // An empty path fails to open, the read ends up without value.
+    paths.push_back(syspath ? std::string(*syspath) + "/" + sysattr : std::string());
+    return paths.size() - 1;
+}
+
+std::size_t SysattrReader::Add(const std::string& syspath, const std::string& sysattr) {
+    paths.push_back(syspath + "/" + sysattr);
+    return paths.size() - 1;
+}
+
+std::vector<std::optional<std::string>> SysattrReader::Read() {
+    std::vector<std::optional<std::string>> results(paths.size());
+    try {
+        if (ring) {
+            ReadWithRing(results);
+        }
+        else {
+            ReadWithPool(results);
+        }
+    }
+    catch (...) {
+        paths.clear();
+        throw;
+    }
+    paths.clear();
+    return results;
+}
+
+// *** Private ***
+
+void SysattrReader::ReadWithRing(std::vector<std::optional<std::string>>& results) {
+#ifdef EVENTMONITOR_IO_URING
+    // Reads go along with their close, two entries per attribute.
+    const std::size_t chunkSize = ring->GetEntries() / 2;
+    constexpr uint64_t closeMarker = UINT64_MAX;
+    std::vector<int> fds(chunkSize);
+    std::vector<int> sizes(chunkSize);
+    std::unique_ptr<char[]> buffers(new char[chunkSize * maxValueSize]);
+
+    for (std::size_t first = 0; first < paths.size(); first += chunkSize) {
+        const std::size_t count = std::min(chunkSize, paths.size() - first);
+        for (std::size_t i = 0; i < count; ++i) {
+            io_uring_sqe& sqe = ring->Prepare(IORING_OP_OPENAT, i);
+            sqe.fd = AT_FDCWD;
+            sqe.addr = reinterpret_cast<uintptr_t>(paths[first + i].c_str());
+            sqe.open_flags = O_RDONLY | O_CLOEXEC;
+        }
+        ring->Run([&fds](uint64_t i, int result) { fds[i] = result; });
+
+        // A hard link runs the close even when the read fails.
+        for (std::size_t i = 0; i < count; ++i) {
+            if (fds[i] < 0) {
+                continue;
+            }
+            io_uring_sqe& read = ring->Prepare(IORING_OP_READ, i);
+            read.fd = fds[i];
+            read.addr = reinterpret_cast<uintptr_t>(buffers.get() + i * maxValueSize);
+            read.len = maxValueSize;
+            read.flags = IOSQE_IO_HARDLINK;
+            ring->Prepare(IORING_OP_CLOSE, closeMarker).fd = fds[i];
+        }
+        ring->Run([&sizes](uint64_t i, int result) {
+            if (i != closeMarker) {
+                sizes[i] = result;
+            }
+        });
+
+        for (std::size_t i = 0; i < count; ++i) {
+            if (fds[i] < 0) {
+                continue;
+            }
+            if (sizes[i] >= 0) {
+                results[first + i] = MakeValue(buffers.get() + i * maxValueSize, static_cast<std::size_t>(sizes[i]));
+            }
+            else if (sizes[i] == -EISDIR) {
+                results[first + i] = ReadLinkName(paths[first + i]);
+            }
+        }
+    }
+#else
+    (void) results; // Unused, the ring is never created.
+#endif
+}
+
+void SysattrReader::ReadWithPool(std::vector<std::optional<std::string>>& results) {
+    // Enough reads per task to amortize the scheduling.
+    constexpr std::size_t taskSize = 64;
+    for (std::size_t first = 0; first < paths.size(); first += taskSize) {
+        const std::size_t last = std::min(first + taskSize, paths.size());
+        pool->Submit([this, &results, first, last]() {
+            char buffer[maxValueSize];
+            for (std::size_t i = first; i < last; ++i) {
+                results[i] = ReadValue(paths[i], buffer);
+            }
+        });
+    }
+    pool->Wait();
+}
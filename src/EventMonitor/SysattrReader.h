@@ -0,0 +1,58 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/WorkStealingPool.h>
+
+// Reads many sysfs attributes, across many devices, in one batch.
+//
+// Queue (device, attribute) pairs with Add(), then Read() them all. With io_uring, every chunk of queueDepth reads
+// costs two io_uring_enter() calls (the opens, then the reads each hard-linked to its close) instead of three
+// syscalls per attribute. Without it (old kernel, seccomp, disabled by sysctl), the reads are spread over a
+// WorkStealingPool. Values follow Device::GetSysattrValue(), minus the libsystemd cache, and are truncated
+// to maxValueSize like sysfs does.
+// Not thread-safe, use one reader per thread.
+class SysattrReader {
+public:
+    enum class Backend {
+        IoUring,
+        ThreadPool
+    };
+
+    // A sysfs attribute holds at most a page.
+    static constexpr std::size_t maxValueSize = 4096;
+
+    // IoUring falls back to ThreadPool when io_uring is unavailable. A threadCount of 0 uses one worker per hardware
+    // thread, the pool is only created for the ThreadPool backend.
+    explicit SysattrReader(Backend backend = Backend::IoUring, std::size_t queueDepth = 256, std::size_t threadCount = 0);
+    ~SysattrReader();
+    SysattrReader(const SysattrReader&) = delete;
+    SysattrReader(SysattrReader&&) = delete;
+    SysattrReader& operator=(const SysattrReader&) = delete;
+    SysattrReader& operator=(SysattrReader&&) = delete;
+
+    // Queue a read, returns the index of its result in Read().
+    std::size_t Add(const Device& device, const std::string& sysattr);
+    std::size_t Add(const std::string& syspath, const std::string& sysattr);
+    // Read every queued attribute and clear the queue.
+    // Results are in the order of Add(), none for a missing or unreadable attribute.
+    std::vector<std::optional<std::string>> Read();
+
+    std::size_t GetPendingCount() const { return paths.size(); }
+    Backend GetBackend() const { return ring ? Backend::IoUring : Backend::ThreadPool; }
+
+private:
+    // io_uring instance, defined in the source so the header does not depend on the kernel headers.
+    class Ring;
+
+    void ReadWithRing(std::vector<std::optional<std::string>>& results);
+    void ReadWithPool(std::vector<std::optional<std::string>>& results);
+
+    std::unique_ptr<Ring> ring;
+    std::unique_ptr<WorkStealingPool> pool;
+    // Attribute paths, syspath then attribute.
+    std::vector<std::string> paths;
+};
@@ -0,0 +1,48 @@
+#include <EventMonitor/ThreadUtils.h>
+#include <cstring>
+#include <stdexcept>
+#include <pthread.h>
+#include <sched.h>
+
+void SetThreadAffinity(std::thread& thread, const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for (const int cpu : cpus) {
+        if (cpu < 0 || cpu >= CPU_SETSIZE) {
+            throw std::invalid_argument("Failed to set thread affinity : Invalid CPU index!");
+        }
+        CPU_SET(cpu, &cpuSet);
+    }
+
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(cpuSet), &cpuSet) != 0) {
+        throw std::runtime_error("Failed to set thread affinity : pthread_setaffinity_np failed!");
+    }
+}
+
+void SetThreadScheduling(std::thread& thread, int policy, int priority) {
+    sched_param param{};
+    param.sched_priority = priority;
+
+    const int result = pthread_setschedparam(thread.native_handle(), policy, &param);
+    if (result != 0) {
+        throw std::runtime_error(std::string("Failed to set thread scheduling : ") + std::strerror(result) + "!");
+    }
+}
+
+void ApplyThreadOptions(std::thread& thread, const ThreadOptions& options) {
+    SetThreadAffinity(thread, options.cpuAffinity);
+
+    // Leave the inherited scheduling alone when nothing was asked for.
+    if (options.schedulingPolicy != SCHED_OTHER || options.schedulingPriority != 0) {
+        SetThreadScheduling(thread, options.schedulingPolicy, options.schedulingPriority);
+    }
+
+    if (!options.name.empty()) {
+        // pthread_setname_np() fails on names longer than 15 characters.
+        pthread_setname_np(thread.native_handle(), options.name.substr(0, 15).c_str());
+    }
+}
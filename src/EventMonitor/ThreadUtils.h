@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+#include <sched.h>
+
+// How a dedicated thread (e.g. an Event loop thread) should be scheduled.
+struct ThreadOptions {
+    // CPUs the thread may run on, empty to leave the affinity untouched.
+    std::vector<int> cpuAffinity;
+    // SCHED_OTHER, SCHED_BATCH, SCHED_IDLE, or the real-time SCHED_FIFO and SCHED_RR (which need CAP_SYS_NICE).
+    int schedulingPolicy = SCHED_OTHER;
+    // 1 to 99 for real-time policies, 0 otherwise.
+    int schedulingPriority = 0;
+    // Shown by ps and top, truncated to 15 characters. Empty to keep the inherited name.
+    std::string name;
+};
+
+// Restrict the thread to the given CPUs. An empty list leaves the affinity untouched.
+void SetThreadAffinity(std::thread& thread, const std::vector<int>& cpus);
+void SetThreadScheduling(std::thread& thread, int policy, int priority);
+// Affinity, scheduling and name of the options.
+void ApplyThreadOptions(std::thread& thread, const ThreadOptions& options);
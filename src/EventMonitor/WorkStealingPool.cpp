@@ -0,0 +1,164 @@
+#include <EventMonitor/WorkStealingPool.h>
+#include <EventMonitor/ThreadUtils.h>
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+    // Identifies the pool and worker index of the calling thread, if it is a worker.
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local std::size_t currentWorker = 0;
+}
+
+// *** Public ***
+
+WorkStealingPool::WorkStealingPool(std::size_t threadCount, const std::vector<int>& cpuAffinity)
+    : nextWorker(0),
+      queuedCount(0),
+      pendingCount(0),
+      stopping(false) {
+    if (threadCount == 0) {
+        threadCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Create every worker before starting any thread, since workers steal from each other.
+    workers.reserve(threadCount);
+    for (std::size_t i = 0; i < threadCount; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+    }
+
+    try {
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            workers[i]->thread = std::thread(&WorkStealingPool::WorkerLoop, this, i);
+            if (!cpuAffinity.empty()) {
+                SetThreadAffinity(workers[i]->thread, { cpuAffinity[i % cpuAffinity.size()] });
+            }
+        }
+    }
+    catch (...) {
+        Stop();
+        throw;
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    Stop();
+}
+
+bool WorkStealingPool::Submit(Task task) {
+    if (!task) {
+        throw std::invalid_argument("Failed to submit task : Task cannot be null!");
+    }
+
+    // Counted under the idle mutex, so Stop() either refuses the task or lets the workers run it before leaving.
+    // It also orders the notification after any worker's last check before sleeping.
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        if (stopping.load()) {
+            return false;
+        }
+        pendingCount.fetch_add(1);
+        queuedCount.fetch_add(1);
+    }
+
+    const std::size_t index = (currentPool == this)
+        ? currentWorker
+        : nextWorker.fetch_add(1, std::memory_order_relaxed) % workers.size();
+    {
+        std::lock_guard<std::mutex> lock(workers[index]->mutex);
+        workers[index]->tasks.push_back(std::move(task));
+    }
+    workAvailable.notify_one();
+
+    return true;
+}
+
+void WorkStealingPool::Wait() {
+    std::unique_lock<std::mutex> lock(idleMutex);
+    allDone.wait(lock, [this]() { return pendingCount.load() == 0; });
+}
+
+void WorkStealingPool::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex);
+        if (stopping.exchange(true)) {
+            return;
+        }
+    }
+    workAvailable.notify_all();
+
+    for (auto& worker : workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+std::vector<WorkStealingPool::WorkerStats> WorkStealingPool::GetStats() const {
+    std::vector<WorkerStats> stats;
+    stats.reserve(workers.size());
+    for (const auto& worker : workers) {
+        std::size_t depth = 0;
+        {
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            depth = worker->tasks.size();
+        }
+        stats.push_back({ depth, worker->executedCount.load(std::memory_order_relaxed), worker->stolenCount.load(std::memory_order_relaxed) });
+    }
+    return stats;
+}
+
+// *** Private ***
+
+void WorkStealingPool::WorkerLoop(std::size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    Worker& self = *workers[index];
+    for (;;) {
+        Task task;
+        if (TryPopOwn(index, task) || TrySteal(index, task)) {
+            queuedCount.fetch_sub(1);
+            task();
+            self.executedCount.fetch_add(1, std::memory_order_relaxed);
+
+            if (pendingCount.fetch_sub(1) == 1) {
+                std::lock_guard<std::mutex> lock(idleMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex);
+        // Queued tasks are still run when stopping, workers only leave once everything is drained.
+        if (stopping.load() && queuedCount.load() == 0) {
+            return;
+        }
+        workAvailable.wait(lock, [this]() { return queuedCount.load() > 0 || stopping.load(); });
+    }
+}
+
+bool WorkStealingPool::TryPopOwn(std::size_t index, Task& task) {
+    Worker& worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    task = std::move(worker.tasks.back());
+    worker.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::TrySteal(std::size_t thiefIndex, Task& task) {
+    for (std::size_t offset = 1; offset < workers.size(); ++offset) {
+        Worker& victim = *workers[(thiefIndex + offset) % workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        workers[thiefIndex]->stolenCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
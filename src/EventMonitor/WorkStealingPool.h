@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size thread pool where every worker owns a task deque.
+//
+// Workers take their own most recent task first and, once out of work, steal the oldest task of another worker.
+// Tasks submitted from a worker go to its own deque, other submissions are spread round-robin.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    struct WorkerStats {
+        std::size_t queueDepth;
+        uint64_t executedCount;
+        // Tasks this worker took from another worker's deque.
+        uint64_t stolenCount;
+    };
+
+    // A threadCount of 0 uses one worker per hardware thread.
+    // Worker i is pinned to cpuAffinity[i % cpuAffinity.size()] when cpuAffinity is not empty.
+    explicit WorkStealingPool(std::size_t threadCount = 0, const std::vector<int>& cpuAffinity = {});
+    // Stop() the pool.
+    ~WorkStealingPool();
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool(WorkStealingPool&&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(WorkStealingPool&&) = delete;
+
+    // Tasks must not throw. Returns false, discarding the task, once the pool is stopping.
+    bool Submit(Task task);
+    // Block until every submitted task, including the ones they submitted, has run.
+    void Wait();
+    // Run the queued tasks, then join the workers. Tasks submitted afterwards are discarded.
+    void Stop();
+
+    std::size_t GetThreadCount() const { return workers.size(); }
+    std::vector<WorkerStats> GetStats() const;
+
+private:
+    struct Worker {
+        mutable std::mutex mutex;
+        std::deque<Task> tasks;
+        std::atomic<uint64_t> executedCount{0};
+        std::atomic<uint64_t> stolenCount{0};
+        std::thread thread;
+    };
+
+    void WorkerLoop(std::size_t index);
+    bool TryPopOwn(std::size_t index, Task& task);
+    bool TrySteal(std::size_t thiefIndex, Task& task);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<std::size_t> nextWorker;
+
+    // Tasks sitting in a deque, used to put idle workers to sleep.
+    std::atomic<std::size_t> queuedCount;
+    // Tasks submitted and not finished yet, used by Wait().
+    std::atomic<std::size_t> pendingCount;
+    std::atomic<bool> stopping;
+
+    std::mutex idleMutex;
+    std::condition_variable workAvailable;
+    std::condition_variable allDone;
+};
@@ -0,0 +1,83 @@
+#!/usr/bin/env python3
+"""Run BenchEventMonitor and compare its timings against a stored baseline.
+
+Exits with 1 when a benchmark got slower than the threshold allows, and with 77 (skipped for CTest)
+when there is no baseline yet. With --update, the baseline is rewritten from the current run instead.
+"""
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+import tempfile
+
+SKIPPED = 77
+
+
+def run_benchmark(executable, repetitions):
+    with tempfile.NamedTemporaryFile(suffix=".json", delete=False) as output:
+        path = output.name
+    try:
+        subprocess.run([executable,
+                        "--benchmark_out=" + path,
+                        "--benchmark_out_format=json",
+                        "--benchmark_repetitions=%d" % repetitions,
+                        "--benchmark_report_aggregates_only=true"],
+                       check=True, stdout=subprocess.DEVNULL)
+        with open(path) as results:
+            return json.load(results)
+    finally:
+        os.unlink(path)
+
+
+def median_times(results):
+    """Median CPU time of every benchmark, in nanoseconds."""
+    scale = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+    times = {}
+    for benchmark in results["benchmarks"]:
+        if benchmark.get("aggregate_name") == "median":
+            times[benchmark["run_name"]] = benchmark["cpu_time"] * scale[benchmark["time_unit"]]
+    return times
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("--benchmark", required=True, help="path to BenchEventMonitor")
+    parser.add_argument("--baseline", required=True, help="baseline JSON file")
+    parser.add_argument("--threshold", type=float, default=0.25, help="allowed relative slowdown")
+    parser.add_argument("--repetitions", type=int, default=5)
+    parser.add_argument("--update", action="store_true", help="rewrite the baseline from this run")
+    args = parser.parse_args()
+
+    if not args.update and not os.path.exists(args.baseline):
+        print("No baseline at %s, build the UpdateBenchBaseline target to record one." % args.baseline)
+        return SKIPPED
+
+    current = median_times(run_benchmark(args.benchmark, args.repetitions))
+
+    if args.update:
+        with open(args.baseline, "w") as baseline:
+            json.dump(current, baseline, indent=2, sort_keys=True)
+            baseline.write("\n")
+        print("Baseline of %d benchmarks written to %s" % (len(current), args.baseline))
+        return 0
+
+    with open(args.baseline) as baseline:
+        reference = json.load(baseline)
+
+    regressions = 0
+    for name, time in sorted(current.items()):
+        if name not in reference:
+            print("%-60s %12.1f ns  (new)" % (name, time))
+            continue
+        ratio = time / reference[name] if reference[name] > 0 else 1.0
+        regressed = ratio > 1.0 + args.threshold
+        regressions += regressed
+        print("%-60s %12.1f ns  %+7.1f%%%s" % (name, time, (ratio - 1.0) * 100, "  REGRESSION" if regressed else ""))
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,88 @@
+#include <benchmark/benchmark.h>
+#include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+
+namespace {
+    // First enumerated device, with a devnum if requireDevnum is set.
+    std::optional<std::string> FindSyspath(bool requireDevnum) {
+        const DeviceEnumerator enumerator;
+        for (const Device& device : enumerator.Borrowed()) {
+            if (!requireDevnum || device.GetDevnum()) {
+                return device.GetSyspath();
+            }
+        }
+        return std::nullopt;
+    }
+}
+
+static void BM_DeviceCreateFromSyspath(benchmark::State& state) {
+    const auto syspath = FindSyspath(false);
+    if (!syspath) {
+        state.SkipWithError("No device on this system.");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Device::CreateFromSyspath(*syspath));
+    }
+}
+BENCHMARK(BM_DeviceCreateFromSyspath);
+
+static void BM_DeviceCreateFromDevnum(benchmark::State& state) {
+    const auto syspath = FindSyspath(true);
+    if (!syspath) {
+        state.SkipWithError("No device with a devnum on this system.");
+        return;
+    }
+    const auto device = Device::CreateFromSyspath(*syspath);
+    const char type = device.GetSubsystemView() == std::string_view("block") ? 'b' : 'c';
+    const dev_t devnum = *device.GetDevnum();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Device::CreateFromDevnum(type, devnum));
+    }
+}
+BENCHMARK(BM_DeviceCreateFromDevnum);
+
+// Every getter of an already created device, state.range(0) telling whether the cache is refreshed.
+static void BM_DeviceGetters(benchmark::State& state) {
+    const auto syspath = FindSyspath(false);
+    if (!syspath) {
+        state.SkipWithError("No device on this system.");
+        return;
+    }
+    const auto device = Device::CreateFromSyspath(*syspath);
+    const bool refreshCache = state.range(0) != 0;
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < static_cast<std::size_t>(DeviceField::Count); ++i) {
+            benchmark::DoNotOptimize(device.GetField(static_cast<DeviceField>(i), refreshCache));
+        }
+    }
+}
+BENCHMARK(BM_DeviceGetters)->ArgName("refresh")->Arg(0)->Arg(1);
+
+static void BM_DeviceViews(benchmark::State& state) {
+    const auto syspath = FindSyspath(false);
+    if (!syspath) {
+        state.SkipWithError("No device on this system.");
+        return;
+    }
+    const auto device = Device::CreateFromSyspath(*syspath);
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < static_cast<std::size_t>(DeviceField::Count); ++i) {
+            benchmark::DoNotOptimize(device.GetFieldView(static_cast<DeviceField>(i)));
+        }
+    }
+}
+BENCHMARK(BM_DeviceViews);
+
+static void BM_DevicePrefetchAll(benchmark::State& state) {
+    const auto syspath = FindSyspath(false);
+    if (!syspath) {
+        state.SkipWithError("No device on this system.");
+        return;
+    }
+    const auto device = Device::CreateFromSyspath(*syspath);
+    for (auto _ : state) {
+        device.PrefetchAll(true);
+    }
+}
+BENCHMARK(BM_DevicePrefetchAll);
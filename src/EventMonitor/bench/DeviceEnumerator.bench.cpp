@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/DeviceInventory.h>
+#include <EventMonitor/DeviceSet.h>
+#include <filesystem>
+#include <unistd.h>
+
+// A new enumerator every iteration, libsystemd caches the scan of an enumerator.
+static void BM_EnumerateAllDevices(benchmark::State& state) {
+    for (auto _ : state) {
+        const DeviceEnumerator enumerator;
+        benchmark::DoNotOptimize(enumerator.GetAllDevices());
+    }
+}
+BENCHMARK(BM_EnumerateAllDevices)->Unit(benchmark::kMillisecond);
+
+static void BM_EnumerateFilteredDevices(benchmark::State& state) {
+    for (auto _ : state) {
+        DeviceEnumerator enumerator;
+        enumerator.AddMatchSubsystem("pci", true);
+        benchmark::DoNotOptimize(enumerator.GetAllDevices());
+    }
+}
+BENCHMARK(BM_EnumerateFilteredDevices)->Unit(benchmark::kMillisecond);
+
+static void BM_EnumerateFirstDevice(benchmark::State& state) {
+    for (auto _ : state) {
+        const DeviceEnumerator enumerator;
+        benchmark::DoNotOptimize(enumerator.begin());
+    }
+}
+BENCHMARK(BM_EnumerateFirstDevice)->Unit(benchmark::kMillisecond);
+
+// Full enumeration reading every field, state.range(0) threads, 0 for the sequential version.
+static void BM_EnumerateAndReadAll(benchmark::State& state) {
+    const auto threadCount = static_cast<std::size_t>(state.range(0));
+    for (auto _ : state) {
+        const DeviceEnumerator enumerator;
+        if (threadCount == 0) {
+            auto devices = enumerator.GetAllDevices();
+            for (const auto& device : devices) {
+                device.PrefetchAll();
+            }
+            benchmark::DoNotOptimize(devices);
+        }
+        else {
+            benchmark::DoNotOptimize(enumerator.GetAllDevicesParallel(threadCount, allDeviceFields));
+        }
+    }
+}
+BENCHMARK(BM_EnumerateAndReadAll)->ArgName("threads")->Arg(0)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// Restart path of a persisted inventory : map it and answer a lookup, to compare with BM_EnumerateAndReadAll.
+static void BM_InventoryFirstQuery(benchmark::State& state) {
+    const std::string path =
+        (std::filesystem::temp_directory_path() / ("BM_InventoryFirstQuery-" + std::to_string(getpid()) + ".inventory")).string();
+    DeviceInventory::Write(path, DeviceEnumerator());
+    const std::string syspath = std::string(DeviceInventory(path)[0].GetSyspath());
+    for (auto _ : state) {
+        const DeviceInventory inventory(path);
+        benchmark::DoNotOptimize(inventory.Find(syspath)->GetProperty("SUBSYSTEM"));
+    }
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_InventoryFirstQuery)->Unit(benchmark::kMicrosecond);
+
+// Drift check : summarize a fresh enumeration and diff it against the previous one.
+static void BM_EnumerateAndDiff(benchmark::State& state) {
+    const DeviceSet previous{ DeviceEnumerator() };
+    for (auto _ : state) {
+        const DeviceSet current{ DeviceEnumerator() };
+        benchmark::DoNotOptimize(previous.Diff(current));
+    }
+}
+BENCHMARK(BM_EnumerateAndDiff)->Unit(benchmark::kMillisecond);
+
+// Diff alone, state.range(0) devices on each side with one in a hundred changed.
+static void BM_DiffDeviceSets(benchmark::State& state) {
+    std::vector<Device> before;
+    std::vector<Device> after;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        const std::string devpath = "/devices/bench/device" + std::to_string(i);
+        before.push_back(Device::CreateFromProperties(DeviceProperties({ { "DEVPATH", devpath }, { "SUBSYSTEM", "bench" }, { "DRIVER", "bench" } })));
+        after.push_back(Device::CreateFromProperties(DeviceProperties({ { "DEVPATH", devpath }, { "SUBSYSTEM", "bench" }, { "DRIVER", (i % 100) ? "bench" : "changed" } })));
+    }
+    const DeviceSet older(before);
+    const DeviceSet newer(after);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(older.Diff(newer));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_DiffDeviceSets)->ArgName("devices")->Arg(50000)->Unit(benchmark::kMillisecond);
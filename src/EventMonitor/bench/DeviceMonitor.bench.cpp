@@ -0,0 +1,118 @@
+#include <benchmark/benchmark.h>
+#include <EventMonitor/DeviceMonitor.h>
+#include <atomic>
+#include <thread>
+
+// Dispatch benchmarks inject synthetic detached devices, no udev or hardware needed.
+
+namespace {
+    DeviceProperties MakeProperties(int64_t index) {
+        const std::string devpath = "/devices/virtual/bench/dev" + std::to_string(index % 64);
+        return DeviceProperties({
+            { "ACTION", "change" },
+            { "DEVPATH", devpath },
+            { "SUBSYSTEM", "bench" },
+            { "SEQNUM", std::to_string(index) },
+            { "ID_VENDOR_ID", "0403" },
+            { "ID_MODEL_ID", "6001" }
+        });
+    }
+}
+
+static void BM_CreateDetachedDevice(benchmark::State& state) {
+    const DeviceProperties properties = MakeProperties(0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(Device::CreateFromProperties(properties));
+    }
+}
+BENCHMARK(BM_CreateDetachedDevice);
+
+static void BM_DispatchInline(benchmark::State& state) {
+    const DeviceProperties properties = MakeProperties(0);
+    DeviceMonitor monitor;
+    uint64_t handled = 0;
+    monitor.SetCallback([&handled](const DeviceMonitor&, Device device) {
+        handled += device.GetSyspathView().has_value();
+    });
+    for (auto _ : state) {
+        monitor.Inject(Device::CreateFromProperties(properties));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(handled));
+}
+BENCHMARK(BM_DispatchInline);
+
+static void BM_DispatchBatched(benchmark::State& state) {
+    const DeviceProperties properties = MakeProperties(0);
+    DeviceMonitor monitor;
+    uint64_t handled = 0;
+    monitor.SetBatchCallback([&handled](const DeviceMonitor&, std::vector<Device> devices) {
+        handled += devices.size();
+    }, static_cast<std::size_t>(state.range(0)), std::chrono::microseconds(0));
+    for (auto _ : state) {
+        monitor.Inject(Device::CreateFromProperties(properties));
+    }
+    monitor.FlushBatch();
+    state.SetItemsProcessed(static_cast<int64_t>(handled));
+}
+BENCHMARK(BM_DispatchBatched)->ArgName("batch")->Arg(16)->Arg(256);
+
+namespace {
+    // Devices injected per iteration of the consumer benchmarks, each iteration waiting for them to be handled.
+    constexpr int64_t dispatchBurst = 256;
+}
+
+// Time to hand a burst of devices to the consumers and have them all handled.
+static void BM_DispatchQueued(benchmark::State& state) {
+    const DeviceProperties properties = MakeProperties(0);
+    DeviceMonitor monitor;
+    std::atomic<uint64_t> handled{0};
+    monitor.SetCallback([&handled](const DeviceMonitor&, Device) {
+        handled.fetch_add(1, std::memory_order_relaxed);
+    });
+    monitor.EnableQueuedDispatch(1 << 16, static_cast<std::size_t>(state.range(0)));
+
+    uint64_t injected = 0;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < dispatchBurst; ++i) {
+            monitor.Inject(Device::CreateFromProperties(properties));
+        }
+        injected += dispatchBurst;
+        while (handled.load(std::memory_order_relaxed) + monitor.GetDroppedCount() < injected) {
+            std::this_thread::yield();
+        }
+    }
+    monitor.DisableQueuedDispatch();
+    state.SetItemsProcessed(static_cast<int64_t>(handled.load()));
+    state.counters["dropped"] = static_cast<double>(monitor.GetDroppedCount());
+}
+BENCHMARK(BM_DispatchQueued)->ArgName("consumers")->Arg(1)->Arg(4)->UseRealTime();
+
+// Same, with the per-device ordered executor.
+static void BM_DispatchExecutor(benchmark::State& state) {
+    DeviceMonitor monitor;
+    std::atomic<uint64_t> handled{0};
+    monitor.SetCallback([&handled](const DeviceMonitor&, Device) {
+        handled.fetch_add(1, std::memory_order_relaxed);
+    });
+    monitor.EnableExecutorDispatch(static_cast<std::size_t>(state.range(0)));
+
+    // Several devices so the shards can run in parallel.
+    std::vector<DeviceProperties> properties;
+    for (int64_t i = 0; i < 64; ++i) {
+        properties.push_back(MakeProperties(i));
+    }
+    std::size_t next = 0;
+    uint64_t injected = 0;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < dispatchBurst; ++i) {
+            monitor.Inject(Device::CreateFromProperties(properties[next++ % properties.size()]));
+        }
+        injected += dispatchBurst;
+        while (handled.load(std::memory_order_relaxed) < injected) {
+            std::this_thread::yield();
+        }
+    }
+    monitor.DisableExecutorDispatch();
+    state.SetItemsProcessed(static_cast<int64_t>(handled.load()));
+}
+BENCHMARK(BM_DispatchExecutor)->ArgName("threads")->Arg(1)->Arg(4)->UseRealTime();
@@ -0,0 +1,31 @@
+#include <benchmark/benchmark.h>
+#include <EventMonitor/DeviceTopology.h>
+
+static void BM_BuildTopology(benchmark::State& state) {
+    for (auto _ : state) {
+        DeviceTopology topology;
+        topology.Build(DeviceEnumerator());
+        benchmark::DoNotOptimize(topology.GetSize());
+    }
+}
+BENCHMARK(BM_BuildTopology)->Unit(benchmark::kMillisecond);
+
+// Hot-unplug path : the whole subtree of the root with the most descendants.
+static void BM_TopologyDescendants(benchmark::State& state) {
+    DeviceTopology topology;
+    topology.Build(DeviceEnumerator());
+    DeviceTopology::NodeId largest = 0;
+    std::size_t largestSize = 0;
+    for (const auto root : topology.GetRoots()) {
+        const std::size_t size = topology.GetDescendants(root).size();
+        if (size > largestSize) {
+            largest = root;
+            largestSize = size;
+        }
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(topology.GetDescendants(largest));
+    }
+    state.counters["descendants"] = static_cast<double>(largestSize);
+}
+BENCHMARK(BM_TopologyDescendants)->Unit(benchmark::kMicrosecond);
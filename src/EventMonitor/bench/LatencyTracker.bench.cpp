@@ -0,0 +1,25 @@
+#include <benchmark/benchmark.h>
+#include <EventMonitor/LatencyTracker.h>
+
+static void BM_HistogramRecord(benchmark::State& state) {
+    LatencyHistogram histogram;
+    uint64_t value = 1;
+    for (auto _ : state) {
+        histogram.Record(value);
+        value = value * 6364136223846793005ull + 1442695040888963407ull;
+        value >>= 40;
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(histogram.GetCount()));
+}
+BENCHMARK(BM_HistogramRecord)->ThreadRange(1, 4);
+
+static void BM_TrackerRecord(benchmark::State& state) {
+    static LatencyTracker tracker;
+    for (auto _ : state) {
+        auto& series = tracker.GetSeries("usb", SD_DEVICE_ADD);
+        const uint64_t entered = LatencyTracker::Now();
+        tracker.Record(series, 0, entered - 1000, entered, LatencyTracker::Now());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrackerRecord)->ThreadRange(1, 4);
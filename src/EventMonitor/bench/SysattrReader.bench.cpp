@@ -0,0 +1,51 @@
+#include <benchmark/benchmark.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/SysattrReader.h>
+
+namespace {
+    const std::vector<std::string> sysattrs{ "uevent", "dev", "driver", "subsystem", "modalias", "power/control" };
+
+    std::vector<std::string> GetSyspaths() {
+        std::vector<std::string> syspaths;
+        for (const Device& device : DeviceEnumerator()) {
+            syspaths.push_back(*device.GetSyspath());
+        }
+        return syspaths;
+    }
+}
+
+// One sd_device_get_sysattr_value() per attribute, on fresh devices since libsystemd caches the values.
+static void BM_ReadSysattrsWithLibsystemd(benchmark::State& state) {
+    const auto syspaths = GetSyspaths();
+    for (auto _ : state) {
+        for (const auto& syspath : syspaths) {
+            const Device device = Device::CreateFromSyspath(syspath);
+            for (const auto& sysattr : sysattrs) {
+                benchmark::DoNotOptimize(device.GetSysattrValue(sysattr));
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(syspaths.size() * sysattrs.size()));
+}
+BENCHMARK(BM_ReadSysattrsWithLibsystemd)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+// state.range(0) : 0 for io_uring, otherwise the number of threads of the pool.
+static void BM_ReadSysattrsInBatch(benchmark::State& state) {
+    const auto syspaths = GetSyspaths();
+    const bool ring = state.range(0) == 0;
+    SysattrReader reader(ring ? SysattrReader::Backend::IoUring : SysattrReader::Backend::ThreadPool, 256, static_cast<std::size_t>(state.range(0)));
+    if (ring && reader.GetBackend() != SysattrReader::Backend::IoUring) {
+        state.SkipWithError("io_uring is unavailable");
+        return;
+    }
+    for (auto _ : state) {
+        for (const auto& syspath : syspaths) {
+            for (const auto& sysattr : sysattrs) {
+                reader.Add(syspath, sysattr);
+            }
+        }
+        benchmark::DoNotOptimize(reader.Read());
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(syspaths.size() * sysattrs.size()));
+}
+BENCHMARK(BM_ReadSysattrsInBatch)->ArgName("threads")->Arg(0)->Arg(1)->Arg(4)->Unit(benchmark::kMillisecond)->UseRealTime();
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/AttributeWatcher.h>
+#include <fstream>
+#include <vector>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    // Regular files cannot be polled, so attributes outside of sysfs are always read by the poll timer.
+    class AttributeWatcherTest : public testing::Test {
+    protected:
+        void SetUp() override {
+            directory = testing::TempDir() + "attributes_" + std::to_string(getpid());
+            mkdir(directory.c_str(), 0755);
+            WriteAttribute("capacity", "50\n");
+        }
+
+        void TearDown() override {
+            unlink((directory + "/capacity").c_str());
+            rmdir(directory.c_str());
+        }
+
+        void WriteAttribute(const std::string& name, const std::string& value) {
+            std::ofstream(directory + "/" + name, std::ios::trunc) << value;
+        }
+
+        // Run the loop until count changes were received or the timeout elapsed.
+        void RunUntil(const std::vector<AttributeChange>& changes, std::size_t count) {
+            for (int i = 0; i < 200 && changes.size() < count; ++i) {
+                ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+            }
+        }
+
+        std::shared_ptr<Event> event = std::make_shared<Event>();
+        std::string directory;
+    };
+}
+
+TEST_F(AttributeWatcherTest, RejectsInvalidIntervals) {
+    EXPECT_THROW(AttributeWatcher(event, std::chrono::microseconds(0)), std::invalid_argument);
+    EXPECT_THROW(AttributeWatcher(event, std::chrono::seconds(2), std::chrono::seconds(1)), std::invalid_argument);
+    EXPECT_THROW(AttributeWatcher(nullptr), std::invalid_argument);
+}
+
+TEST_F(AttributeWatcherTest, ThrowsForMissingAttribute) {
+    AttributeWatcher watcher(event);
+    EXPECT_THROW(watcher.Watch(directory, "missing"), std::runtime_error);
+    EXPECT_THROW(watcher.Watch(directory, ""), std::invalid_argument);
+    EXPECT_EQ(watcher.GetWatchCount(), 0u);
+}
+
+TEST_F(AttributeWatcherTest, ReportsPolledChanges) {
+    AttributeWatcher watcher(event, std::chrono::milliseconds(1), std::chrono::milliseconds(8));
+    std::vector<AttributeChange> changes;
+    watcher.SetCallback([&changes](const AttributeWatcher&, const AttributeChange& change) {
+        changes.push_back(change);
+    });
+
+    const auto id = watcher.Watch(directory, "capacity", AttributeWatcher::Mode::Poll);
+    EXPECT_EQ(watcher.GetValue(id), "50");
+    EXPECT_EQ(watcher.GetPolledCount(), 1u);
+
+    WriteAttribute("capacity", "49\n");
+    RunUntil(changes, 1);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(changes[0].id, id);
+    EXPECT_EQ(changes[0].syspath, directory);
+    EXPECT_EQ(changes[0].sysattr, "capacity");
+    EXPECT_EQ(changes[0].value, "49");
+    EXPECT_EQ(changes[0].previousValue, "50");
+    EXPECT_EQ(watcher.GetValue(id), "49");
+
+    unlink((directory + "/capacity").c_str());
+    RunUntil(changes, 2);
+    ASSERT_EQ(changes.size(), 2u);
+    EXPECT_FALSE(changes[1].value.has_value()) << "A removed attribute is reported without value.";
+}
+
+TEST_F(AttributeWatcherTest, AdaptsPollInterval) {
+    AttributeWatcher watcher(event, std::chrono::milliseconds(1), std::chrono::milliseconds(4));
+    std::vector<AttributeChange> changes;
+    watcher.SetCallback([&changes](const AttributeWatcher&, const AttributeChange& change) {
+        changes.push_back(change);
+    });
+    watcher.Watch(directory, "capacity", AttributeWatcher::Mode::Poll);
+
+    // Rounds without change double the interval up to the maximum.
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    EXPECT_EQ(watcher.GetPollInterval(), std::chrono::milliseconds(4));
+
+    WriteAttribute("capacity", "51\n");
+    RunUntil(changes, 1);
+    ASSERT_EQ(changes.size(), 1u);
+    EXPECT_EQ(watcher.GetPollInterval(), std::chrono::milliseconds(1)) << "A change brings back the minimum interval.";
+}
+
+TEST_F(AttributeWatcherTest, NotifyFallsBackToPolling) {
+    AttributeWatcher watcher(event, std::chrono::milliseconds(1));
+    watcher.Watch(directory, "capacity", AttributeWatcher::Mode::Notify);
+    EXPECT_EQ(watcher.GetPolledCount(), 1u) << "Regular files cannot be polled for sysfs_notify().";
+}
+
+TEST_F(AttributeWatcherTest, UnwatchesFromCallback) {
+    AttributeWatcher watcher(event, std::chrono::milliseconds(1));
+    std::vector<AttributeChange> changes;
+    const auto first = watcher.Watch(directory, "capacity", AttributeWatcher::Mode::Poll);
+    const auto second = watcher.Watch(directory, "capacity", AttributeWatcher::Mode::Poll);
+    watcher.SetCallback([&watcher, &changes, first, second](const AttributeWatcher&, const AttributeChange& change) {
+        changes.push_back(change);
+        // Whichever comes first removes both.
+        watcher.Unwatch(first);
+        watcher.Unwatch(second);
+    });
+
+    WriteAttribute("capacity", "10\n");
+    RunUntil(changes, 1);
+    for (int i = 0; i < 5; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 2000), 0);
+    }
+    EXPECT_EQ(changes.size(), 1u);
+    EXPECT_EQ(watcher.GetWatchCount(), 0u);
+    EXPECT_FALSE(watcher.Unwatch(first));
+    EXPECT_FALSE(watcher.GetValue(first).has_value());
+}
+
+TEST_F(AttributeWatcherTest, NotifiesSysfsAttribute) {
+    // Any readable attribute of a real device, sysfs files accept EPOLLPRI.
+    const std::string syspath = "/sys/kernel/mm";
+    if (access((syspath + "/transparent_hugepage/enabled").c_str(), R_OK) != 0) {
+        GTEST_SKIP() << "No readable sysfs attribute.";
+    }
+    AttributeWatcher watcher(event);
+    const auto id = watcher.Watch(syspath, "transparent_hugepage/enabled", AttributeWatcher::Mode::Notify);
+    EXPECT_TRUE(watcher.GetValue(id).has_value());
+    EXPECT_EQ(watcher.GetPolledCount(), 0u);
+    EXPECT_TRUE(watcher.Unwatch(id));
+}
@@ -1,4 +1,97 @@
 #include <gtest/gtest.h>
 #include <EventMonitor/Device.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <sys/sysmacros.h>
 
-// (...)
\ No newline at end of file
+TEST(DeviceTest, PrefetchMatchesGetters) {
+    const auto devices = DeviceEnumerator().GetAllDevices();
+    for (const auto& device : devices) {
+        const auto syspath = device.GetSyspath();
+        ASSERT_TRUE(syspath.has_value());
+        const auto fresh = Device::CreateFromSyspath(*syspath);
+        fresh.PrefetchAll();
+
+        for (std::size_t i = 0; i < static_cast<std::size_t>(DeviceField::Count); ++i) {
+            const auto field = static_cast<DeviceField>(i);
+            EXPECT_EQ(fresh.GetField(field), device.GetField(field)) << "Mismatch for field " << i << " of " << *syspath;
+        }
+    }
+}
+
+TEST(DeviceTest, PrefetchOnlyRequestedFields) {
+    const auto device = DeviceEnumerator().GetDeviceFirst();
+    if (!device) {
+        GTEST_SKIP() << "No device on this system.";
+    }
+
+    device->Prefetch(DeviceFieldBit(DeviceField::Syspath) | DeviceFieldBit(DeviceField::Serial));
+    const auto expected = device->GetSyspath();
+    device->Prefetch(allDeviceFields);
+    EXPECT_EQ(device->GetSyspath(), expected);
+}
+
+TEST(DeviceTest, GetAllPropertiesIsSorted) {
+    const auto devices = DeviceEnumerator().GetAllDevices();
+    for (const auto& device : devices) {
+        const auto properties = device.GetAllProperties();
+        for (std::size_t i = 1; i < properties.GetSize(); ++i) {
+            EXPECT_LT(properties[i - 1].first, properties[i].first);
+        }
+        for (const auto& [key, value] : properties) {
+            const auto expected = device.GetPropertyFromKey(std::string(key));
+            ASSERT_TRUE(expected.has_value()) << key;
+            EXPECT_EQ(*expected, value);
+            EXPECT_EQ(properties.Find(key), value);
+        }
+        EXPECT_EQ(properties.Find("EVENTMONITOR_NOT_A_PROPERTY"), std::nullopt);
+    }
+}
+
+TEST(DeviceTest, ViewsMatchGetters) {
+    const auto devices = DeviceEnumerator().GetAllDevices();
+    for (const auto& device : devices) {
+        for (std::size_t i = 0; i < static_cast<std::size_t>(DeviceField::Count); ++i) {
+            const auto field = static_cast<DeviceField>(i);
+            const auto view = device.GetFieldView(field);
+            const auto& value = device.GetField(field);
+            ASSERT_EQ(view.has_value(), value.has_value()) << "Presence mismatch for field " << i;
+            if (value) {
+                EXPECT_EQ(*view, *value) << "Value mismatch for field " << i;
+            }
+        }
+
+        EXPECT_EQ(device.GetPropertyView("SUBSYSTEM"), device.GetSubsystemView());
+        EXPECT_EQ(device.GetPropertyView(std::string(200, 'X')), std::nullopt);
+    }
+}
+
+TEST(DeviceTest, CreateFromPropertiesDerivesFields) {
+    const auto device = Device::CreateFromProperties(DeviceProperties({
+        { "ACTION", "add" },
+        { "DEVPATH", "/devices/pci0000:00/0000:00:14.0/usb1/1-2" },
+        { "SUBSYSTEM", "usb" },
+        { "DEVNAME", "bus/usb/001/003" },
+        { "DEVTYPE", "usb_device" },
+        { "MAJOR", "189" },
+        { "MINOR", "2" },
+        { "SEQNUM", "4242" },
+        { "ID_VENDOR_ID", "0403" },
+        { "TAGS", ":seat:uaccess:" }
+    }));
+
+    EXPECT_TRUE(device.IsDetached());
+    EXPECT_EQ(device.GetAction(), SD_DEVICE_ADD);
+    EXPECT_EQ(device.GetSeqnum(), 4242u);
+    EXPECT_EQ(device.GetSyspath(), "/sys/devices/pci0000:00/0000:00:14.0/usb1/1-2");
+    EXPECT_EQ(device.GetSysname(), "1-2");
+    EXPECT_EQ(device.GetSysnum(), "2");
+    EXPECT_EQ(device.GetDevname(), "/dev/bus/usb/001/003");
+    EXPECT_EQ(device.GetType(), "usb_device");
+    EXPECT_EQ(device.GetDevnum(), makedev(189, 2));
+    EXPECT_EQ(device.GetVendorIDView(), "0403");
+    EXPECT_EQ(device.GetPropertyView("SUBSYSTEM"), "usb");
+    EXPECT_EQ(device.GetPropertyFromKey("MINOR"), "2");
+    EXPECT_EQ(device.GetDriver(), std::nullopt);
+    EXPECT_EQ(device.GetTags(), (std::vector<std::string>{ "seat", "uaccess" }));
+    EXPECT_EQ(device.GetAllProperties().GetSize(), 10u);
+}
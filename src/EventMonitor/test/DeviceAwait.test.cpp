@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceMonitor.h>
+#include <EventMonitor/test/Utilities.h>
+#include <type_traits>
+
+namespace {
+    // Stands in for std::coroutine_handle, counting resumptions, so the awaiters are tested in C++17.
+    struct CountingHandle {
+        void* address() const { return count; }
+        static CountingHandle from_address(void* address) { return { static_cast<int*>(address) }; }
+        void resume() const { ++*count; }
+
+        int* count;
+    };
+}
+
+TEST(DeviceAwaitTest, NextResumesOnMatchingDevice) {
+    DeviceMonitor monitor(std::make_shared<Event>());
+    EXPECT_THROW(monitor.Inject(MakeDevice("/devices/a", { { "ACTION", "add" }, { "SUBSYSTEM", "block" } })), std::runtime_error) << "Nothing to deliver to.";
+
+    int resumed = 0;
+    auto awaiter = monitor.Next([](const Device& device) { return device.GetSubsystemView() == std::string_view("block"); });
+    EXPECT_FALSE(awaiter.await_ready());
+    awaiter.await_suspend(CountingHandle{ &resumed });
+    EXPECT_EQ(monitor.GetWaiterCount(), 1u);
+
+    monitor.Inject(MakeDevice("/devices/a", { { "ACTION", "add" }, { "SUBSYSTEM", "usb" } }));
+    EXPECT_EQ(resumed, 0);
+    monitor.Inject(MakeDevice("/devices/b", { { "ACTION", "add" }, { "SUBSYSTEM", "block" } }));
+    EXPECT_EQ(resumed, 1);
+    EXPECT_EQ(monitor.GetWaiterCount(), 0u);
+
+    auto device = awaiter.await_resume();
+    ASSERT_TRUE(device.has_value());
+    EXPECT_EQ(device->GetSyspath(), "/sys/devices/b");
+}
+
+TEST(DeviceAwaitTest, WaitersAndCallbackAllSeeTheDevice) {
+    DeviceMonitor monitor(std::make_shared<Event>());
+    int callbackCount = 0;
+    monitor.SetCallback([&callbackCount](const DeviceMonitor&, Device) { ++callbackCount; });
+
+    int resumed = 0;
+    auto first = monitor.Next();
+    auto second = monitor.Next();
+    first.await_suspend(CountingHandle{ &resumed });
+    second.await_suspend(CountingHandle{ &resumed });
+
+    monitor.Inject(MakeDevice("/devices/a", { { "ACTION", "add" }, { "SUBSYSTEM", "block" } }));
+    EXPECT_EQ(resumed, 2);
+    EXPECT_EQ(callbackCount, 1);
+    EXPECT_TRUE(first.await_resume().has_value());
+    EXPECT_TRUE(second.await_resume().has_value());
+}
+
+TEST(DeviceAwaitTest, WaitForTimesOut) {
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor(event);
+    EXPECT_THROW(monitor.WaitFor(nullptr, std::chrono::microseconds(0)), std::invalid_argument);
+
+    int resumed = 0;
+    auto awaiter = monitor.WaitFor(nullptr, std::chrono::milliseconds(5));
+    awaiter.await_suspend(CountingHandle{ &resumed });
+    for (int i = 0; i < 100 && !resumed; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 100000), 0);
+    }
+    EXPECT_EQ(resumed, 1);
+    EXPECT_EQ(monitor.GetWaiterCount(), 0u);
+    EXPECT_FALSE(awaiter.await_resume().has_value());
+}
+
+TEST(DeviceAwaitTest, DestroyedWaiterUnlinksAndMonitorCancels) {
+    int resumed = 0;
+    auto monitor = std::make_unique<DeviceMonitor>(std::make_shared<Event>());
+    {
+        auto abandoned = monitor->Next();
+        abandoned.await_suspend(CountingHandle{ &resumed });
+    }
+    EXPECT_EQ(monitor->GetWaiterCount(), 0u);
+
+    auto awaiter = monitor->Next();
+    awaiter.await_suspend(CountingHandle{ &resumed });
+    // A monitor with a pending waiter needs no callback.
+    EXPECT_NO_THROW(monitor->StartMonitoring());
+    monitor.reset();
+    EXPECT_EQ(resumed, 1);
+    EXPECT_FALSE(awaiter.await_resume().has_value());
+}
+
+TEST(DeviceAwaitTest, MonitorIsNeitherCopiedNorMoved) {
+    // Waiters, event sources and dispatch threads hold pointers into the monitor.
+    static_assert(!std::is_move_constructible_v<DeviceMonitor> && !std::is_move_assignable_v<DeviceMonitor>);
+    static_assert(!std::is_copy_constructible_v<DeviceMonitor> && !std::is_copy_assignable_v<DeviceMonitor>);
+}
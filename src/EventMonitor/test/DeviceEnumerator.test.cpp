@@ -1,5 +1,6 @@
 #include <gtest/gtest.h>
 #include <EventMonitor/DeviceEnumerator.h>
+#include <algorithm>
 
 class DeviceEnumeratorTest : public ::testing::Test {
 protected:
@@ -220,4 +221,115 @@ TEST_F(DeviceEnumeratorTest, AddSubsystemFilterAndRemove) {
     enumerator.AddMatchSysname("usb");
     const auto usbDevicesCount2 = enumerator.GetAllDevices().size();
     EXPECT_EQ(usbDevicesCount, usbDevicesCount2) << "Wrong DeviceEnumerator device count after removing and re-adding the filter.";
-}
\ No newline at end of file
+}
+
+TEST_F(DeviceEnumeratorTest, RangeMatchesGetAllDevices) {
+    const DeviceEnumerator enumerator;
+    std::vector<std::string> expected;
+    for (const auto& device : enumerator.GetAllDevices()) {
+        expected.push_back(device.GetSyspath().value_or(""));
+    }
+
+    std::vector<std::string> owned;
+    for (const Device& device : enumerator) {
+        owned.push_back(device.GetSyspath().value_or(""));
+    }
+    std::vector<std::string> borrowed;
+    for (const Device& device : enumerator.Borrowed()) {
+        borrowed.push_back(std::string(device.GetSyspathView().value_or("")));
+    }
+
+    EXPECT_EQ(owned, expected);
+    EXPECT_EQ(borrowed, expected);
+}
+
+TEST_F(DeviceEnumeratorTest, RangeStopsEarly) {
+    const DeviceEnumerator enumerator;
+    const auto first = enumerator.GetDeviceFirst();
+    if (!first) {
+        GTEST_SKIP() << "No device on this system.";
+    }
+
+    auto it = enumerator.begin();
+    ASSERT_NE(it, enumerator.end());
+    EXPECT_EQ(it->GetSyspath(), first->GetSyspath());
+
+    // The range can be restarted after an early break.
+    for (const Device& device : enumerator.Borrowed()) {
+        EXPECT_EQ(device.GetSyspath(), first->GetSyspath());
+        break;
+    }
+}
+
+TEST_F(DeviceEnumeratorTest, RangeOverNoDevice) {
+    DeviceEnumerator enumerator;
+    enumerator.AddMatchSubsystem("eventmonitor-no-such-subsystem", true);
+    EXPECT_EQ(enumerator.begin(), enumerator.end());
+}
+
+TEST_F(DeviceEnumeratorTest, ParallelMatchesGetAllDevices) {
+    const DeviceEnumerator enumerator;
+    std::vector<std::string> expected;
+    for (const auto& device : enumerator.GetAllDevices()) {
+        expected.push_back(device.GetSyspath().value_or(""));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> parallel;
+    for (const auto& device : enumerator.GetAllDevicesParallel(4, allDeviceFields)) {
+        parallel.push_back(device.GetSyspath().value_or(""));
+    }
+
+    EXPECT_EQ(parallel, expected);
+}
+
+TEST_F(DeviceEnumeratorTest, ParallelReplaysFilters) {
+    DeviceEnumerator enumerator;
+    enumerator.AddMatchSubsystem("pci", true);
+    enumerator.AddMatchSubsystem("net", true);
+    enumerator.AddNomatchSysname("lo");
+
+    std::vector<std::string> expected;
+    for (const auto& device : enumerator.GetAllDevices()) {
+        expected.push_back(device.GetSyspath().value_or(""));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<std::string> parallel;
+    for (const auto& device : enumerator.GetAllDevicesParallel(2)) {
+        const auto subsystem = device.GetSubsystemView();
+        EXPECT_TRUE(subsystem == std::string_view("pci") || subsystem == std::string_view("net"));
+        EXPECT_NE(device.GetSysnameView(), std::string_view("lo"));
+        parallel.push_back(device.GetSyspath().value_or(""));
+    }
+
+    EXPECT_EQ(parallel, expected);
+}
+
+TEST_F(DeviceEnumeratorTest, AddMatchParentOnlyYieldsTheSubtree) {
+    std::optional<Device> parent;
+    for (const Device& device : DeviceEnumerator()) {
+        if (auto candidate = device.GetParent()) {
+            parent.emplace(std::move(*candidate));
+            break;
+        }
+    }
+    if (!parent) {
+        GTEST_SKIP() << "No device with a parent.";
+    }
+
+    DeviceEnumerator enumerator;
+    enumerator.AddMatchParent(*parent);
+    const std::string prefix = *parent->GetSyspath();
+    const auto devices = enumerator.GetAllDevices();
+    EXPECT_FALSE(devices.empty());
+    for (const Device& device : devices) {
+        const std::string syspath = *device.GetSyspath();
+        EXPECT_TRUE(syspath == prefix || syspath.rfind(prefix + "/", 0) == 0) << syspath;
+    }
+    EXPECT_EQ(enumerator.GetAllDevicesParallel(2).size(), devices.size());
+
+    const Device detached = Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{ { "DEVPATH", "/devices/detached" } }));
+    EXPECT_THROW(enumerator.AddMatchParent(detached), std::invalid_argument);
+    EXPECT_FALSE(detached.GetParent().has_value());
+}
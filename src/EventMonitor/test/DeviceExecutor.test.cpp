@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceExecutor.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+TEST(DeviceExecutorTest, InvalidArguments) {
+    EXPECT_THROW(DeviceExecutor(nullptr), std::invalid_argument);
+    EXPECT_THROW(DeviceExecutor([](Device) {}, 1, nullptr, 0), std::invalid_argument);
+}
+
+TEST(DeviceExecutorTest, HandlesEveryDevice) {
+    auto devices = DeviceEnumerator().GetAllDevices();
+    const auto deviceCount = devices.size();
+
+    std::atomic<std::size_t> handled(0);
+    DeviceExecutor executor([&handled](Device) { ++handled; }, 4);
+    for (auto& device : devices) {
+        executor.Submit(std::move(device));
+    }
+    executor.Wait();
+
+    EXPECT_EQ(handled.load(), deviceCount);
+    const auto stats = executor.GetStats();
+    EXPECT_EQ(stats.queuedDevices, 0u);
+    EXPECT_EQ(stats.activeShards, 0u);
+    EXPECT_EQ(stats.workers.size(), 4u);
+}
+
+TEST(DeviceExecutorTest, SameKeyKeepsSubmissionOrder) {
+    auto devices = DeviceEnumerator().GetAllDevices();
+    if (devices.empty()) {
+        GTEST_SKIP() << "No device to dispatch on this system.";
+    }
+
+    std::vector<std::string> expected;
+    for (const auto& device : devices) {
+        expected.push_back(device.GetSyspath().value_or(""));
+    }
+
+    // A single key puts every device on the same serial queue.
+    std::mutex mutex;
+    std::vector<std::string> handledOrder;
+    DeviceExecutor executor([&](Device device) {
+        std::lock_guard<std::mutex> lock(mutex);
+        handledOrder.push_back(device.GetSyspath().value_or(""));
+    }, 4, [](const Device&) { return std::size_t(0); });
+
+    for (auto& device : devices) {
+        executor.Submit(std::move(device));
+    }
+    executor.Wait();
+
+    EXPECT_EQ(handledOrder, expected);
+}
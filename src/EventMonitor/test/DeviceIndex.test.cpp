@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceIndex.h>
+#include <algorithm>
+
+namespace {
+    std::vector<std::string> Syspaths(const DeviceIndex::Result& result) {
+        std::vector<std::string> syspaths;
+        for (const auto& snapshot : result) {
+            syspaths.emplace_back(*snapshot->GetSyspath());
+        }
+        std::sort(syspaths.begin(), syspaths.end());
+        return syspaths;
+    }
+
+    template <typename Predicate>
+    std::vector<std::string> Scan(const std::vector<Device>& devices, Predicate&& predicate) {
+        std::vector<std::string> syspaths;
+        for (const auto& device : devices) {
+            if (predicate(device)) {
+                syspaths.push_back(*device.GetSyspath());
+            }
+        }
+        std::sort(syspaths.begin(), syspaths.end());
+        return syspaths;
+    }
+}
+
+TEST(DeviceIndexTest, QueriesMatchLinearScan) {
+    const DeviceEnumerator enumerator;
+    const auto devices = enumerator.GetAllDevices();
+    DeviceIndex index;
+    index.Build(enumerator);
+    ASSERT_EQ(index.GetSize(), devices.size());
+
+    EXPECT_EQ(Syspaths(index.Find(DeviceQuery{})).size(), devices.size());
+
+    DeviceQuery pci;
+    pci.subsystem = "pci";
+    EXPECT_EQ(Syspaths(index.Find(pci)), Scan(devices, [](const Device& device) {
+        return device.GetSubsystemView() == std::string_view("pci");
+    }));
+
+    for (const auto& device : devices) {
+        const auto driver = device.GetDriver();
+        const auto subsystem = device.GetSubsystem();
+        if (!driver || !subsystem) {
+            continue;
+        }
+        DeviceQuery composite;
+        composite.subsystem = subsystem;
+        composite.driver = driver;
+        EXPECT_EQ(Syspaths(index.Find(composite)), Scan(devices, [&](const Device& other) {
+            return other.GetSubsystem() == subsystem && other.GetDriver() == driver;
+        }));
+        break;
+    }
+
+    for (const auto& device : devices) {
+        const auto devnum = device.GetDevnum();
+        if (!devnum) {
+            continue;
+        }
+        DeviceQuery byDevnum;
+        byDevnum.devnum = devnum;
+        byDevnum.subsystem = device.GetSubsystem();
+        const auto result = index.Find(byDevnum);
+        ASSERT_EQ(result.size(), 1u);
+        EXPECT_EQ(result.front()->GetSyspath(), device.GetSyspathView());
+        break;
+    }
+
+    DeviceQuery none;
+    none.subsystem = "pci";
+    none.tags.push_back("eventmonitor-no-such-tag");
+    EXPECT_TRUE(index.Find(none).empty());
+}
+
+TEST(DeviceIndexTest, InsertAndErase) {
+    const auto device = DeviceEnumerator().GetDeviceFirst();
+    if (!device) {
+        GTEST_SKIP() << "No device on this system.";
+    }
+
+    DeviceIndex index;
+    index.Insert(*device);
+    index.Insert(*device);
+    EXPECT_EQ(index.GetSize(), 1u);
+
+    DeviceQuery query;
+    query.subsystem = device->GetSubsystem();
+    EXPECT_EQ(index.Find(query).size(), 1u);
+
+    EXPECT_TRUE(index.Erase(*device->GetSyspath()));
+    EXPECT_FALSE(index.Erase(*device->GetSyspath()));
+    EXPECT_EQ(index.GetSize(), 0u);
+    EXPECT_TRUE(index.Find(query).empty());
+}
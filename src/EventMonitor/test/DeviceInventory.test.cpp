@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceInventory.h>
+#include <EventMonitor/test/Utilities.h>
+#include <filesystem>
+#include <fstream>
+
+TEST(DeviceInventoryTest, FindsWrittenDevicesInPlace) {
+    const std::string path = TemporaryPath("inventory-find");
+    DeviceEnumerator enumerator;
+    const std::vector<Device> devices = enumerator.GetAllDevices();
+    DeviceInventory::Write(path, devices, DeviceInventory::ReadUeventSeqnum());
+
+    const DeviceInventory inventory(path);
+    ASSERT_EQ(inventory.GetSize(), devices.size());
+    for (const Device& device : devices) {
+        const auto entry = inventory.Find(*device.GetSyspath());
+        ASSERT_TRUE(entry.has_value()) << *device.GetSyspath();
+        EXPECT_EQ(entry->GetSyspath(), *device.GetSyspath());
+        EXPECT_EQ(entry->GetDevnum(), device.GetDevnum());
+        EXPECT_EQ(entry->GetUsecInitialized(), device.GetUsecInitialized().value_or(0));
+        EXPECT_EQ(entry->GetProperty("SUBSYSTEM"), device.GetSubsystemView());
+
+        const Device loaded = entry->ToDevice();
+        EXPECT_TRUE(loaded.IsDetached());
+        EXPECT_EQ(loaded.GetSyspath(), device.GetSyspath());
+        EXPECT_EQ(loaded.GetAllProperties().GetSize(), device.GetAllProperties().GetSize());
+    }
+    EXPECT_FALSE(inventory.Find("/sys/devices/not-a-device").has_value());
+    EXPECT_TRUE(inventory.IsSameBoot());
+    std::filesystem::remove(path);
+}
+
+TEST(DeviceInventoryTest, CurrentInventoryIsLoadedWithoutQuerying) {
+    const std::string path = TemporaryPath("inventory-current");
+    DeviceEnumerator enumerator;
+    DeviceInventory::Write(path, enumerator);
+
+    const DeviceInventory inventory(path);
+    if (!inventory.IsCurrent()) {
+        GTEST_SKIP() << "A uevent was emitted while the test ran.";
+    }
+    DeviceInventory::LoadStats stats;
+    const std::vector<Device> devices = inventory.Load(enumerator, &stats);
+    EXPECT_EQ(devices.size(), inventory.GetSize());
+    EXPECT_EQ(stats.reused, inventory.GetSize());
+    EXPECT_EQ(stats.requeried, 0u);
+    EXPECT_EQ(stats.removed, 0u);
+    std::filesystem::remove(path);
+}
+
+TEST(DeviceInventoryTest, FilteredEnumeratorOnlyLoadsItsDevices) {
+    const std::string path = TemporaryPath("inventory-filtered");
+    DeviceEnumerator enumerator;
+    DeviceInventory::Write(path, enumerator);
+    const DeviceInventory inventory(path);
+
+    std::optional<std::string> subsystem;
+    for (std::size_t i = 0; i < inventory.GetSize() && !subsystem; ++i) {
+        if (const auto value = inventory[i].GetProperty("SUBSYSTEM")) {
+            subsystem = std::string(*value);
+        }
+    }
+    if (!subsystem) {
+        GTEST_SKIP() << "No device with a subsystem.";
+    }
+
+    DeviceEnumerator filtered;
+    filtered.AddMatchSubsystem(*subsystem, true);
+    EXPECT_TRUE(filtered.HasFilters());
+    DeviceInventory::LoadStats stats;
+    const std::vector<Device> devices = inventory.Load(filtered, &stats);
+    ASSERT_FALSE(devices.empty());
+    EXPECT_LT(devices.size(), inventory.GetSize());
+    for (const Device& device : devices) {
+        EXPECT_EQ(device.GetSubsystemView(), std::string_view(*subsystem)) << *device.GetSyspath();
+    }
+    EXPECT_EQ(stats.reused + stats.requeried, devices.size());
+    EXPECT_EQ(stats.removed, 0u);
+
+    filtered.Reset();
+    EXPECT_FALSE(filtered.HasFilters());
+    std::filesystem::remove(path);
+}
+
+TEST(DeviceInventoryTest, StaleInventoryOnlyRequeriesChangedDevices) {
+    const std::string path = TemporaryPath("inventory-stale");
+    DeviceEnumerator enumerator;
+    std::vector<Device> devices = enumerator.GetAllDevices();
+    const std::size_t present = devices.size();
+    devices.push_back(Device::CreateFromProperties(DeviceProperties({ { "DEVPATH", "/devices/gone" }, { "SUBSYSTEM", "test" } })));
+    // An older seqnum makes the inventory look stale, so every device goes through the per-device check.
+    DeviceInventory::Write(path, devices, DeviceInventory::ReadUeventSeqnum() - 1);
+
+    const DeviceInventory inventory(path);
+    EXPECT_FALSE(inventory.IsCurrent());
+    const auto gone = inventory.Find("/sys/devices/gone");
+    ASSERT_TRUE(gone.has_value());
+    EXPECT_FALSE(inventory.IsUnchanged(*gone));
+
+    DeviceInventory::LoadStats stats;
+    const std::vector<Device> loaded = inventory.Load(enumerator, &stats);
+    EXPECT_EQ(loaded.size(), stats.reused + stats.requeried);
+    EXPECT_GE(stats.removed, 1u);
+    EXPECT_GT(stats.reused, 0u);
+    EXPECT_GE(loaded.size() + 1, present) << "Devices may come and go, not all at once.";
+    std::filesystem::remove(path);
+}
+
+TEST(DeviceInventoryTest, RejectsIncompatibleFiles) {
+    const std::string path = TemporaryPath("inventory-invalid");
+    EXPECT_THROW(DeviceInventory("/nonexistent/inventory"), std::runtime_error);
+
+    {
+        std::ofstream file(path, std::ios::binary);
+        file << "not an inventory, just some text long enough to cover a header";
+    }
+    EXPECT_THROW(DeviceInventory inventory(path), std::runtime_error);
+
+    // A valid header announcing records the file does not hold.
+    DeviceInventory::Write(path, {}, 0);
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        const uint32_t recordCount = 10;
+        file.seekp(offsetof(InventoryFile::Header, recordCount));
+        file.write(reinterpret_cast<const char*>(&recordCount), sizeof(recordCount));
+    }
+    EXPECT_THROW(DeviceInventory inventory(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
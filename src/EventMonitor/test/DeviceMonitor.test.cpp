@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 #include <EventMonitor/DeviceMonitor.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/test/Utilities.h>
+#include <atomic>
+#include <thread>
 
 class DeviceMonitorTest : public ::testing::Test {
 protected:
@@ -64,4 +68,315 @@ TEST_F(DeviceMonitorTest, SharedOwnershipBetweenDeviceMonitorsOfEvent_CheckEvent
     EXPECT_EQ(event.use_count(), 0) << "After resetting the last reference, count should be 0.";
 }
 
-// TODO : Should not be able to start event loop without having attached it to a device monitor.
\ No newline at end of file
+// TODO : Should not be able to start event loop without having attached it to a device monitor.
+
+TEST_F(DeviceMonitorTest, SetBatchCallback_InvalidArguments) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    const auto callback = [](const DeviceMonitor&, std::vector<Device>) {};
+
+    EXPECT_THROW(monitor.SetBatchCallback(nullptr, 16, std::chrono::milliseconds(10)), std::invalid_argument);
+    EXPECT_THROW(monitor.SetBatchCallback(callback, 0, std::chrono::milliseconds(10)), std::invalid_argument);
+    EXPECT_THROW(monitor.SetBatchCallback(callback, 16, std::chrono::milliseconds(-1)), std::invalid_argument);
+    EXPECT_NO_THROW(monitor.SetBatchCallback(callback, 16, std::chrono::milliseconds(0)));
+}
+
+TEST_F(DeviceMonitorTest, StartAndStopMonitoring_WithBatchCallback) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    EXPECT_THROW(monitor.StartMonitoring(), std::runtime_error) << "Monitoring should not start without any callback.";
+
+    monitor.SetBatchCallback([](const DeviceMonitor&, std::vector<Device>) {}, 16, std::chrono::milliseconds(10));
+    monitor.StartMonitoring();
+    EXPECT_TRUE(monitor.IsMonitoringForEvents());
+
+    // Nothing was received, flushing an empty batch should be a no-op.
+    EXPECT_NO_THROW(monitor.FlushBatch());
+
+    monitor.StopMonitoring();
+    EXPECT_FALSE(monitor.IsMonitoringForEvents());
+}
+
+TEST_F(DeviceMonitorTest, BatchCallbackGroupsBySizeAndFlushesOnTimer) {
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor = DeviceMonitor(event);
+    std::vector<std::vector<std::string>> batches;
+    monitor.SetBatchCallback([&batches](const DeviceMonitor&, std::vector<Device> devices) {
+        std::vector<std::string> syspaths;
+        for (const Device& device : devices) {
+            syspaths.push_back(*device.GetSyspath());
+        }
+        batches.push_back(std::move(syspaths));
+    }, 3, std::chrono::milliseconds(20));
+
+    for (const char* devpath : { "/devices/a", "/devices/b", "/devices/c", "/devices/d" }) {
+        monitor.Inject(MakeDevice(devpath, { { "ACTION", "add" } }));
+    }
+    ASSERT_EQ(batches.size(), 1u) << "A full batch is handed over at once.";
+    EXPECT_EQ(batches[0], (std::vector<std::string>{ "/sys/devices/a", "/sys/devices/b", "/sys/devices/c" }));
+
+    // The remainder waits for the delay.
+    for (int i = 0; i < 100 && batches.size() < 2; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    ASSERT_EQ(batches.size(), 2u);
+    EXPECT_EQ(batches[1], (std::vector<std::string>{ "/sys/devices/d" }));
+}
+
+TEST_F(DeviceMonitorTest, EnableQueuedDispatch) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    EXPECT_THROW(monitor.EnableQueuedDispatch(64), std::runtime_error) << "Queued dispatch needs a callback to run.";
+
+    monitor.SetCallback([](const DeviceMonitor&, Device) {});
+    monitor.EnableQueuedDispatch(64, 2);
+    EXPECT_TRUE(monitor.IsQueuedDispatchEnabled());
+    EXPECT_EQ(monitor.GetQueueDepth(), 0u);
+    // The consumers captured the callback.
+    EXPECT_THROW(monitor.SetCallback([](const DeviceMonitor&, Device) {}), std::runtime_error);
+    EXPECT_THROW(monitor.SetBatchCallback([](const DeviceMonitor&, std::vector<Device>) {}, 16, std::chrono::milliseconds(10)),
+                 std::runtime_error);
+
+    monitor.StartMonitoring();
+    monitor.StopMonitoring();
+
+    monitor.DisableQueuedDispatch();
+    EXPECT_FALSE(monitor.IsQueuedDispatchEnabled());
+    EXPECT_EQ(monitor.GetDroppedCount(), 0u);
+}
+
+TEST_F(DeviceMonitorTest, QueuedDispatchDeliversOnConsumerAndDropsOnOverflow) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    std::atomic<bool> started(false);
+    std::atomic<bool> released(false);
+    std::vector<std::string> handled;
+    std::thread::id consumer;
+    monitor.SetCallback([&](const DeviceMonitor&, Device device) {
+        consumer = std::this_thread::get_id();
+        started = true;
+        while (!released) {
+            std::this_thread::yield();
+        }
+        handled.push_back(*device.GetSyspath());
+    });
+    monitor.EnableQueuedDispatch(2, 1);
+
+    // The consumer holds the first device, the queue then fills up and drops the newest.
+    monitor.Inject(MakeDevice("/devices/first", { { "ACTION", "add" } }));
+    while (!started) {
+        std::this_thread::yield();
+    }
+    for (const char* devpath : { "/devices/a", "/devices/b", "/devices/c" }) {
+        monitor.Inject(MakeDevice(devpath, { { "ACTION", "add" } }));
+    }
+    EXPECT_EQ(monitor.GetQueueDepth(), 2u);
+    EXPECT_EQ(monitor.GetDroppedCount(), 1u);
+
+    released = true;
+    monitor.DisableQueuedDispatch();
+    EXPECT_EQ(handled, (std::vector<std::string>{ "/sys/devices/first", "/sys/devices/a", "/sys/devices/b" }));
+    EXPECT_NE(consumer, std::this_thread::get_id()) << "The callback runs on the consumer thread.";
+}
+
+TEST_F(DeviceMonitorTest, QueuedDispatchStagingIsBounded) {
+    auto devices = DeviceEnumerator().GetAllDevices();
+    if (devices.size() <= 64) {
+        GTEST_SKIP() << "Not enough devices to fill the staging area on this system.";
+    }
+    const auto deviceCount = devices.size();
+
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor = DeviceMonitor(event);
+    std::atomic<std::size_t> handled(0);
+    monitor.SetCallback([&handled](const DeviceMonitor&, Device) { ++handled; });
+    monitor.EnableQueuedDispatch(deviceCount);
+
+    // Enumerated devices are staged until the loop runs, past the staging capacity the oldest are handed over.
+    for (auto& device : devices) {
+        monitor.Inject(std::move(device));
+    }
+    devices.clear();
+    for (int i = 0; i < 500 && handled < 64; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_GE(handled.load(), 64u) << "Staged devices are handed over without waiting for the loop.";
+
+    ASSERT_GE(sd_event_run(event->GetEvent(), 0), 0);
+    monitor.DisableQueuedDispatch();
+    EXPECT_EQ(handled.load(), deviceCount);
+    EXPECT_EQ(monitor.GetDroppedCount(), 0u);
+}
+
+TEST_F(DeviceMonitorTest, EnableExecutorDispatch) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    EXPECT_THROW(monitor.EnableExecutorDispatch(2), std::runtime_error) << "Executor dispatch needs a callback to run.";
+    EXPECT_THROW(monitor.GetExecutorStats(), std::runtime_error);
+
+    monitor.SetCallback([](const DeviceMonitor&, Device) {});
+    monitor.EnableQueuedDispatch(64);
+    monitor.EnableExecutorDispatch(2);
+    EXPECT_TRUE(monitor.IsExecutorDispatchEnabled());
+    EXPECT_FALSE(monitor.IsQueuedDispatchEnabled()) << "Executor dispatch should replace queued dispatch.";
+    EXPECT_EQ(monitor.GetExecutorStats().workers.size(), 2u);
+    EXPECT_THROW(monitor.SetCallback([](const DeviceMonitor&, Device) {}), std::runtime_error);
+
+    monitor.DisableExecutorDispatch();
+    EXPECT_FALSE(monitor.IsExecutorDispatchEnabled());
+}
+
+TEST_F(DeviceMonitorTest, AddFiltersBeforeAndWhileMonitoring) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    monitor.SetCallback([](const DeviceMonitor&, Device) {});
+
+    EXPECT_NO_THROW(monitor.AddMatchSubsystemDevtype("usb", "usb_device"));
+    EXPECT_NO_THROW(monitor.AddMatchTag("seat"));
+    EXPECT_NO_THROW(monitor.AddMatchSysattr("removable", "removable", true));
+    EXPECT_NO_THROW(monitor.AddMatchProperty("ID_VENDOR_ID", "04*"));
+    EXPECT_THROW(monitor.AddMatchProperty("", "value"), std::invalid_argument);
+
+    monitor.StartMonitoring();
+    // Matches added while monitoring recompile the socket filter.
+    EXPECT_NO_THROW(monitor.AddMatchSubsystemDevtype("block"));
+    EXPECT_NO_THROW(monitor.ResetFilters());
+    monitor.StopMonitoring();
+}
+
+TEST_F(DeviceMonitorTest, AddMatchParent) {
+    const auto parent = DeviceEnumerator().GetDeviceFirst();
+    if (!parent) {
+        GTEST_SKIP() << "No device to use as parent on this system.";
+    }
+
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    EXPECT_NO_THROW(monitor.AddMatchParent(*parent, true));
+    EXPECT_NO_THROW(monitor.AddMatchParent(*parent, false));
+}
+
+TEST_F(DeviceMonitorTest, ReceiveBufferSizeAndOverflowDetection) {
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor = DeviceMonitor(event);
+    EXPECT_THROW(monitor.SetReceiveBufferSize(0), std::invalid_argument);
+    EXPECT_NO_THROW(monitor.SetReceiveBufferSize(1 << 20));
+    EXPECT_THROW(monitor.EnableOverflowDetection(std::chrono::microseconds(0)), std::invalid_argument);
+    EXPECT_THROW(monitor.GetQueueStats(), std::runtime_error);
+
+    std::atomic<bool> released(false);
+    monitor.SetCallback([&released](const DeviceMonitor&, Device) {
+        while (!released) {
+            std::this_thread::yield();
+        }
+    });
+    monitor.EnableQueuedDispatch(2, 1, {}, DeviceMonitor::OverflowPolicy::DropNewest);
+
+    int resyncs = 0;
+    monitor.SetResyncCallback([&resyncs](const DeviceMonitor&, DeviceEnumerator& enumerator) {
+        enumerator.AddMatchSubsystem("block", true);
+        ++resyncs;
+    });
+    monitor.EnableOverflowDetection(std::chrono::milliseconds(1));
+    EXPECT_TRUE(monitor.IsOverflowDetectionEnabled());
+
+    // A stalled consumer and 2 slots, most injected devices are dropped.
+    for (int i = 0; i < 8; ++i) {
+        monitor.Inject(Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{
+            { "DEVPATH", "/devices/test" },
+        })));
+    }
+    for (int i = 0; i < 100 && resyncs == 0; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    released = true;
+
+    const auto stats = monitor.GetOverflowStats();
+    EXPECT_EQ(resyncs, 1);
+    EXPECT_EQ(stats.resyncCount, 1u);
+    EXPECT_GE(stats.overflowCount, 1u);
+    EXPECT_GE(stats.queueDrops, 5u);
+    EXPECT_EQ(stats.queueDrops, monitor.GetQueueStats().droppedNewest);
+
+    monitor.DisableOverflowDetection();
+    EXPECT_FALSE(monitor.IsOverflowDetectionEnabled());
+}
+
+TEST_F(DeviceMonitorTest, CoalescingCollapsesEventsPerDevice) {
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor = DeviceMonitor(event);
+    EXPECT_THROW(monitor.EnableCoalescing(std::chrono::microseconds(0)), std::invalid_argument);
+
+    std::vector<std::string> received;
+    monitor.SetCallback([&received](const DeviceMonitor&, Device device) {
+        static constexpr const char* actions[] = { "add", "remove", "change", "move" };
+        const std::string_view action = actions[*device.GetAction()];
+        received.push_back(std::string(action) + " " + *device.GetSyspath() + " " +
+                           std::string(device.GetPropertyView("STATE").value_or("")));
+
+        // Every view of the properties agrees with GetAction(), e.g. a coalesced add whose last event was a change.
+        EXPECT_EQ(device.GetPropertyView("ACTION"), action);
+        EXPECT_EQ(device.GetPropertyFromKey("ACTION"), std::string(action));
+        EXPECT_EQ(device.GetAllProperties().Find("ACTION"), action);
+        device.ForEachProperty([&action](std::string_view key, std::string_view value) {
+            if (key == "ACTION") {
+                EXPECT_EQ(value, action);
+            }
+        });
+    });
+    monitor.EnableCoalescing(std::chrono::milliseconds(20));
+    EXPECT_TRUE(monitor.IsCoalescingEnabled());
+
+    // Flapping : came and went.
+    monitor.Inject(MakeDevice("/devices/flap", { { "ACTION", "add" } }));
+    monitor.Inject(MakeDevice("/devices/flap", { { "ACTION", "change" } }));
+    monitor.Inject(MakeDevice("/devices/flap", { { "ACTION", "remove" } }));
+    // New device settling.
+    monitor.Inject(MakeDevice("/devices/new", { { "ACTION", "add" }, { "STATE", "1" } }));
+    monitor.Inject(MakeDevice("/devices/new", { { "ACTION", "change" }, { "STATE", "2" } }));
+    // Existing device changing repeatedly.
+    monitor.Inject(MakeDevice("/devices/old", { { "ACTION", "change" }, { "STATE", "1" } }));
+    monitor.Inject(MakeDevice("/devices/old", { { "ACTION", "change" }, { "STATE", "2" } }));
+    monitor.Inject(MakeDevice("/devices/old", { { "ACTION", "change" }, { "STATE", "3" } }));
+    EXPECT_TRUE(received.empty()) << "Events are held for the window.";
+
+    for (int i = 0; i < 100 && received.size() < 2; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    EXPECT_EQ(received, (std::vector<std::string>{ "add /sys/devices/new 2", "change /sys/devices/old 3" }));
+
+    const auto stats = monitor.GetCoalesceStats();
+    EXPECT_EQ(stats.suppressed, 3u);
+    EXPECT_EQ(stats.merged, 3u);
+    EXPECT_EQ(stats.emitted, 2u);
+}
+
+TEST_F(DeviceMonitorTest, CoalescingHandsOverMovesAndFlushes) {
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    std::vector<std::string> received;
+    monitor.SetCallback([&received](const DeviceMonitor&, Device device) { received.push_back(*device.GetSyspath()); });
+    monitor.EnableCoalescing(std::chrono::seconds(10));
+
+    monitor.Inject(MakeDevice("/devices/a", { { "ACTION", "change" } }));
+    monitor.Inject(MakeDevice("/devices/b", { { "ACTION", "change" } }));
+    auto move = std::vector<DeviceProperties::Property>{ { "ACTION", "move" }, { "DEVPATH", "/devices/c" }, { "DEVPATH_OLD", "/devices/a" } };
+    monitor.Inject(Device::CreateFromProperties(DeviceProperties(std::move(move))));
+    EXPECT_EQ(received, (std::vector<std::string>{ "/sys/devices/a", "/sys/devices/c" }));
+
+    monitor.DisableCoalescing();
+    EXPECT_FALSE(monitor.IsCoalescingEnabled());
+    EXPECT_EQ(received, (std::vector<std::string>{ "/sys/devices/a", "/sys/devices/c", "/sys/devices/b" }));
+}
+
+TEST_F(DeviceMonitorTest, MetricsCountEveryStage) {
+    auto registry = std::make_shared<MetricsRegistry>();
+    const MetricsRegistry::Labels labels{ { "monitor", "test" } };
+    DeviceMonitor monitor = DeviceMonitor(std::make_shared<Event>());
+    monitor.SetMetrics(registry, labels);
+    monitor.SetCallback([](const DeviceMonitor&, Device) {});
+
+    for (int i = 0; i < 3; ++i) {
+        monitor.Inject(MakeDevice("/devices/test", { { "ACTION", "change" } }));
+    }
+
+    EXPECT_EQ(registry->GetValue(registry->AddCounter("eventmonitor_events_received_total", "", labels)), 3u);
+    EXPECT_EQ(registry->GetValue(registry->AddCounter("eventmonitor_events_dispatched_total", "", labels)), 3u);
+    EXPECT_EQ(registry->AddSummary("eventmonitor_callback_duration_seconds", "", labels).GetCount(), 3u);
+
+    monitor.SetMetrics(nullptr);
+    monitor.Inject(MakeDevice("/devices/test", { { "ACTION", "change" } }));
+    EXPECT_EQ(registry->GetValue(registry->AddCounter("eventmonitor_events_received_total", "", labels)), 3u);
+}
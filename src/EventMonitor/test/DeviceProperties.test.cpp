@@ -0,0 +1,31 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceProperties.h>
+#include <string>
+
+TEST(DevicePropertiesTest, SortsAndFinds) {
+    std::string key = "SUBSYSTEM";
+    std::string value = "usb";
+    DeviceProperties properties({ { key, value }, { "DEVTYPE", "usb_device" }, { "EMPTY", "" } });
+
+    // The properties own their characters.
+    key.assign("XXXXXXXXX");
+    value.assign("XXX");
+
+    ASSERT_EQ(properties.GetSize(), 3u);
+    EXPECT_EQ(properties[0].first, "DEVTYPE");
+    EXPECT_EQ(properties[1].first, "EMPTY");
+    EXPECT_EQ(properties[2].first, "SUBSYSTEM");
+    EXPECT_EQ(properties.Find("SUBSYSTEM"), "usb");
+    EXPECT_EQ(properties.Find("EMPTY"), "");
+    EXPECT_EQ(properties.Find("DEVNAME"), std::nullopt);
+}
+
+TEST(DevicePropertiesTest, CopyIsIndependent) {
+    auto properties = std::make_unique<DeviceProperties>(std::vector<DeviceProperties::Property>{ { "ACTION", "add" } });
+    const DeviceProperties copy(*properties);
+    properties.reset();
+
+    EXPECT_EQ(copy.Find("ACTION"), "add");
+    EXPECT_FALSE(copy.IsEmpty());
+    EXPECT_TRUE(DeviceProperties().IsEmpty());
+}
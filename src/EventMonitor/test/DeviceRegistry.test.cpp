@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceRegistry.h>
+#include <EventMonitor/DeviceMonitor.h>
+
+TEST(DeviceRegistryTest, SeedMatchesEnumeration) {
+    const DeviceEnumerator enumerator;
+    DeviceRegistry registry;
+    registry.Seed(enumerator);
+
+    const auto devices = enumerator.GetAllDevices();
+    EXPECT_EQ(registry.GetSize(), devices.size());
+    for (const auto& device : devices) {
+        const auto entry = registry.Find(*device.GetSyspath());
+        ASSERT_TRUE(entry.has_value()) << *device.GetSyspath();
+        EXPECT_EQ(entry->snapshot->GetSubsystem(), device.GetSubsystemView());
+    }
+    EXPECT_FALSE(registry.Contains("/sys/devices/eventmonitor-no-such-device"));
+}
+
+TEST(DeviceRegistryTest, ApplyUpdatesGenerations) {
+    const auto device = DeviceEnumerator().GetDeviceFirst();
+    if (!device) {
+        GTEST_SKIP() << "No device on this system.";
+    }
+    const std::string syspath = *device->GetSyspath();
+
+    DeviceRegistry registry;
+    EXPECT_EQ(registry.GetGeneration(), 0u);
+    registry.Apply(SD_DEVICE_ADD, *device);
+    const auto added = registry.Find(syspath);
+    ASSERT_TRUE(added.has_value());
+    EXPECT_TRUE(registry.IsCurrent(syspath, added->generation));
+
+    registry.Apply(SD_DEVICE_CHANGE, *device);
+    const auto changed = registry.Find(syspath);
+    ASSERT_TRUE(changed.has_value());
+    EXPECT_GT(changed->generation, added->generation);
+    EXPECT_FALSE(registry.IsCurrent(syspath, added->generation));
+    EXPECT_EQ(registry.GetSize(), 1u);
+
+    registry.Apply(SD_DEVICE_REMOVE, *device);
+    EXPECT_FALSE(registry.Contains(syspath));
+    EXPECT_FALSE(registry.IsCurrent(syspath, changed->generation));
+    EXPECT_EQ(registry.GetSize(), 0u);
+    EXPECT_GT(registry.GetGeneration(), changed->generation);
+}
+
+TEST(DeviceRegistryTest, SeedFromLoopOfStartedMonitor) {
+    auto event = std::make_shared<Event>(Event::LoopType::New);
+    DeviceMonitor monitor(event);
+    DeviceRegistry registry;
+    monitor.SetCallback([&registry](const DeviceMonitor&, Device device) { registry.Apply(device); });
+
+    // Started first, the monitor keeps the events raised during the enumeration in its socket.
+    monitor.StartMonitoring();
+    event->RunInBackground();
+    // Seeded on the loop thread, those events are dispatched after the seed and applied on top of it.
+    const DeviceEnumerator enumerator;
+    event->Invoke([&registry, &enumerator]() { registry.Seed(enumerator); });
+    const uint64_t seeded = registry.GetGeneration();
+
+    const std::string syspath = "/sys/devices/eventmonitor-registry";
+    event->Invoke([&monitor]() {
+        monitor.Inject(Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{
+            { "ACTION", "add" }, { "DEVPATH", "/devices/eventmonitor-registry" }, { "SUBSYSTEM", "test" },
+        })));
+    });
+    EXPECT_TRUE(registry.Contains(syspath)) << "Events after the seed update it.";
+    EXPECT_GT(registry.GetGeneration(), seeded);
+
+    event->Invoke([&monitor]() {
+        monitor.Inject(Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{
+            { "ACTION", "remove" }, { "DEVPATH", "/devices/eventmonitor-registry" }, { "SUBSYSTEM", "test" },
+        })));
+    });
+    EXPECT_FALSE(registry.Contains(syspath));
+    event->Stop();
+}
@@ -0,0 +1,60 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceSet.h>
+#include <EventMonitor/test/Utilities.h>
+#include <filesystem>
+#include <unistd.h>
+
+TEST(DeviceSetTest, DiffsAddedRemovedAndChangedDevices) {
+    std::vector<Device> before;
+    before.push_back(MakeDevice("/devices/kept", { { "SUBSYSTEM", "usb" }, { "DRIVER", "usb" } }));
+    before.push_back(MakeDevice("/devices/removed", { { "SUBSYSTEM", "usb" } }));
+    before.push_back(MakeDevice("/devices/changed", { { "SUBSYSTEM", "usb" }, { "DRIVER", "usb" }, { "ID_GONE", "1" } }));
+
+    std::vector<Device> after;
+    after.push_back(MakeDevice("/devices/added", { { "SUBSYSTEM", "block" } }));
+    after.push_back(MakeDevice("/devices/changed", { { "SUBSYSTEM", "usb" }, { "DRIVER", "usbhid" }, { "ID_NEW", "1" } }));
+    // Event properties are not part of the device state.
+    after.push_back(MakeDevice("/devices/kept", { { "DRIVER", "usb" }, { "SUBSYSTEM", "usb" }, { "ACTION", "change" }, { "SEQNUM", "42" } }));
+
+    const DeviceSet older(before);
+    const DeviceSet newer(after);
+    EXPECT_EQ(older.GetSize(), 3u);
+
+    const DeviceDiff diff = older.Diff(newer);
+    EXPECT_EQ(diff.added, std::vector<std::string>{ "/sys/devices/added" });
+    EXPECT_EQ(diff.removed, std::vector<std::string>{ "/sys/devices/removed" });
+    ASSERT_EQ(diff.changed.size(), 1u);
+    EXPECT_EQ(diff.changed[0].syspath, "/sys/devices/changed");
+    EXPECT_EQ(diff.changed[0].keys, (std::vector<std::string>{ "DRIVER", "ID_GONE", "ID_NEW" }));
+
+    EXPECT_TRUE(older.Diff(older).IsEmpty());
+    const DeviceDiff reversed = newer.Diff(older);
+    EXPECT_EQ(reversed.added, diff.removed);
+    EXPECT_EQ(reversed.removed, diff.added);
+}
+
+TEST(DeviceSetTest, DuplicatedSyspathsKeepTheFirstDevice) {
+    std::vector<Device> devices;
+    devices.push_back(MakeDevice("/devices/twice", { { "DRIVER", "first" } }));
+    devices.push_back(MakeDevice("/devices/twice", { { "DRIVER", "second" } }));
+    std::vector<Device> first;
+    first.push_back(MakeDevice("/devices/twice", { { "DRIVER", "first" } }));
+
+    const DeviceSet set(devices);
+    EXPECT_EQ(set.GetSize(), 1u);
+    EXPECT_TRUE(set.Diff(DeviceSet(first)).IsEmpty());
+}
+
+TEST(DeviceSetTest, EnumerationMatchesInventoryAndDevices) {
+    DeviceEnumerator enumerator;
+    const std::vector<Device> devices = enumerator.GetAllDevices();
+    const std::string path = (std::filesystem::temp_directory_path() / ("deviceset-" + std::to_string(getpid()) + ".inventory")).string();
+    DeviceInventory::Write(path, devices, DeviceInventory::ReadUeventSeqnum());
+
+    const DeviceSet fromDevices(devices);
+    const DeviceSet fromInventory{ DeviceInventory(path) };
+    EXPECT_EQ(fromDevices.GetSize(), devices.size());
+    EXPECT_TRUE(fromDevices.Diff(fromInventory).IsEmpty());
+    EXPECT_LE(fromDevices.Diff(DeviceSet(enumerator)).changed.size(), 1u) << "Only a device changing during the test may differ.";
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceSnapshot.h>
+#include <EventMonitor/DeviceEnumerator.h>
+
+namespace {
+    void ExpectSameFields(const Device& device, const DeviceSnapshot& snapshot) {
+        for (std::size_t i = 0; i < static_cast<std::size_t>(DeviceField::Count); ++i) {
+            const auto field = static_cast<DeviceField>(i);
+            const auto& expected = device.GetField(field);
+            const auto actual = snapshot.Get(field);
+            ASSERT_EQ(expected.has_value(), actual.has_value()) << "Presence mismatch for field " << i;
+            if (expected) {
+                EXPECT_EQ(*expected, *actual) << "Value mismatch for field " << i;
+            }
+        }
+    }
+}
+
+TEST(DeviceSnapshotTest, MatchesDeviceFields) {
+    auto strings = std::make_shared<StringTable>();
+    const auto devices = DeviceEnumerator().GetAllDevices();
+
+    std::vector<DeviceSnapshot> snapshots;
+    snapshots.reserve(devices.size());
+    for (const auto& device : devices) {
+        snapshots.push_back(DeviceSnapshot::FromDevice(device, strings));
+    }
+
+    for (std::size_t i = 0; i < devices.size(); ++i) {
+        ExpectSameFields(devices[i], snapshots[i]);
+    }
+
+    // Subsystems repeat across devices, they should be interned once each.
+    if (devices.size() > 1) {
+        EXPECT_LT(strings->GetSize(), devices.size() * 4);
+    }
+}
+
+TEST(DeviceSnapshotTest, CopyIsIndependent) {
+    const auto device = DeviceEnumerator().GetDeviceFirst();
+    if (!device) {
+        GTEST_SKIP() << "No device to snapshot on this system.";
+    }
+
+    auto snapshot = DeviceSnapshot::FromDevice(*device);
+    const DeviceSnapshot copy(snapshot);
+    EXPECT_EQ(copy.GetMemoryUsage(), snapshot.GetMemoryUsage());
+
+    snapshot = DeviceSnapshot::FromDevice(*device);
+    ExpectSameFields(*device, copy);
+    EXPECT_EQ(copy.GetSyspath(), device->GetSyspath().value());
+}
+
+TEST(DeviceSnapshotTest, MovedFromIsEmpty) {
+    const Device device = Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{
+        { "DEVPATH", "/devices/snapshot" }, { "SUBSYSTEM", "test" },
+    }));
+    auto snapshot = DeviceSnapshot::FromDevice(device);
+    const DeviceSnapshot moved(std::move(snapshot));
+    EXPECT_EQ(moved.GetSyspath(), "/sys/devices/snapshot");
+
+    // NOLINTNEXTLINE(bugprone-use-after-move) : the moved-from state is what is tested.
+    EXPECT_FALSE(snapshot.Has(DeviceField::Syspath));
+    EXPECT_FALSE(snapshot.GetSyspath().has_value());
+    EXPECT_FALSE(snapshot.GetSubsystem().has_value());
+    EXPECT_EQ(snapshot.GetMemoryUsage(), 0u);
+
+    const DeviceSnapshot copy(snapshot);
+    EXPECT_EQ(copy.GetMemoryUsage(), 0u);
+    snapshot = moved;
+    EXPECT_EQ(snapshot.GetSyspath(), "/sys/devices/snapshot");
+}
+
+TEST(DeviceSnapshotTest, NullStringTable) {
+    const auto device = DeviceEnumerator().GetDeviceFirst();
+    if (!device) {
+        GTEST_SKIP() << "No device to snapshot on this system.";
+    }
+    EXPECT_THROW(DeviceSnapshot::FromDevice(*device, nullptr), std::invalid_argument);
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceTopology.h>
+#include <EventMonitor/test/Utilities.h>
+#include <algorithm>
+
+namespace {
+    std::vector<std::string> GetSyspaths(const DeviceTopology& topology, const std::vector<DeviceTopology::NodeId>& nodes) {
+        std::vector<std::string> syspaths;
+        for (const auto node : nodes) {
+            syspaths.emplace_back(topology.GetSyspath(node));
+        }
+        std::sort(syspaths.begin(), syspaths.end());
+        return syspaths;
+    }
+
+    // A hub with a disk and its partition, and a keyboard.
+    void InsertHub(DeviceTopology& topology) {
+        topology.Insert(MakeDevice("/devices/hub", { { "SUBSYSTEM", "usb" } }));
+        topology.Insert(MakeDevice("/devices/hub/port1", { { "SUBSYSTEM", "usb" } }));
+        topology.Insert(MakeDevice("/devices/hub/port1/sda", { { "SUBSYSTEM", "block" } }));
+        topology.Insert(MakeDevice("/devices/hub/port1/sda/sda1", { { "SUBSYSTEM", "block" } }));
+        topology.Insert(MakeDevice("/devices/hub/port2", { { "SUBSYSTEM", "usb" } }));
+        topology.Insert(MakeDevice("/devices/hub/port2/input0", { { "SUBSYSTEM", "input" } }));
+    }
+}
+
+TEST(DeviceTopologyTest, SubtreeQueriesFilterBySubsystem) {
+    DeviceTopology topology;
+    InsertHub(topology);
+    ASSERT_EQ(topology.GetSize(), 6u);
+
+    const auto hub = topology.Find("/sys/devices/hub");
+    ASSERT_TRUE(hub.has_value());
+    EXPECT_EQ(GetSyspaths(topology, topology.GetDescendants(*hub)).size(), 5u);
+    EXPECT_EQ(GetSyspaths(topology, topology.GetDescendants(*hub, "block")),
+              (std::vector<std::string>{ "/sys/devices/hub/port1/sda", "/sys/devices/hub/port1/sda/sda1" }));
+    EXPECT_TRUE(topology.GetDescendants(*hub, "net").empty());
+    EXPECT_EQ(topology.GetChildren(*hub).size(), 2u);
+    EXPECT_EQ(topology.GetRoots(), std::vector<DeviceTopology::NodeId>{ *hub });
+
+    const auto partition = topology.Find("/sys/devices/hub/port1/sda/sda1");
+    ASSERT_TRUE(partition.has_value());
+    EXPECT_EQ(topology.GetSubsystem(*partition), std::string_view("block"));
+    const auto ancestors = topology.GetAncestors(*partition);
+    ASSERT_EQ(ancestors.size(), 3u);
+    EXPECT_EQ(topology.GetSyspath(ancestors[0]), "/sys/devices/hub/port1/sda") << "Closest first.";
+    EXPECT_EQ(topology.GetSyspath(ancestors[2]), "/sys/devices/hub");
+    EXPECT_EQ(topology.GetAncestors(*partition, "usb").size(), 2u);
+    EXPECT_FALSE(topology.GetParent(*hub).has_value());
+}
+
+TEST(DeviceTopologyTest, AncestorInsertedLaterAdoptsItsDescendants) {
+    DeviceTopology topology;
+    topology.Insert(MakeDevice("/devices/hub", { { "SUBSYSTEM", "usb" } }));
+    topology.Insert(MakeDevice("/devices/hub/port1/sda/sda1", { { "SUBSYSTEM", "block" } }));
+    topology.Insert(MakeDevice("/devices/other", { { "SUBSYSTEM", "usb" } }));
+    topology.Insert(MakeDevice("/devices/hub/port1", { { "SUBSYSTEM", "usb" } }));
+
+    const auto port = topology.Find("/sys/devices/hub/port1");
+    const auto partition = topology.Find("/sys/devices/hub/port1/sda/sda1");
+    ASSERT_TRUE(port && partition);
+    EXPECT_EQ(topology.GetParent(*partition), port);
+    EXPECT_EQ(topology.GetRoots().size(), 2u);
+}
+
+TEST(DeviceTopologyTest, RemoveErasesTheSubtree) {
+    DeviceTopology topology;
+    InsertHub(topology);
+
+    const auto erased = topology.Apply(MakeDevice("/devices/hub/port1", { { "ACTION", "remove" }, { "SUBSYSTEM", "usb" } }));
+    ASSERT_EQ(erased.size(), 3u);
+    EXPECT_EQ(erased[0], "/sys/devices/hub/port1") << "The device comes first.";
+    EXPECT_EQ(topology.GetSize(), 3u);
+    EXPECT_FALSE(topology.Find("/sys/devices/hub/port1/sda").has_value());
+    EXPECT_EQ(topology.GetChildren(*topology.Find("/sys/devices/hub")).size(), 1u);
+    EXPECT_TRUE(topology.Erase("/sys/devices/unknown").empty());
+
+    // Freed nodes are reused.
+    topology.Insert(MakeDevice("/devices/hub/port3", { { "SUBSYSTEM", "usb" } }));
+    EXPECT_LT(*topology.Find("/sys/devices/hub/port3"), 6u);
+}
+
+TEST(DeviceTopologyTest, MoveRenamesTheSubtree) {
+    DeviceTopology topology;
+    InsertHub(topology);
+    topology.Insert(MakeDevice("/devices/dock", { { "SUBSYSTEM", "usb" } }));
+    const auto port = *topology.Find("/sys/devices/hub/port1");
+
+    EXPECT_TRUE(topology.Apply(MakeDevice("/devices/dock/port9", { { "ACTION", "move" }, { "SUBSYSTEM", "usb" }, { "DEVPATH_OLD", "/devices/hub/port1" } })).empty());
+    EXPECT_FALSE(topology.Find("/sys/devices/hub/port1").has_value());
+    EXPECT_EQ(topology.Find("/sys/devices/dock/port9"), port) << "The node is kept.";
+    EXPECT_EQ(topology.GetSyspath(*topology.GetParent(port)), "/sys/devices/dock");
+    EXPECT_EQ(GetSyspaths(topology, topology.GetDescendants(port)),
+              (std::vector<std::string>{ "/sys/devices/dock/port9/sda", "/sys/devices/dock/port9/sda/sda1" }));
+    EXPECT_EQ(topology.GetSize(), 7u);
+}
+
+TEST(DeviceTopologyTest, BuildFollowsSysfsParents) {
+    DeviceEnumerator enumerator;
+    DeviceTopology topology;
+    topology.Build(enumerator);
+
+    std::size_t enumerated = 0;
+    for (const Device& device : enumerator.Borrowed()) {
+        const auto node = topology.Find(*device.GetSyspathView());
+        ASSERT_TRUE(node.has_value()) << *device.GetSyspathView();
+        const auto parent = device.GetParent();
+        ASSERT_EQ(topology.GetParent(*node).has_value(), parent.has_value());
+        if (parent) {
+            EXPECT_EQ(topology.GetSyspath(*topology.GetParent(*node)), *parent->GetSyspathView());
+        }
+        ++enumerated;
+    }
+    EXPECT_GE(topology.GetSize(), enumerated) << "Ancestors without subsystem are kept too.";
+
+    std::size_t reachable = 0;
+    for (const auto root : topology.GetRoots()) {
+        reachable += 1 + topology.GetDescendants(root).size();
+    }
+    EXPECT_EQ(reachable, topology.GetSize());
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DeviceWorkflow.h>
+#include <EventMonitor/test/Utilities.h>
+
+#if !defined(__cpp_impl_coroutine)
+#error "DeviceWorkflow tests must be built with C++20 coroutines."
+#endif
+
+namespace {
+    DeviceWorkflow AwaitTwoSteps(DeviceMonitor& monitor, std::vector<std::string>& steps) {
+        auto disk = co_await monitor.Next([](const Device& device) { return device.GetSubsystemView() == std::string_view("block"); });
+        steps.push_back(disk ? *disk->GetSyspath() : "none");
+        auto child = co_await monitor.Next([](const Device& device) { return device.GetSubsystemView() == std::string_view("scsi"); });
+        steps.push_back(child ? *child->GetSyspath() : "none");
+    }
+
+    DeviceWorkflow AwaitWithTimeout(DeviceMonitor& monitor, std::optional<Device>& result, bool& done) {
+        result = co_await monitor.WaitFor([](const Device&) { return true; }, std::chrono::milliseconds(5));
+        done = true;
+    }
+}
+
+TEST(DeviceWorkflowTest, CoroutineWorkflows) {
+    DeviceMonitor monitor(std::make_shared<Event>());
+    std::vector<std::vector<std::string>> steps(1000);
+    for (auto& workflow : steps) {
+        AwaitTwoSteps(monitor, workflow);
+    }
+    EXPECT_EQ(monitor.GetWaiterCount(), 1000u);
+
+    monitor.Inject(MakeDevice("/devices/a", { { "ACTION", "add" }, { "SUBSYSTEM", "block" } }));
+    monitor.Inject(MakeDevice("/devices/b", { { "ACTION", "add" }, { "SUBSYSTEM", "scsi" } }));
+    EXPECT_EQ(monitor.GetWaiterCount(), 0u);
+    for (const auto& workflow : steps) {
+        EXPECT_EQ(workflow, (std::vector<std::string>{ "/sys/devices/a", "/sys/devices/b" }));
+    }
+}
+
+TEST(DeviceWorkflowTest, TimeoutResumesWithNothing) {
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor(event);
+    std::optional<Device> result;
+    bool done = false;
+    AwaitWithTimeout(monitor, result, done);
+    EXPECT_FALSE(done);
+
+    for (int i = 0; i < 100 && !done; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 100000), 0);
+    }
+    EXPECT_TRUE(done);
+    EXPECT_FALSE(result.has_value());
+}
+
+TEST(DeviceWorkflowTest, DestroyedMonitorResumesWithNothing) {
+    auto monitor = std::make_unique<DeviceMonitor>(std::make_shared<Event>());
+    std::vector<std::string> steps;
+    AwaitTwoSteps(*monitor, steps);
+    monitor.reset();
+    // Awaiting again from the destructor is cancelled too, so the workflow runs to its end.
+    EXPECT_EQ(steps, (std::vector<std::string>{ "none", "none" }));
+}
@@ -0,0 +1,146 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/DispatchQueue.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/test/Utilities.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+TEST(DispatchQueueTest, InvalidArguments) {
+    EXPECT_THROW(DispatchQueue(16, 1, nullptr), std::invalid_argument);
+    EXPECT_THROW(DispatchQueue(16, 0, [](Device) {}), std::invalid_argument);
+    EXPECT_THROW(DispatchQueue(0, 1, [](Device) {}), std::invalid_argument);
+}
+
+TEST(DispatchQueueTest, ConsumersReceiveEveryPushedDevice) {
+    auto devices = DeviceEnumerator().GetAllDevices();
+    if (devices.empty()) {
+        GTEST_SKIP() << "No device to dispatch on this system.";
+    }
+    const auto deviceCount = devices.size();
+
+    std::atomic<std::size_t> handled(0);
+    DispatchQueue queue(deviceCount, 2, [&handled](Device device) {
+        EXPECT_TRUE(device.GetSyspath().has_value());
+        ++handled;
+    });
+
+    for (auto& device : devices) {
+        queue.Push(std::move(device));
+    }
+    queue.Stop();
+
+    EXPECT_EQ(handled.load(), deviceCount) << "Stop() should let the consumers drain the queue.";
+    EXPECT_EQ(queue.GetDroppedCount(), 0u);
+    EXPECT_EQ(queue.GetDepth(), 0u);
+}
+
+TEST(DispatchQueueTest, PushAfterStopIsDropped) {
+    auto devices = DeviceEnumerator().GetAllDevices();
+    if (devices.empty()) {
+        GTEST_SKIP() << "No device to dispatch on this system.";
+    }
+
+    DispatchQueue queue(4, 1, [](Device) {});
+    queue.Stop();
+    queue.Push(std::move(devices.front()));
+    EXPECT_EQ(queue.GetDroppedCount(), 1u);
+}
+
+namespace {
+    // Queue of 2 slots whose single consumer holds the first device until released, so the next pushes overflow.
+    struct StalledQueue {
+        explicit StalledQueue(DispatchQueue::OverflowPolicy policy)
+            : queue(2, 1, [this](Device device) {
+                  started = true;
+                  while (!released) {
+                      std::this_thread::yield();
+                  }
+                  std::lock_guard<std::mutex> lock(mutex);
+                  handled.push_back(*device.GetSyspath());
+              }, {}, policy) {
+            queue.Push(MakeDevice("/devices/first"));
+            while (!started) {
+                std::this_thread::yield();
+            }
+        }
+
+        std::vector<std::string> Drain() {
+            released = true;
+            queue.Stop();
+            return handled;
+        }
+
+        std::atomic<bool> started{ false };
+        std::atomic<bool> released{ false };
+        std::mutex mutex;
+        std::vector<std::string> handled;
+        DispatchQueue queue;
+    };
+}
+
+TEST(DispatchQueueTest, DropNewestPolicy) {
+    StalledQueue stalled(DispatchQueue::OverflowPolicy::DropNewest);
+    for (const char* devpath : { "/devices/a", "/devices/b", "/devices/c" }) {
+        stalled.queue.Push(MakeDevice(devpath));
+    }
+    EXPECT_EQ(stalled.Drain(), (std::vector<std::string>{ "/sys/devices/first", "/sys/devices/a", "/sys/devices/b" }));
+    EXPECT_EQ(stalled.queue.GetStats().droppedNewest, 1u);
+    EXPECT_EQ(stalled.queue.GetDroppedCount(), 1u);
+}
+
+TEST(DispatchQueueTest, DropOldestPolicy) {
+    StalledQueue stalled(DispatchQueue::OverflowPolicy::DropOldest);
+    for (const char* devpath : { "/devices/a", "/devices/b", "/devices/c" }) {
+        stalled.queue.Push(MakeDevice(devpath));
+    }
+    EXPECT_EQ(stalled.Drain(), (std::vector<std::string>{ "/sys/devices/first", "/sys/devices/b", "/sys/devices/c" }));
+    EXPECT_EQ(stalled.queue.GetStats().droppedOldest, 1u);
+    EXPECT_EQ(stalled.queue.GetDroppedCount(), 1u);
+}
+
+TEST(DispatchQueueTest, BlockPolicy) {
+    StalledQueue stalled(DispatchQueue::OverflowPolicy::Block);
+    stalled.queue.Push(MakeDevice("/devices/a"));
+    stalled.queue.Push(MakeDevice("/devices/b"));
+
+    // Released once the next push blocks, however late this thread runs.
+    std::thread releaser([&stalled]() {
+        while (stalled.queue.GetStats().blocked == 0) {
+            std::this_thread::yield();
+        }
+        stalled.released = true;
+    });
+    stalled.queue.Push(MakeDevice("/devices/c"));
+    releaser.join();
+
+    EXPECT_EQ(stalled.Drain(), (std::vector<std::string>{ "/sys/devices/first", "/sys/devices/a", "/sys/devices/b", "/sys/devices/c" }));
+    EXPECT_EQ(stalled.queue.GetStats().blocked, 1u);
+    EXPECT_EQ(stalled.queue.GetDroppedCount(), 0u);
+}
+
+TEST(DispatchQueueTest, CoalescePerDevicePolicy) {
+    StalledQueue stalled(DispatchQueue::OverflowPolicy::CoalescePerDevice);
+    for (const char* devpath : { "/devices/a", "/devices/b", "/devices/x", "/devices/y", "/devices/x", "/devices/a" }) {
+        stalled.queue.Push(MakeDevice(devpath));
+    }
+    // Once coalescing, "a" is not reordered before the "x" and "y" waiting in the overflow area.
+    EXPECT_EQ(stalled.Drain(), (std::vector<std::string>{ "/sys/devices/first", "/sys/devices/a", "/sys/devices/b",
+                                                          "/sys/devices/x", "/sys/devices/y", "/sys/devices/a" }));
+    EXPECT_EQ(stalled.queue.GetStats().coalesced, 1u);
+    EXPECT_EQ(stalled.queue.GetDroppedCount(), 0u);
+}
+
+TEST(DispatchQueueTest, CoalescePushAfterStopIsDropped) {
+    StalledQueue stalled(DispatchQueue::OverflowPolicy::CoalescePerDevice);
+    for (const char* devpath : { "/devices/a", "/devices/b", "/devices/x" }) {
+        stalled.queue.Push(MakeDevice(devpath));
+    }
+    stalled.Drain();
+    EXPECT_EQ(stalled.queue.GetDroppedCount(), 0u);
+
+    // No consumer is left to take a coalesced device, it is counted as dropped instead.
+    stalled.queue.Push(MakeDevice("/devices/x"));
+    EXPECT_EQ(stalled.queue.GetDroppedCount(), 1u);
+    EXPECT_EQ(stalled.queue.GetStats().coalesced, 0u);
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/Event.h>
+#include <EventMonitor/EventTimer.h>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <thread>
+#include <type_traits>
+
+TEST(EventTest, PostRunsOnBackgroundThreadInOrder) {
+    Event event(Event::LoopType::New);
+    event.RunInBackground();
+    EXPECT_TRUE(event.IsRunningInBackground());
+    EXPECT_FALSE(event.IsInLoopThread());
+
+    std::vector<int> order;
+    std::promise<std::thread::id> loopThread;
+    for (int i = 0; i < 100; ++i) {
+        event.Post([&order, i]() { order.push_back(i); });
+    }
+    event.Post([&event, &loopThread]() {
+        EXPECT_TRUE(event.IsInLoopThread());
+        loopThread.set_value(std::this_thread::get_id());
+    });
+
+    auto future = loopThread.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_NE(future.get(), std::this_thread::get_id());
+
+    event.Stop();
+    EXPECT_FALSE(event.IsRunningInBackground());
+    ASSERT_EQ(order.size(), 100u);
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+}
+
+TEST(EventTest, RestartsAfterStop) {
+    Event event(Event::LoopType::New);
+    for (int round = 0; round < 3; ++round) {
+        event.RunInBackground();
+        std::promise<void> ran;
+        event.Post([&ran]() { ran.set_value(); });
+        EXPECT_EQ(ran.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        event.Stop();
+    }
+    EXPECT_THROW(event.Post(nullptr), std::invalid_argument);
+}
+
+TEST(EventTest, PostedTasksRunInForegroundLoop) {
+    Event event;
+    bool ran = false;
+    event.Post([&ran]() { ran = true; });
+    for (int i = 0; i < 100 && !ran; ++i) {
+        ASSERT_GE(sd_event_run(event.GetEvent(), 10000), 0);
+    }
+    EXPECT_TRUE(ran);
+}
+
+TEST(EventTest, BackgroundTimerAndThreadOptions) {
+    auto event = std::make_shared<Event>(Event::LoopType::New);
+    ThreadOptions options;
+    options.cpuAffinity = { 0 };
+    options.name = "event-loop-test-long-name";
+    event->RunInBackground(options);
+
+    // Sources are created on the loop thread, like everything touching a running loop.
+    std::promise<void> fired;
+    std::unique_ptr<EventTimer> timer;
+    event->Post([&]() {
+        timer = std::make_unique<EventTimer>(event, [&fired]() { fired.set_value(); });
+        timer->Arm(std::chrono::milliseconds(1));
+    });
+    EXPECT_EQ(fired.get_future().wait_for(std::chrono::seconds(5)), std::future_status::ready);
+
+    std::promise<void> released;
+    event->Post([&]() { timer.reset(); released.set_value(); });
+    released.get_future().wait();
+    event->Stop();
+}
+
+TEST(EventTest, DefaultLoopCannotRunInBackground) {
+    Event event;
+    EXPECT_EQ(event.GetLoopType(), Event::LoopType::Default);
+    EXPECT_THROW(event.RunInBackground(), std::runtime_error);
+    EXPECT_FALSE(event.IsRunningInBackground());
+}
+
+TEST(EventTest, InvalidThreadOptionsLeaveLoopStopped) {
+    Event event(Event::LoopType::New);
+    ThreadOptions options;
+    options.schedulingPolicy = -1;
+    EXPECT_THROW(event.RunInBackground(options), std::runtime_error);
+    EXPECT_FALSE(event.IsRunningInBackground());
+}
+
+TEST(EventTest, IsNeitherCopiedNorMoved) {
+    // The loop thread and the sources hold pointers into the Event, which is shared through a shared_ptr instead.
+    static_assert(!std::is_move_constructible_v<Event> && !std::is_move_assignable_v<Event>);
+    static_assert(!std::is_copy_constructible_v<Event> && !std::is_copy_assignable_v<Event>);
+    auto event = std::make_shared<Event>(Event::LoopType::New);
+    EXPECT_FALSE(event->IsRunningInBackground());
+}
+
+TEST(EventTest, InvokeRacingStopNeverHangs) {
+    for (int round = 0; round < 100; ++round) {
+        Event event(Event::LoopType::New);
+        event.RunInBackground();
+        std::atomic<int> ran(0);
+
+        std::thread invoker([&event, &ran]() { event.Invoke([&ran]() { ++ran; }); });
+        event.Stop();
+        invoker.join();
+        // Run by the loop thread before leaving, or inline once it is gone.
+        EXPECT_EQ(ran.load(), 1);
+    }
+}
+
+TEST(EventTest, ReleasedFromItsOwnLoopThread) {
+    auto event = std::make_shared<Event>(Event::LoopType::New);
+    event->RunInBackground();
+
+    std::promise<void> drained;
+    event->Post([&event, &drained]() {
+        event->Post([&drained]() { drained.set_value(); });
+        // The last reference, e.g. held by a monitor destroyed from its own callback.
+        event.reset();
+    });
+    auto future = drained.get_future();
+    ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready) << "The posted tasks still run.";
+    EXPECT_FALSE(event);
+}
@@ -0,0 +1,106 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/EventLoopGroup.h>
+#include <EventMonitor/test/Utilities.h>
+#include <chrono>
+#include <future>
+#include <set>
+
+TEST(EventLoopGroupTest, LoopsRunOnDistinctThreads) {
+    EventLoopGroup group(3);
+    ASSERT_EQ(group.GetLoopCount(), 3u);
+
+    std::set<std::thread::id> threads;
+    for (std::size_t i = 0; i < group.GetLoopCount(); ++i) {
+        const auto& loop = group.GetLoop(i);
+        EXPECT_EQ(loop->GetLoopType(), Event::LoopType::New);
+        EXPECT_TRUE(loop->IsRunningInBackground());
+        loop->Invoke([&threads, &loop]() {
+            EXPECT_TRUE(loop->IsInLoopThread());
+            threads.insert(std::this_thread::get_id());
+        });
+    }
+    EXPECT_EQ(threads.size(), 3u);
+    EXPECT_EQ(threads.count(std::this_thread::get_id()), 0u);
+    EXPECT_THROW(group.GetLoop(3), std::out_of_range);
+}
+
+TEST(EventLoopGroupTest, InvokeRethrows) {
+    EventLoopGroup group(1);
+    EXPECT_THROW(group.GetLoop(0)->Invoke([]() { throw std::runtime_error("Failed"); }), std::runtime_error);
+    EXPECT_THROW(group.GetLoop(0)->Invoke(nullptr), std::invalid_argument);
+
+    // The loop survives a throwing task.
+    bool ran = false;
+    group.GetLoop(0)->Invoke([&ran]() { ran = true; });
+    EXPECT_TRUE(ran);
+}
+
+TEST(EventLoopGroupTest, MonitorsAreSpreadAndDispatchOnTheirLoop) {
+    EventLoopGroup group(2);
+    std::promise<std::thread::id> received[2];
+
+    std::shared_ptr<DeviceMonitor> monitors[2];
+    for (int i = 0; i < 2; ++i) {
+        monitors[i] = group.AddMonitor([&received, i](DeviceMonitor& monitor) {
+            monitor.SetCallback([&received, i](const DeviceMonitor&, Device device) {
+                EXPECT_EQ(device.GetSyspath(), "/sys/devices/test" + std::to_string(i));
+                received[i].set_value(std::this_thread::get_id());
+            });
+            monitor.AddMatchSubsystemDevtype("test");
+        });
+        EXPECT_TRUE(monitors[i]->IsMonitoringForEvents());
+    }
+    // Round-robin.
+    EXPECT_EQ(monitors[0]->GetEvent(), group.GetLoop(0));
+    EXPECT_EQ(monitors[1]->GetEvent(), group.GetLoop(1));
+
+    std::thread::id loopThreads[2];
+    for (int i = 0; i < 2; ++i) {
+        monitors[i]->GetEvent()->Invoke([&monitors, &loopThreads, i]() {
+            loopThreads[i] = std::this_thread::get_id();
+            monitors[i]->Inject(MakeDevice("/devices/test" + std::to_string(i), { { "ACTION", "add" }, { "SUBSYSTEM", "test" } }));
+        });
+        auto future = received[i].get_future();
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get(), loopThreads[i]);
+    }
+    EXPECT_NE(loopThreads[0], loopThreads[1]);
+
+    // Released on their loop thread.
+    monitors[0].reset();
+    group.Stop();
+    monitors[1].reset();
+}
+
+TEST(EventLoopGroupTest, MonitorReleasedFromItsOwnCallback) {
+    EventLoopGroup group(1);
+    auto token = std::make_shared<int>(0);
+    const std::weak_ptr<int> alive = token;
+    std::promise<bool> aliveAfterRelease;
+
+    std::shared_ptr<DeviceMonitor> monitor;
+    monitor = group.AddMonitor([&monitor, &alive, &aliveAfterRelease, token](DeviceMonitor& created) {
+        created.SetCallback([&monitor, &alive, &aliveAfterRelease, token](const DeviceMonitor&, Device) {
+            // Dropping the last reference from the dispatch defers the deletion past it.
+            monitor.reset();
+            aliveAfterRelease.set_value(!alive.expired());
+        });
+        created.AddMatchSubsystemDevtype("test");
+    });
+    token.reset();
+
+    group.GetLoop(0)->Invoke([&monitor]() { monitor->Inject(MakeDevice("/devices/test", { { "ACTION", "add" }, { "SUBSYSTEM", "test" } })); });
+    EXPECT_TRUE(aliveAfterRelease.get_future().get());
+    EXPECT_FALSE(monitor);
+    // The posted deletion ran before this round trip.
+    group.GetLoop(0)->Invoke([]() {});
+    EXPECT_TRUE(alive.expired()) << "The monitor and its callback are destroyed.";
+}
+
+TEST(EventLoopGroupTest, AddMonitorValidatesArguments) {
+    EventLoopGroup group(1);
+    EXPECT_THROW(group.AddMonitor(1, [](DeviceMonitor&) {}), std::out_of_range);
+    EXPECT_THROW(group.AddMonitor(nullptr), std::invalid_argument);
+    // No callback, StartMonitoring() throws on the loop thread and the monitor is not leaked.
+    EXPECT_THROW(group.AddMonitor([](DeviceMonitor&) {}), std::runtime_error);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/EventRecorder.h>
+#include <EventMonitor/EventReplayer.h>
+#include <EventMonitor/test/Utilities.h>
+#include <filesystem>
+#include <fstream>
+
+TEST(EventRecorderTest, AppendsToExistingLog) {
+    const std::string path = TemporaryPath("recorder-append");
+    std::filesystem::remove(path);
+    const auto device = Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{ { "DEVPATH", "/devices/virtual/misc/fake" } }));
+
+    {
+        EventRecorder recorder(path);
+        recorder.Record(device);
+        EXPECT_EQ(recorder.GetRecordCount(), 1u);
+    }
+    {
+        EventRecorder recorder(path);
+        recorder.Record(device);
+        recorder.Record(device);
+    }
+
+    std::size_t replayed = 0;
+    EventReplayer(path).Replay([&replayed](Device) { ++replayed; });
+    EXPECT_EQ(replayed, 3u);
+    std::filesystem::remove(path);
+}
+
+TEST(EventRecorderTest, RejectsForeignFile) {
+    const std::string path = TemporaryPath("recorder-foreign");
+    std::ofstream(path) << "definitely not an event log";
+
+    EXPECT_THROW(EventRecorder recorder(path), std::runtime_error);
+    EXPECT_THROW(EventReplayer replayer(path), std::runtime_error);
+    std::filesystem::remove(path);
+}
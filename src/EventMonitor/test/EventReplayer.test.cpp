@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/EventReplayer.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <EventMonitor/test/Utilities.h>
+#include <atomic>
+#include <filesystem>
+
+TEST(EventReplayerTest, ReplaysRecordedDevices) {
+    const std::string path = TemporaryPath("replayer-devices");
+    std::filesystem::remove(path);
+
+    std::vector<std::string> syspaths;
+    std::vector<std::size_t> propertyCounts;
+    {
+        EventRecorder recorder(path);
+        for (const Device& device : DeviceEnumerator()) {
+            recorder.Record(device);
+            syspaths.push_back(device.GetSyspath().value_or(""));
+            propertyCounts.push_back(device.GetAllProperties().GetSize());
+            if (syspaths.size() == 64) {
+                break;
+            }
+        }
+    }
+
+    std::size_t index = 0;
+    const std::size_t replayed = EventReplayer(path).Replay([&](Device device) {
+        ASSERT_LT(index, syspaths.size());
+        EXPECT_TRUE(device.IsDetached());
+        EXPECT_EQ(device.GetSyspath().value_or(""), syspaths[index]);
+        EXPECT_EQ(device.GetAllProperties().GetSize(), propertyCounts[index]);
+        ++index;
+    });
+    EXPECT_EQ(replayed, syspaths.size());
+    std::filesystem::remove(path);
+}
+
+TEST(EventReplayerTest, StopsAtTruncatedTail) {
+    const std::string path = TemporaryPath("replayer-truncated");
+    std::filesystem::remove(path);
+    {
+        EventRecorder recorder(path);
+        const auto device = Device::CreateFromProperties(DeviceProperties({ { "ACTION", "change" }, { "DEVPATH", "/devices/virtual/misc/fake" } }));
+        recorder.Record(device, std::chrono::microseconds(1000));
+        recorder.Record(device, std::chrono::microseconds(41000));
+    }
+    // Simulate a recorder killed in the middle of a write.
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+
+    const std::size_t replayed = EventReplayer(path).Replay([](Device device) {
+        EXPECT_EQ(device.GetAction(), SD_DEVICE_CHANGE);
+    });
+    EXPECT_EQ(replayed, 1u);
+    std::filesystem::remove(path);
+}
+
+TEST(EventReplayerTest, ScaledPaceKeepsRelativeDelays) {
+    const std::string path = TemporaryPath("replayer-delays");
+    std::filesystem::remove(path);
+    {
+        EventRecorder recorder(path);
+        const auto device = Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{ { "DEVPATH", "/devices/virtual/misc/fake" } }));
+        recorder.Record(device, std::chrono::microseconds(1000));
+        recorder.Record(device, std::chrono::microseconds(41000));
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(EventReplayer(path).Replay([](Device) {}, EventReplayer::Pace::Scaled, 4.0), 2u);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(10));
+    std::filesystem::remove(path);
+}
+
+TEST(EventReplayerTest, PacedReplayLetsTheMonitorLoopRun) {
+    const std::string path = TemporaryPath("replayer-paced-monitor");
+    std::filesystem::remove(path);
+    {
+        EventRecorder recorder(path);
+        recorder.Record(MakeDevice("/devices/a", { { "ACTION", "add" } }), std::chrono::microseconds(1000));
+        recorder.Record(MakeDevice("/devices/b", { { "ACTION", "add" } }), std::chrono::microseconds(41000));
+    }
+
+    auto event = std::make_shared<Event>();
+    DeviceMonitor monitor(event);
+    std::vector<std::size_t> batchSizes;
+    monitor.SetBatchCallback([&batchSizes](const DeviceMonitor&, std::vector<Device> devices) { batchSizes.push_back(devices.size()); },
+                             16, std::chrono::milliseconds(5));
+
+    EventReplayer replayer(path);
+    bool done = false;
+    EXPECT_EQ(replayer.Replay(monitor, EventReplayer::Pace::Recorded, 1.0, [&done]() { done = true; }), 2u);
+    EXPECT_TRUE(replayer.IsReplaying());
+    EXPECT_TRUE(batchSizes.empty()) << "Paced injections wait for the loop.";
+
+    for (int i = 0; i < 200 && (!done || batchSizes.size() < 2); ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    EXPECT_TRUE(done);
+    EXPECT_FALSE(replayer.IsReplaying());
+    // The batch timer fired in between, as it would have live.
+    EXPECT_EQ(batchSizes, (std::vector<std::size_t>{ 1, 1 }));
+    std::filesystem::remove(path);
+}
+
+TEST(EventReplayerTest, ReplaysThroughMonitorCallback) {
+    const std::string path = TemporaryPath("replayer-monitor");
+    std::filesystem::remove(path);
+    {
+        EventRecorder recorder(path);
+        for (int i = 0; i < 100; ++i) {
+            recorder.Record(Device::CreateFromProperties(DeviceProperties({ { "ACTION", "add" }, { "SEQNUM", std::to_string(i) } })));
+        }
+    }
+
+    DeviceMonitor monitor;
+    uint64_t expectedSeqnum = 0;
+    monitor.SetCallback([&expectedSeqnum](const DeviceMonitor&, Device device) {
+        EXPECT_EQ(device.GetSeqnum(), expectedSeqnum++);
+    });
+    EXPECT_EQ(EventReplayer(path).Replay(monitor), 100u);
+    EXPECT_EQ(expectedSeqnum, 100u);
+
+    std::atomic<int> handled{0};
+    monitor.SetCallback([&handled](const DeviceMonitor&, Device) { ++handled; });
+    monitor.EnableExecutorDispatch(2);
+    EXPECT_EQ(EventReplayer(path).Replay(monitor), 100u);
+    monitor.DisableExecutorDispatch();
+    EXPECT_EQ(handled.load(), 100);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/EventTimer.h>
+
+TEST(EventTimerTest, NullArguments) {
+    EXPECT_THROW(EventTimer(nullptr, []() {}), std::runtime_error);
+    EXPECT_THROW(EventTimer(std::make_shared<Event>(), nullptr), std::invalid_argument);
+}
+
+TEST(EventTimerTest, ArmFiresOnceAndDisarms) {
+    auto event = std::make_shared<Event>();
+    int fired = 0;
+    EventTimer timer(event, [&fired]() { ++fired; });
+    EXPECT_FALSE(timer.IsArmed());
+
+    timer.Arm(std::chrono::milliseconds(1));
+    EXPECT_TRUE(timer.IsArmed());
+
+    // Run the loop until the timer fired, with an upper bound in case it never does.
+    for (int i = 0; i < 100 && fired == 0; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    EXPECT_EQ(fired, 1);
+    EXPECT_FALSE(timer.IsArmed()) << "A one-shot timer should disarm itself once fired.";
+}
+
+TEST(EventTimerTest, DisarmPreventsFiring) {
+    auto event = std::make_shared<Event>();
+    int fired = 0;
+    EventTimer timer(event, [&fired]() { ++fired; });
+
+    timer.Arm(std::chrono::milliseconds(1));
+    timer.Disarm();
+    EXPECT_FALSE(timer.IsArmed());
+
+    ASSERT_GE(sd_event_run(event->GetEvent(), 5000), 0);
+    EXPECT_EQ(fired, 0);
+}
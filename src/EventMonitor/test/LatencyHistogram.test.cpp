@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/LatencyHistogram.h>
+#include <thread>
+#include <vector>
+
+TEST(LatencyHistogramTest, BucketsCoverValuesWithBoundedError) {
+    for (uint64_t value : { 0ull, 1ull, 15ull, 16ull, 17ull, 31ull, 32ull, 1000ull, 123456789ull, (1ull << 36) - 1 }) {
+        const std::size_t index = LatencyHistogram::GetBucketIndex(value);
+        ASSERT_LT(index, LatencyHistogram::bucketCount);
+        const uint64_t upper = LatencyHistogram::GetBucketUpperBound(index);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(upper - value, value / LatencyHistogram::subBucketCount) << value;
+        if (index > 0) {
+            EXPECT_LT(LatencyHistogram::GetBucketUpperBound(index - 1), value) << value;
+        }
+    }
+    EXPECT_EQ(LatencyHistogram::GetBucketIndex(uint64_t(-1)), LatencyHistogram::bucketCount - 1);
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.GetPercentile(50).count(), 0);
+    EXPECT_THROW(histogram.GetPercentile(101), std::invalid_argument);
+
+    for (uint64_t i = 1; i <= 1000; ++i) {
+        histogram.Record(std::chrono::microseconds(i));
+    }
+    EXPECT_EQ(histogram.GetCount(), 1000u);
+    EXPECT_EQ(histogram.GetMin(), std::chrono::microseconds(1));
+    EXPECT_EQ(histogram.GetMax(), std::chrono::microseconds(1000));
+    EXPECT_EQ(histogram.GetMean(), std::chrono::nanoseconds(500500));
+    EXPECT_NEAR(histogram.GetPercentile(50).count(), 500000, 500000 / 16);
+    EXPECT_NEAR(histogram.GetPercentile(99).count(), 990000, 990000 / 16);
+    EXPECT_EQ(histogram.GetPercentile(100), std::chrono::microseconds(1000));
+
+    histogram.Reset();
+    EXPECT_EQ(histogram.GetCount(), 0u);
+    EXPECT_EQ(histogram.GetMin().count(), 0);
+}
+
+TEST(LatencyHistogramTest, ConcurrentRecordAndMerge) {
+    LatencyHistogram histogram;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&histogram, t]() {
+            for (uint64_t i = 0; i < 10000; ++i) {
+                histogram.Record(i * (t + 1));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(histogram.GetCount(), 40000u);
+    EXPECT_EQ(histogram.GetMax().count(), 9999 * 4);
+
+    LatencyHistogram total;
+    total.Record(1);
+    total.Merge(histogram);
+    EXPECT_EQ(total.GetCount(), 40001u);
+    EXPECT_EQ(total.GetMin().count(), 0);
+    EXPECT_EQ(total.GetMax(), histogram.GetMax());
+}
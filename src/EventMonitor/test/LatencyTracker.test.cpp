@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/LatencyTracker.h>
+#include <EventMonitor/DeviceMonitor.h>
+#include <thread>
+
+TEST(LatencyTrackerTest, SeriesPerSubsystemAndAction) {
+    LatencyTracker tracker(2);
+    auto& usbAdd = tracker.GetSeries("usb", SD_DEVICE_ADD);
+    EXPECT_EQ(&usbAdd, &tracker.GetSeries("usb", SD_DEVICE_ADD));
+    auto& usbRemove = tracker.GetSeries("usb", SD_DEVICE_REMOVE);
+    EXPECT_NE(&usbAdd, &usbRemove);
+    EXPECT_EQ(tracker.Find("usb", SD_DEVICE_REMOVE), &usbRemove);
+    EXPECT_EQ(tracker.Find("block", SD_DEVICE_ADD), nullptr);
+
+    // Full, later pairs share the overflow series.
+    auto& overflow = tracker.GetSeries("block", std::nullopt);
+    EXPECT_TRUE(overflow.subsystem.empty());
+    EXPECT_EQ(&overflow, &tracker.GetSeries("net", SD_DEVICE_CHANGE));
+
+    tracker.Record(usbAdd, 1000, 3000, 7000, 15000);
+    EXPECT_EQ(usbAdd.Get(LatencyTracker::Stage::Udev).GetMax().count(), 2000);
+    EXPECT_EQ(usbAdd.Get(LatencyTracker::Stage::Dispatch).GetMax().count(), 4000);
+    EXPECT_EQ(usbAdd.Get(LatencyTracker::Stage::Handler).GetMax().count(), 8000);
+    EXPECT_EQ(usbAdd.Get(LatencyTracker::Stage::Total).GetMax().count(), 14000);
+
+    tracker.Record(usbRemove, 0, 3000, 7000, 15000);
+    EXPECT_EQ(usbRemove.Get(LatencyTracker::Stage::Udev).GetCount(), 0u);
+    EXPECT_EQ(usbRemove.Get(LatencyTracker::Stage::Total).GetMax().count(), 12000);
+
+    std::size_t visited = 0;
+    tracker.ForEach([&visited](const LatencyTracker::Series&) { ++visited; });
+    EXPECT_EQ(visited, 2u) << "The unused overflow series is not visited.";
+}
+
+TEST(LatencyTrackerTest, MonitorRecordsEveryStage) {
+    DeviceMonitor monitor(std::make_shared<Event>());
+    auto tracker = std::make_shared<LatencyTracker>();
+    monitor.SetLatencyTracker(tracker);
+    monitor.SetCallback([](const DeviceMonitor&, Device) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+
+    const uint64_t initialized = LatencyTracker::Now() / 1000 - 5000;
+    monitor.Inject(Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{
+        { "ACTION", "add" },
+        { "DEVPATH", "/devices/test" },
+        { "SUBSYSTEM", "test" },
+        { "USEC_INITIALIZED", std::to_string(initialized) },
+    })));
+    monitor.Inject(Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{
+        { "ACTION", "change" },
+        { "DEVPATH", "/devices/test" },
+        { "SUBSYSTEM", "test" },
+        { "USEC_INITIALIZED", std::to_string(initialized) },
+    })));
+
+    const auto* add = tracker->Find("test", SD_DEVICE_ADD);
+    ASSERT_NE(add, nullptr);
+    EXPECT_GE(add->Get(LatencyTracker::Stage::Udev).GetMin(), std::chrono::milliseconds(5));
+    EXPECT_GE(add->Get(LatencyTracker::Stage::Handler).GetMin(), std::chrono::milliseconds(1));
+    EXPECT_GE(add->Get(LatencyTracker::Stage::Total).GetMin(), std::chrono::milliseconds(6));
+
+    const auto* change = tracker->Find("test", SD_DEVICE_CHANGE);
+    ASSERT_NE(change, nullptr);
+    EXPECT_EQ(change->Get(LatencyTracker::Stage::Udev).GetCount(), 0u) << "USEC_INITIALIZED predates a change event.";
+    EXPECT_EQ(change->Get(LatencyTracker::Stage::Dispatch).GetCount(), 1u);
+    EXPECT_LT(change->Get(LatencyTracker::Stage::Total).GetMax(), std::chrono::milliseconds(5));
+}
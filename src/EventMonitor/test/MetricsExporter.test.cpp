@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/MetricsExporter.h>
+#include <EventMonitor/test/Utilities.h>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    std::string ReadFile(const std::string& path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+}
+
+TEST(MetricsExporterTest, ServesUnixSocket) {
+    auto event = std::make_shared<Event>();
+    auto registry = std::make_shared<MetricsRegistry>();
+    registry->AddCounter("test_events_total", "Events.").Add(7);
+
+    const std::string path = TemporaryPath("metrics-socket");
+    MetricsExporter exporter(event, registry);
+    exporter.ServeUnixSocket(path);
+    EXPECT_THROW(exporter.ServeUnixSocket(path), std::runtime_error);
+
+    std::string received;
+    std::thread client([&path, &received]() {
+        const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address {};
+        address.sun_family = AF_UNIX;
+        path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+        ASSERT_EQ(connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)), 0);
+        char buffer[4096];
+        ssize_t size = 0;
+        while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+            received.append(buffer, static_cast<std::size_t>(size));
+        }
+        close(fd);
+    });
+    for (int i = 0; i < 100 && received.empty(); ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    client.join();
+    EXPECT_EQ(received, registry->Export());
+
+    exporter.Stop();
+    EXPECT_NE(access(path.c_str(), F_OK), 0) << "The socket is removed.";
+}
+
+TEST(MetricsExporterTest, RewritesFilePeriodically) {
+    auto event = std::make_shared<Event>();
+    auto registry = std::make_shared<MetricsRegistry>();
+    const auto counter = registry->AddCounter("test_events_total", "Events.");
+
+    const std::string path = TemporaryPath("metrics-file");
+    MetricsExporter exporter(event, registry);
+    EXPECT_THROW(exporter.WriteFilePeriodically(path, std::chrono::microseconds(0)), std::invalid_argument);
+    exporter.WriteFilePeriodically(path, std::chrono::milliseconds(1));
+    EXPECT_NE(ReadFile(path).find("test_events_total 0\n"), std::string::npos);
+
+    counter.Add(2);
+    for (int i = 0; i < 100 && ReadFile(path).find("test_events_total 2\n") == std::string::npos; ++i) {
+        ASSERT_GE(sd_event_run(event->GetEvent(), 10000), 0);
+    }
+    EXPECT_NE(ReadFile(path).find("test_events_total 2\n"), std::string::npos);
+    EXPECT_THROW(exporter.WriteFile("/nonexistent/metrics.prom"), std::runtime_error);
+    unlink(path.c_str());
+}
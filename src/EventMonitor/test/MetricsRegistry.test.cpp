@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/MetricsRegistry.h>
+#include <EventMonitor/DeviceEnumerator.h>
+#include <future>
+#include <thread>
+#include <vector>
+
+TEST(MetricsRegistryTest, CountersAreSummedOverThreads) {
+    MetricsRegistry registry;
+    const auto counter = registry.AddCounter("test_events_total", "Events.", { { "monitor", "usb" } });
+    const auto same = registry.AddCounter("test_events_total", "Events.", { { "monitor", "usb" } });
+    const auto other = registry.AddCounter("test_events_total", "Events.", { { "monitor", "block" } });
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&counter]() {
+            for (int i = 0; i < 10000; ++i) {
+                counter.Add();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    same.Add(5);
+
+    EXPECT_EQ(registry.GetValue(counter), 40005u) << "Same name and labels, same counter.";
+    EXPECT_EQ(registry.GetValue(other), 0u);
+
+    MetricsRegistry::Counter disabled;
+    EXPECT_FALSE(disabled);
+    EXPECT_NO_THROW(disabled.Add());
+    EXPECT_THROW(registry.GetValue(disabled), std::invalid_argument);
+    EXPECT_THROW(registry.AddGauge("test_events_total", "Events."), std::invalid_argument) << "Type mismatch.";
+    EXPECT_THROW(registry.AddCounter("", "Empty."), std::invalid_argument);
+}
+
+TEST(MetricsRegistryTest, ExitedThreadsShardsAreRetiredAndReused) {
+    MetricsRegistry registry;
+    const auto counter = registry.AddCounter("test_total", "Test counter.");
+
+    // Sequential short-lived threads, like consumers recreated on every Enable/Disable.
+    for (int i = 0; i < 50; ++i) {
+        std::thread([&counter]() { counter.Add(2); }).join();
+    }
+    EXPECT_EQ(registry.GetValue(counter), 100u) << "Exited threads keep counting.";
+    EXPECT_EQ(registry.GetShardCount(), 1u) << "The shard of an exited thread is reused.";
+
+    // A thread exiting after its registry is gone leaves it alone.
+    std::promise<void> added;
+    std::promise<void> destroyed;
+    std::thread survivor;
+    {
+        MetricsRegistry shortLived;
+        const auto shortCounter = shortLived.AddCounter("short_total", "Short lived.");
+        survivor = std::thread([shortCounter, &added, registryGone = destroyed.get_future()]() {
+            shortCounter.Add();
+            added.set_value();
+            registryGone.wait();
+        });
+        added.get_future().wait();
+        EXPECT_EQ(shortLived.GetValue(shortCounter), 1u);
+    }
+    destroyed.set_value();
+    survivor.join();
+}
+
+TEST(MetricsRegistryTest, PrometheusTextExport) {
+    MetricsRegistry registry;
+    registry.AddCounter("test_events_total", "Events.", { { "monitor", "a\"b" } }).Add(3);
+    registry.AddGauge("test_depth", "Depth.").Set(-2);
+    auto& summary = registry.AddSummary("test_duration_seconds", "Duration.");
+    summary.Record(std::chrono::milliseconds(2));
+
+    const std::string text = registry.Export();
+    EXPECT_NE(text.find("# HELP test_events_total Events.\n# TYPE test_events_total counter\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("test_events_total{monitor=\"a\\\"b\"} 3\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("# TYPE test_depth gauge\ntest_depth -2\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("# TYPE test_duration_seconds summary\n"), std::string::npos) << text;
+    EXPECT_NE(text.find("test_duration_seconds{quantile=\"0.99\"} 0.002"), std::string::npos) << text;
+    EXPECT_NE(text.find("test_duration_seconds_sum 0.002\ntest_duration_seconds_count 1\n"), std::string::npos) << text;
+}
+
+TEST(MetricsRegistryTest, EnumeratorMetrics) {
+    auto registry = std::make_shared<MetricsRegistry>();
+    DeviceEnumerator enumerator;
+    enumerator.SetMetrics(registry);
+    const auto devices = enumerator.GetAllDevices();
+
+    const auto enumerations = registry->AddCounter("eventmonitor_enumerations_total", "Completed enumerations.");
+    const auto enumerated = registry->AddCounter("eventmonitor_enumerated_devices_total", "Devices returned by enumerations.");
+    EXPECT_EQ(registry->GetValue(enumerations), 1u);
+    EXPECT_EQ(registry->GetValue(enumerated), devices.size());
+    EXPECT_EQ(registry->AddSummary("eventmonitor_enumeration_duration_seconds", "").GetCount(), 1u);
+}
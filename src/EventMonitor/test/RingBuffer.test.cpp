@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/RingBuffer.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(RingBufferTest, CapacityIsRoundedUpToPowerOfTwo) {
+    EXPECT_THROW(RingBuffer<int>(0), std::invalid_argument);
+    EXPECT_EQ(RingBuffer<int>(1).GetCapacity(), 1u);
+    EXPECT_EQ(RingBuffer<int>(5).GetCapacity(), 8u);
+    EXPECT_EQ(RingBuffer<int>(64).GetCapacity(), 64u);
+}
+
+TEST(RingBufferTest, PushPopInOrderAndFull) {
+    RingBuffer<std::string> buffer(4);
+    EXPECT_TRUE(buffer.IsEmpty());
+    EXPECT_FALSE(buffer.TryPop().has_value());
+
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_TRUE(buffer.TryPush(std::to_string(i)));
+    }
+    EXPECT_EQ(buffer.GetSize(), 4u);
+
+    // A failed push must leave the value untouched.
+    std::string overflow = "overflow";
+    EXPECT_FALSE(buffer.TryPush(std::move(overflow)));
+    EXPECT_EQ(overflow, "overflow");
+
+    for (int i = 0; i < 4; ++i) {
+        const auto value = buffer.TryPop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(*value, std::to_string(i));
+    }
+    EXPECT_TRUE(buffer.IsEmpty());
+}
+
+TEST(RingBufferTest, WrapsAround) {
+    RingBuffer<int> buffer(2);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(buffer.TryPush(int(i)));
+        const auto value = buffer.TryPop();
+        ASSERT_TRUE(value.has_value());
+        EXPECT_EQ(*value, i);
+    }
+}
+
+TEST(RingBufferTest, ConcurrentProducersAndConsumers) {
+    constexpr int producerCount = 2;
+    constexpr int consumerCount = 2;
+    constexpr int valuesPerProducer = 20000;
+
+    RingBuffer<int> buffer(128);
+    std::atomic<long long> sum(0);
+    std::atomic<int> consumed(0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producerCount; ++p) {
+        threads.emplace_back([&buffer]() {
+            for (int i = 1; i <= valuesPerProducer; ++i) {
+                while (!buffer.TryPush(int(i))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumerCount; ++c) {
+        threads.emplace_back([&]() {
+            while (consumed.load() < producerCount * valuesPerProducer) {
+                if (const auto value = buffer.TryPop()) {
+                    sum += *value;
+                    ++consumed;
+                }
+                else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const long long expected = producerCount * (static_cast<long long>(valuesPerProducer) * (valuesPerProducer + 1) / 2);
+    EXPECT_EQ(sum.load(), expected);
+    EXPECT_TRUE(buffer.IsEmpty());
+}
@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/StringTable.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(StringTableTest, InternDeduplicates) {
+    StringTable table;
+    const auto usb = table.Intern("usb");
+    const auto block = table.Intern("block");
+    EXPECT_NE(usb, block);
+    EXPECT_EQ(table.Intern(std::string("usb")), usb);
+    EXPECT_EQ(table.GetSize(), 2u);
+
+    EXPECT_EQ(table.Lookup(usb), "usb");
+    EXPECT_EQ(table.Lookup(block), "block");
+}
+
+TEST(StringTableTest, LookupsStayValidWhileGrowing) {
+    StringTable table;
+    const auto first = table.Intern("first");
+    const std::string_view firstView = table.Lookup(first);
+
+    // Enough strings to span several chunks and arena blocks, plus one larger than a block.
+    for (int i = 0; i < 5000; ++i) {
+        table.Intern("string-" + std::to_string(i));
+    }
+    table.Intern(std::string(100000, 'x'));
+
+    EXPECT_EQ(table.Lookup(first), "first");
+    EXPECT_EQ(firstView.data(), table.Lookup(first).data()) << "Interned strings should never move.";
+    EXPECT_EQ(table.Lookup(table.Intern("string-4999")), "string-4999");
+    EXPECT_EQ(table.GetSize(), 5002u);
+}
+
+TEST(StringTableTest, ConcurrentInterning) {
+    StringTable table;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&table]() {
+            for (int i = 0; i < 1000; ++i) {
+                const auto value = std::to_string(i);
+                EXPECT_EQ(table.Lookup(table.Intern(value)), value);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(table.GetSize(), 1000u);
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/SysattrReader.h>
+#include <EventMonitor/DeviceEnumerator.h>
+
+namespace {
+    const std::vector<std::string> sysattrs{ "uevent", "dev", "driver", "subsystem", "modalias", "not_an_attribute" };
+
+    // Every attribute of the first devices, as libsystemd reads them.
+    void ExpectSameAsLibsystemd(SysattrReader& reader) {
+        std::vector<Device> devices;
+        for (const Device& device : DeviceEnumerator()) {
+            devices.push_back(Device::CreateFromSyspath(*device.GetSyspath()));
+            if (devices.size() == 100) {
+                break;
+            }
+        }
+
+        std::vector<std::optional<std::string>> expected;
+        for (const Device& device : devices) {
+            for (const auto& sysattr : sysattrs) {
+                EXPECT_EQ(reader.Add(device, sysattr), expected.size());
+                expected.push_back(device.GetSysattrValue(sysattr));
+            }
+        }
+        EXPECT_EQ(reader.GetPendingCount(), expected.size());
+
+        const auto results = reader.Read();
+        EXPECT_EQ(reader.GetPendingCount(), 0u);
+        ASSERT_EQ(results.size(), expected.size());
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            EXPECT_EQ(results[i], expected[i]) << *devices[i / sysattrs.size()].GetSyspath() << "/" << sysattrs[i % sysattrs.size()];
+        }
+    }
+}
+
+TEST(SysattrReaderTest, IoUringMatchesLibsystemd) {
+    // Small queue, so the reads span several chunks.
+    SysattrReader reader(SysattrReader::Backend::IoUring, 16);
+    if (reader.GetBackend() != SysattrReader::Backend::IoUring) {
+        GTEST_SKIP() << "io_uring is unavailable.";
+    }
+    ExpectSameAsLibsystemd(reader);
+}
+
+TEST(SysattrReaderTest, ThreadPoolMatchesLibsystemd) {
+    SysattrReader reader(SysattrReader::Backend::ThreadPool, 16, 2);
+    EXPECT_EQ(reader.GetBackend(), SysattrReader::Backend::ThreadPool);
+    ExpectSameAsLibsystemd(reader);
+}
+
+TEST(SysattrReaderTest, MissingDevicesHaveNoValue) {
+    SysattrReader reader;
+    reader.Add("/sys/devices/not-a-device", "uevent");
+    reader.Add(Device::CreateFromProperties(DeviceProperties(std::vector<DeviceProperties::Property>{ { "SUBSYSTEM", "test" } })), "uevent");
+    const auto results = reader.Read();
+    ASSERT_EQ(results.size(), 2u);
+    EXPECT_FALSE(results[0].has_value());
+    EXPECT_FALSE(results[1].has_value()) << "No syspath.";
+    EXPECT_TRUE(reader.Read().empty());
+    EXPECT_THROW(SysattrReader(SysattrReader::Backend::IoUring, 1), std::invalid_argument);
+}
@@ -29,4 +29,17 @@ std::string FakeDeviceManager::CreateFakeDevice(const std::string& type, const s
 
     return devicePath
 }
-*/
\ No newline at end of file
+*/
+
+#include <EventMonitor/test/Utilities.h>
+#include <filesystem>
+#include <unistd.h>
+
+Device MakeDevice(const std::string& devpath, std::vector<DeviceProperties::Property> properties) {
+    properties.emplace_back("DEVPATH", devpath);
+    return Device::CreateFromProperties(DeviceProperties(std::move(properties)));
+}
+
+std::string TemporaryPath(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / (name + "-" + std::to_string(getpid()))).string();
+}
@@ -20,4 +20,14 @@ private:
     std::string sysfsDirPath;
     std::vector<std::string> devices;
 };
-*/
\ No newline at end of file
+*/
+
+#include <EventMonitor/Device.h>
+#include <string>
+#include <vector>
+
+// Detached device with the given DEVPATH, as injected in place of a udev event.
+Device MakeDevice(const std::string& devpath, std::vector<DeviceProperties::Property> properties = {});
+
+// Path named after the test and the process in the temporary directory, the file is not created.
+std::string TemporaryPath(const std::string& name);
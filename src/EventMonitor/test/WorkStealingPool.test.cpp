@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+#include <EventMonitor/WorkStealingPool.h>
+#include <atomic>
+#include <thread>
+
+TEST(WorkStealingPoolTest, RunsEverySubmittedTask) {
+    WorkStealingPool pool(4);
+    EXPECT_EQ(pool.GetThreadCount(), 4u);
+    EXPECT_THROW(pool.Submit(nullptr), std::invalid_argument);
+
+    std::atomic<int> counter(0);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(pool.Submit([&counter]() { ++counter; }));
+    }
+    pool.Wait();
+    EXPECT_EQ(counter.load(), 1000);
+
+    uint64_t executed = 0;
+    for (const auto& worker : pool.GetStats()) {
+        executed += worker.executedCount;
+        EXPECT_EQ(worker.queueDepth, 0u);
+    }
+    EXPECT_EQ(executed, 1000u);
+}
+
+TEST(WorkStealingPoolTest, TasksCanSubmitTasks) {
+    WorkStealingPool pool(2);
+    std::atomic<int> counter(0);
+
+    for (int i = 0; i < 10; ++i) {
+        pool.Submit([&pool, &counter]() {
+            for (int j = 0; j < 10; ++j) {
+                pool.Submit([&counter]() { ++counter; });
+            }
+        });
+    }
+    pool.Wait();
+    EXPECT_EQ(counter.load(), 100);
+}
+
+TEST(WorkStealingPoolTest, StopRunsQueuedTasksThenRefusesNewOnes) {
+    std::atomic<int> counter(0);
+    WorkStealingPool pool(1);
+    for (int i = 0; i < 100; ++i) {
+        pool.Submit([&counter]() { ++counter; });
+    }
+    pool.Stop();
+    EXPECT_EQ(counter.load(), 100);
+    EXPECT_FALSE(pool.Submit([&counter]() { ++counter; }));
+}
+
+TEST(WorkStealingPoolTest, SubmitRacingStopNeverLosesTasks) {
+    for (int round = 0; round < 200; ++round) {
+        std::atomic<int> accepted(0);
+        std::atomic<int> executed(0);
+        WorkStealingPool pool(2);
+
+        std::thread submitter([&pool, &accepted, &executed]() {
+            while (pool.Submit([&executed]() { ++executed; })) {
+                ++accepted;
+            }
+        });
+        pool.Stop();
+        submitter.join();
+
+        // Every accepted task has run, so nothing is left for Wait().
+        EXPECT_EQ(executed.load(), accepted.load());
+        pool.Wait();
+    }
+}